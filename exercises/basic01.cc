@@ -9,46 +9,61 @@
 ///
 /// run it with    : ./01-basic < data/single-event.dat
 ///
+/// With --cache DIR, the clustering is kept in an on-disk cache
+/// (fcc::ClusteringCache) and rebuilt from it, without reclustering,
+/// when the same event is run again.
+///
+/// With --jets FILE, the jets are written to FILE as binary columns
+/// (fcc::BinaryJetWriter, compressed with --compress) instead of
+/// being printed; tools/jets2txt reads them back.
+///
 /// Source code: 01-basic.cc
 //----------------------------------------------------------------------
 
 #include "fastjet/ClusterSequence.hh"
+#include "fcc/EventReader.hh"
+#include "fcc/ExerciseAnalyses.hh"
 #include <iostream> // needed for io
-#include <cstdio>   // needed for io
 
 using namespace std;
 
 /// an example program showing how to use fastjet
-int main(){
+int main(int argc, char ** argv){
   
   // read in input particles
   //----------------------------------------------------------
-  vector<fastjet::PseudoJet> input_particles;
-  
-  double px, py , pz, E;
-  while (cin >> px >> py >> pz >> E) {
-    // create a fastjet::PseudoJet with these components and put it onto
-    // back of the input_particles vector
-    input_particles.push_back(fastjet::PseudoJet(px,py,pz,E)); 
-  }
+  //
+  // the first event on the standard input is parsed by
+  // fcc::EventReader and handed back as an fcc::Event, from which
+  // the PseudoJets are built in one go
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
   
 
-  // create a jet definition: 
-  // a jet algorithm with a given radius parameter
-  //----------------------------------------------------------
-  double R = 0.6;
-  fastjet::JetDefinition jet_def(fastjet::antikt_algorithm, R);
-
-
-  // run the jet clustering with the above jet definition
-  //----------------------------------------------------------
-  fastjet::ClusterSequence clust_seq(input_particles, jet_def);
-
-
-  // get the resulting jets ordered in pt
+  // the analysis itself lives in fcc::BasicAnalysis, so that exactly
+  // the same code is also run by the parallel driver
+  // (tools/parallel_analysis.cc). It
+  //  - creates a jet definition: the anti-kt algorithm with R=0.6
+  //  - runs the jet clustering with the above jet definition
+  //  - gets the resulting jets above 5 GeV, ordered in pt
   //----------------------------------------------------------
-  double ptmin = 5.0;
-  vector<fastjet::PseudoJet> inclusive_jets = sorted_by_pt(clust_seq.inclusive_jets(ptmin));
+  string cache_directory, jets_file;
+  bool compress = false;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    if      ((arg == "--cache") && (iarg+1 < argc)) cache_directory = argv[++iarg];
+    else if ((arg == "--jets")  && (iarg+1 < argc)) jets_file = argv[++iarg];
+    else if (arg == "--compress") compress = true;
+    else {
+      cerr << "usage: " << argv[0] << " [--cache DIR] [--jets FILE [--compress]] < events.dat" << endl;
+      return 1;
+    }
+  }
+  fcc::BasicAnalysis analysis;
+  if (!cache_directory.empty())
+    analysis.set_cache(make_shared<fcc::ClusteringCache>(cache_directory));
+  analysis.process(event, 0);
 
 
   // tell the user what was done
@@ -57,16 +72,14 @@ int main(){
   //    show the output as 
   //      {index, rap, phi, pt}
   //----------------------------------------------------------
-  cout << "Ran " << jet_def.description() << endl;
-
-  // label the columns
-  printf("%5s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt");
- 
-  // print out the details for each jet
-  for (unsigned int i = 0; i < inclusive_jets.size(); i++) {
-    printf("%5u %15.8f %15.8f %15.8f\n",
-           i, inclusive_jets[i].rap(), inclusive_jets[i].phi(),
-           inclusive_jets[i].perp());
+  cout << "Ran " << analysis.jet_def().description() << endl;
+  if (!jets_file.empty()) {
+    fcc::BinaryJetWriter writer(jets_file, false, false, compress);
+    analysis.write_jets(writer, 0);
+    writer.close();
+    cout << "Wrote " << writer.n_jets() << " jets to " << jets_file << endl;
+  } else {
+    analysis.print(cout);
   }
 
   return 0;
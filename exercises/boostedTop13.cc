@@ -42,7 +42,6 @@
 //ENDHEADER
 
 #include <iostream> // needed for io
-#include <sstream>  // needed for internal io
 #include <iomanip>  
 #include <cmath>
 
@@ -50,6 +49,8 @@
 #include <fastjet/Selector.hh>
 #include <fastjet/tools/JHTopTagger.hh>
 
+#include "fcc/EventReader.hh"
+
 using namespace std;
 using namespace fastjet;
 
@@ -64,21 +65,13 @@ ostream & operator<<(ostream &, const PseudoJet &);
 //----------------------------------------------------------------------
 int main(){
 
-  vector<PseudoJet> particles;
-
   // read in data in format px py pz E b-tag [last of these is optional]
   // lines starting with "#" are considered as comments and discarded
   //----------------------------------------------------------
-  string line;
-  while (getline(cin,line)) {
-    if (line.substr(0,1) == "#") {continue;}
-    istringstream linestream(line);
-    double px,py,pz,E;
-    linestream >> px >> py >> pz >> E;
-
-    // construct the particle
-    particles.push_back(PseudoJet(px,py,pz,E));
-  }
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  vector<PseudoJet> particles = event.pseudojets();
 
   std::cout<<"Total number of particles read in: " << particles.size() << std::endl;
 
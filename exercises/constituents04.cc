@@ -44,6 +44,8 @@
 //ENDHEADER
 
 #include "fastjet/ClusterSequence.hh"
+#include "fcc/ConstituentView.hh"
+#include "fcc/EventReader.hh"
 #include <iostream> // needed for io
 #include <cstdio>   // needed for io
 
@@ -54,22 +56,14 @@ int main(){
   
   // read in input particles
   //----------------------------------------------------------
-  vector<fastjet::PseudoJet> input_particles;
-  
-  valarray<double> fourvec(4);
-  int index=0;
-  while (cin >> fourvec[0] >> fourvec[1] >> fourvec[2] >> fourvec[3]) {
-    // create a particle with the approprite 4-momentum and 
-    // set its user index to keep track of its index.
-    // you can construct a PseudoJet from any object that allows subscripts
-    // from [0] .. [3] (the last one must be the energy)
-    fastjet::PseudoJet particle(fourvec);
-
-    particle.set_user_index(index);
-    input_particles.push_back(particle); 
-
-    index++;
-  }
+  //
+  // the PseudoJets built by fcc::Event come with their user index
+  // set to their position in the event, which is what we use below
+  // to keep track of the constituents
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  vector<fastjet::PseudoJet> input_particles = event.pseudojets();
   
 
   // create a jet definition: 
@@ -102,18 +96,23 @@ int main(){
   printf("%5s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "n constituents");
   printf("        indices of constituents\n\n");
  
+  // the constituents of all the jets, as one flat list of indices
+  // (positions in input_particles, i.e. here also their user index),
+  // read from the clustering history without building any vector of
+  // PseudoJets
+  fcc::ConstituentIndices constituents;
+  constituents.fill(clust_seq, inclusive_jets);
+
   // print out the details for each jet
   for (unsigned int i = 0; i < inclusive_jets.size(); i++) {
-    // get the constituents of the jet
-    vector<fastjet::PseudoJet> constituents = inclusive_jets[i].constituents();
-
     printf("%5u %15.8f %15.8f %15.8f %8u\n",
            i, inclusive_jets[i].rap(), inclusive_jets[i].phi(),
-           inclusive_jets[i].perp(), (unsigned int) constituents.size());
+           inclusive_jets[i].perp(), constituents.size(i));
 
     printf("       ");
-    for (unsigned int j=0; j<constituents.size(); j++){
-      printf("%4u ", constituents[j].user_index());
+    unsigned int j = 0;
+    for (const unsigned int * index = constituents.begin(i); index != constituents.end(i); ++index, ++j){
+      printf("%4u ", *index);
       if (j%10==9) printf("\n       ");
     }
     printf("\n\n");
@@ -18,6 +18,10 @@
 ///
 /// run it with    : ./05-eplus_eminus < data/single-ee-event.dat
 ///
+/// With --scan, the event is also clustered with fcc::EEKtEngine,
+/// which keeps the exclusive jets of every multiplicity up to 6, and
+/// the y_{n,n+1} values and exclusive jets for n = 2..6 are printed.
+///
 /// Source code: 05-eplus_eminus.cc
 //----------------------------------------------------------------------
 
@@ -50,24 +54,27 @@
 //ENDHEADER
 
 #include "fastjet/ClusterSequence.hh"
+#include "fcc/EEKtEngine.hh"
+#include "fcc/EventReader.hh"
 #include <iostream> // needed for io
 #include <cstdio>   // needed for io
 
 using namespace std;
 
 /// an example program showing how to use fastjet
-int main(){
+int main(int argc, char ** argv){
+  bool scan = (argc > 1) && (string(argv[1]) == "--scan");
   
   // read in input particles
   //----------------------------------------------------------
-  vector<fastjet::PseudoJet> input_particles;
-  
-  double px, py , pz, E;
-  while (cin >> px >> py >> pz >> E) {
-    // create a fastjet::PseudoJet with these components and put it onto
-    // back of the input_particles vector
-    input_particles.push_back(fastjet::PseudoJet(px,py,pz,E)); 
-  }
+  //
+  // the first event on the standard input is parsed by
+  // fcc::EventReader and handed back as an fcc::Event, from which
+  // the PseudoJets are built in one go
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  vector<fastjet::PseudoJet> input_particles = event.pseudojets();
   
 
   // create a jet definition for the kt algorithm (note that one
@@ -102,5 +109,24 @@ int main(){
            i, exclusive_jets[i].perp());
   }
 
+  // all the multiplicities at once
+  //----------------------------------------------------------
+  if (scan) {
+    fcc::EEKtEngine engine(6);
+    engine.cluster(input_particles);
+    cout << endl << "Ran " << engine.description() << endl;
+    printf("%5s %15s %8s\n", "n", "y_{n,n+1}", "n(ycut)");
+    for (int nj = 2; nj <= 6; nj++) {
+      double ymerge = engine.exclusive_ymerge(nj);
+      printf("%5d %15.8e %8d\n", nj, ymerge, engine.n_exclusive_jets_ycut(ymerge));
+    }
+    for (int nj = 2; nj <= 6; nj++) {
+      const vector<fastjet::PseudoJet> & jets = engine.exclusive_jets(nj);
+      printf("%d jets:", nj);
+      for (unsigned int i = 0; i < jets.size(); i++) printf(" %10.4f", jets[i].E());
+      printf("\n");
+    }
+  }
+
   return 0;
 }
\ No newline at end of file
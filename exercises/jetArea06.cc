@@ -1,136 +1,148 @@
-001 //----------------------------------------------------------------------
-00002 /// \file
-00003 /// \page Example06 06 - using jet areas
-00004 ///
-00005 /// fastjet example program for jet areas
-00006 /// It mostly illustrates the usage of the 
-00007 /// fastjet::AreaDefinition and fastjet::ClusterSequenceArea classes
-00008 ///
-00009 /// run it with    : ./06-area < data/single-event.dat
-00010 ///
-00011 /// Source code: 06-area.cc
-00012 //----------------------------------------------------------------------
-00013 
-00014 //STARTHEADER
-00015 // $Id: 06-area.cc 2684 2011-11-14 07:41:44Z soyez $
-00016 //
-00017 // Copyright (c) 2005-2011, Matteo Cacciari, Gavin P. Salam and Gregory Soyez
-00018 //
-00019 //----------------------------------------------------------------------
-00020 // This file is part of FastJet.
-00021 //
-00022 //  FastJet is free software; you can redistribute it and/or modify
-00023 //  it under the terms of the GNU General Public License as published by
-00024 //  the Free Software Foundation; either version 2 of the License, or
-00025 //  (at your option) any later version.
-00026 //
-00027 //  The algorithms that underlie FastJet have required considerable
-00028 //  development and are described in hep-ph/0512210. If you use
-00029 //  FastJet as part of work towards a scientific publication, please
-00030 //  include a citation to the FastJet paper.
-00031 //
-00032 //  FastJet is distributed in the hope that it will be useful,
-00033 //  but WITHOUT ANY WARRANTY; without even the implied warranty of
-00034 //  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-00035 //  GNU General Public License for more details.
-00036 //
-00037 //  You should have received a copy of the GNU General Public License
-00038 //  along with FastJet. If not, see <http://www.gnu.org/licenses/>.
-00039 //----------------------------------------------------------------------
-00040 //ENDHEADER
-00041 
-00042 #include "fastjet/ClusterSequenceArea.hh"  // use this instead of the "usual" ClusterSequence to get area support
-00043 #include <iostream> // needed for io
-00044 #include <cstdio>   // needed for io
-00045 
-00046 using namespace std;
-00047 
-00048 /// an example program showing how to use fastjet
-00049 int main(){
-00050   
-00051   // read in input particles
-00052   //----------------------------------------------------------
-00053   vector<fastjet::PseudoJet> input_particles;
-00054   
-00055   double px, py , pz, E;
-00056   while (cin >> px >> py >> pz >> E) {
-00057     // create a fastjet::PseudoJet with these components and put it onto
-00058     // back of the input_particles vector
-00059     input_particles.push_back(fastjet::PseudoJet(px,py,pz,E)); 
-00060   }
-00061   
-00062 
-00063   // create a jet definition: 
-00064   // a jet algorithm with a given radius parameter
-00065   //----------------------------------------------------------
-00066   double R = 0.6;
-00067   fastjet::JetDefinition jet_def(fastjet::kt_algorithm, R);
-00068 
-00069 
-00070   // Now we also need an AreaDefinition to define the properties of the 
-00071   // area we want
-00072   //
-00073   // This is made of 2 building blocks:
-00074   //  - the area type:
-00075   //    passive, active, active with explicit ghosts, or Voronoi area
-00076   //  - the specifications:
-00077   //    a VoronoiSpec or a GhostedAreaSpec for the 3 ghost-bases ones
-00078   // 
-00079   //---------------------------------------------------------- For
-00080   // GhostedAreaSpec (as below), the minimal info you have to provide
-00081   // is up to what rapidity ghosts are placed. 
-00082   // Other commonm parameters (that mostly have an impact on the
-00083   // precision on the area) include the number of repetitions
-00084   // (i.e. the number of different sets of ghosts that are used) and
-00085   // the ghost density (controlled through the ghost_area).
-00086   // Other, more exotic, parameters (not shown here) control how ghosts
-00087   // are placed.
-00088   //
-00089   // The ghost rapidity interval should be large enough to cover the
-00090   // jets for which you want to calculate. E.g. if you want to
-00091   // calculate the area of jets up to |y|=4, you need to put ghosts up
-00092   // to at least 4+R (or, optionally, up to the largest particle
-00093   // rapidity if this is smaller).
-00094   double maxrap = 5.0;
-00095   unsigned int n_repeat = 3; // default is 1
-00096   double ghost_area = 0.01; // this is the default
-00097   fastjet::GhostedAreaSpec area_spec(maxrap, n_repeat, ghost_area);
-00098 
-00099   fastjet::AreaDefinition area_def(fastjet::active_area, area_spec);
-00100 
-00101   // run the jet clustering with the above jet and area definitions
-00102   //
-00103   // The only change is the usage of a ClusterSequenceArea rather than
-00104   //a ClusterSequence
-00105   //----------------------------------------------------------
-00106   fastjet::ClusterSequenceArea clust_seq(input_particles, jet_def, area_def);
-00107 
-00108 
-00109   // get the resulting jets ordered in pt
-00110   //----------------------------------------------------------
-00111   double ptmin = 5.0;
-00112   vector<fastjet::PseudoJet> inclusive_jets = sorted_by_pt(clust_seq.inclusive_jets(ptmin));
-00113 
-00114 
-00115   // tell the user what was done
-00116   //  - the description of the algorithm and area used
-00117   //  - extract the inclusive jets with pt > 5 GeV
-00118   //    show the output as 
-00119   //      {index, rap, phi, pt, number of constituents}
-00120   //----------------------------------------------------------
-00121   cout << endl;
-00122   cout << "Ran " << jet_def.description() << endl;
-00123   cout << "Area: " << area_def.description() << endl << endl;
-00124 
-00125   // label the columns
-00126   printf("%5s %15s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "area", "area error");
-00127  
-00128   // print out the details for each jet
-00129   for (unsigned int i = 0; i < inclusive_jets.size(); i++) {
-00130     printf("%5u %15.8f %15.8f %15.8f %15.8f %15.8f\n", i,
-00131            inclusive_jets[i].rap(), inclusive_jets[i].phi(), inclusive_jets[i].perp(),
-00132            inclusive_jets[i].area(), inclusive_jets[i].area_error());
-00133   }
-00134 
-00135   return 0;
-00136 }
\ No newline at end of file
+//----------------------------------------------------------------------
+/// \file
+/// \page Example06 06 - using jet areas
+///
+/// fastjet example program for jet areas
+/// It mostly illustrates the usage of the 
+/// fastjet::AreaDefinition and fastjet::ClusterSequenceArea classes
+///
+/// run it with    : ./06-area < data/single-event.dat
+///
+/// With --cached-ghosts, the ghost lattice is built once and the 3
+/// repetitions are clustered concurrently (fcc::CachedGhostClustering).
+/// With --soft-killer, the particles first go through a SoftKiller
+/// pre-filter (fcc::SoftKiller, 0.4 x 0.4 cells up to |y|=5).
+/// With --jets FILE, the jets and their areas are written to FILE as
+/// binary columns (fcc::BinaryJetWriter, compressed with --compress)
+/// instead of being printed.
+///
+/// Source code: 06-area.cc
+//----------------------------------------------------------------------
+
+//STARTHEADER
+// $Id: 06-area.cc 2684 2011-11-14 07:41:44Z soyez $
+//
+// Copyright (c) 2005-2011, Matteo Cacciari, Gavin P. Salam and Gregory Soyez
+//
+//----------------------------------------------------------------------
+// This file is part of FastJet.
+//
+//  FastJet is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  The algorithms that underlie FastJet have required considerable
+//  development and are described in hep-ph/0512210. If you use
+//  FastJet as part of work towards a scientific publication, please
+//  include a citation to the FastJet paper.
+//
+//  FastJet is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with FastJet. If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------
+//ENDHEADER
+
+#include "fastjet/ClusterSequenceArea.hh"  // use this instead of the "usual" ClusterSequence to get area support
+#include "fcc/EventReader.hh"
+#include "fcc/ExerciseAnalyses.hh"
+#include <iostream> // needed for io
+
+using namespace std;
+
+/// an example program showing how to use fastjet
+int main(int argc, char ** argv){
+  
+  // read in input particles
+  //----------------------------------------------------------
+  //
+  // the first event on the standard input is parsed by
+  // fcc::EventReader and handed back as an fcc::Event, from which
+  // the PseudoJets are built in one go
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  
+
+  // create a jet definition: 
+  // a jet algorithm with a given radius parameter
+  //----------------------------------------------------------
+  // (here the kt algorithm with R=0.6)
+  //
+  // Now we also need an AreaDefinition to define the properties of the 
+  // area we want
+  //
+  // This is made of 2 building blocks:
+  //  - the area type:
+  //    passive, active, active with explicit ghosts, or Voronoi area
+  //  - the specifications:
+  //    a VoronoiSpec or a GhostedAreaSpec for the 3 ghost-bases ones
+  // 
+  //---------------------------------------------------------- For
+  // GhostedAreaSpec (as below), the minimal info you have to provide
+  // is up to what rapidity ghosts are placed. 
+  // Other commonm parameters (that mostly have an impact on the
+  // precision on the area) include the number of repetitions
+  // (i.e. the number of different sets of ghosts that are used) and
+  // the ghost density (controlled through the ghost_area).
+  // Other, more exotic, parameters (not shown here) control how ghosts
+  // are placed.
+  //
+  // The ghost rapidity interval should be large enough to cover the
+  // jets for which you want to calculate. E.g. if you want to
+  // calculate the area of jets up to |y|=4, you need to put ghosts up
+  // to at least 4+R (or, optionally, up to the largest particle
+  // rapidity if this is smaller).
+  // Here ghosts go up to |y|=5, with 3 repetitions (default is 1)
+  // and the default ghost area of 0.01.
+  //
+  // The jet and area definitions, the clustering (using a
+  // ClusterSequenceArea rather than a ClusterSequence) and the
+  // extraction of the jets above 5 GeV live in fcc::AreaAnalysis, so
+  // that the same code is also run by the parallel driver
+  // (tools/parallel_analysis.cc)
+  //----------------------------------------------------------
+  bool cached_ghosts = false, soft_killer = false, compress = false;
+  string jets_file;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string option = argv[iarg];
+    if      (option == "--cached-ghosts") cached_ghosts = true;
+    else if (option == "--soft-killer")   soft_killer = true;
+    else if (option == "--compress")      compress = true;
+    else if ((option == "--jets") && (iarg+1 < argc)) jets_file = argv[++iarg];
+    else {
+      cerr << "usage: " << argv[0] << " [--cached-ghosts] [--soft-killer] [--jets FILE [--compress]] < events.dat" << endl;
+      return 1;
+    }
+  }
+  fcc::AreaAnalysis analysis(cached_ghosts);
+  if (soft_killer) analysis.set_soft_killer(fcc::SoftKiller());
+  analysis.process(event, 0);
+
+
+  // tell the user what was done
+  //  - the description of the algorithm and area used
+  //  - extract the inclusive jets with pt > 5 GeV
+  //    show the output as 
+  //      {index, rap, phi, pt, area, area error}
+  //----------------------------------------------------------
+  cout << endl;
+  cout << "Ran " << analysis.jet_def().description() << endl;
+  cout << "Area: " << analysis.area_def().description() << endl;
+  if (analysis.soft_killer()) cout << "Pre-filter: " << analysis.soft_killer()->description() << endl;
+  cout << endl;
+  if (!jets_file.empty()) {
+    fcc::BinaryJetWriter writer(jets_file, true, false, compress);
+    analysis.write_jets(writer, 0);
+    writer.close();
+    cout << "Wrote " << writer.n_jets() << " jets to " << jets_file << endl;
+  } else {
+    analysis.print(cout);
+  }
+
+  return 0;
+}
\ No newline at end of file
@@ -41,24 +41,29 @@
 
 
 #include "fastjet/ClusterSequence.hh"
+#include "fcc/BinaryJetFile.hh"
+#include "fcc/ClusteringCache.hh"
+#include "fcc/EventReader.hh"
+#include "fcc/StrategyCalibration.hh"
 #include <iostream> // needed for io
 #include <cstdio>   // needed for io
+#include <memory>
 
 using namespace std;
 
 /// an example program showing how to use fastjet
-int main(){
+int main(int argc, char ** argv){
   
   // read in input particles
   //----------------------------------------------------------
-  vector<fastjet::PseudoJet> input_particles;
-  
-  double px, py , pz, E;
-  while (cin >> px >> py >> pz >> E) {
-    // create a fastjet::PseudoJet with these components and put it onto
-    // back of the input_particles vector
-    input_particles.push_back(fastjet::PseudoJet(px,py,pz,E)); 
-  }
+  //
+  // the first event on the standard input is parsed by
+  // fcc::EventReader and handed back as an fcc::Event, from which
+  // the PseudoJets are built in one go
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  vector<fastjet::PseudoJet> input_particles = event.pseudojets();
   
 
   // create a jet definition: 
@@ -105,13 +110,56 @@ int main(){
   // Cambridge/Aachen need CGAL support.
   fastjet::Strategy strategy = fastjet::Best;
 
+  // Alternatively, the strategy can be picked for this event's
+  // multiplicity from a calibration table measured on the machine at
+  // hand (see tools/strategy_benchmark.cc), given as an argument:
+  //   ./02-jetdef strategy-calibration.txt < data/single-event.dat
+  //
+  // With --cache DIR, the clustering is kept in an on-disk cache and
+  // rebuilt from it when the same event is run again:
+  //   ./02-jetdef --cache jet-cache < data/single-event.dat
+  //
+  // With --jets FILE, the jets are written to FILE as binary columns
+  // (compressed with --compress) instead of being printed:
+  //   ./02-jetdef --jets jets.bin < data/single-event.dat
+  string calibration_file, cache_directory, jets_file;
+  bool compress = false;
+  for (int iarg = 1; iarg < argc; iarg++) {
+    string arg = argv[iarg];
+    if      ((arg == "--cache") && (iarg+1 < argc)) cache_directory = argv[++iarg];
+    else if ((arg == "--jets")  && (iarg+1 < argc)) jets_file = argv[++iarg];
+    else if (arg == "--compress") compress = true;
+    else if ((arg.compare(0, 2, "--") != 0) && calibration_file.empty()) calibration_file = arg;
+    else {
+      cerr << "usage: " << argv[0]
+           << " [calibration_file] [--cache DIR] [--jets FILE [--compress]] < events.dat" << endl;
+      return 1;
+    }
+  }
+  if (!calibration_file.empty()) {
+    fcc::StrategyCalibration calibration(calibration_file);
+    strategy = calibration.strategy(jet_alg, input_particles.size());
+    cout << "Calibrated strategy for " << input_particles.size() << " particles: "
+         << fcc::strategy_name(strategy) << endl;
+  }
+
   // create the JetDefinition from the above information
   fastjet::JetDefinition jet_def(jet_alg, R, recomb_scheme, strategy);
 
 
-  // run the jet clustering with the above jet definition
+  // run the jet clustering with the above jet definition (through
+  // the cache if one was given)
   //----------------------------------------------------------
-  fastjet::ClusterSequence clust_seq(input_particles, jet_def);
+  unique_ptr<fastjet::ClusterSequence> cached_clust_seq;
+  if (!cache_directory.empty()) {
+    fcc::ClusteringCache cache(cache_directory);
+    cached_clust_seq = cache.cluster(input_particles, jet_def);
+    cout << "Clustering " << (cache.n_hits() ? "read from" : "stored in") << " the "
+         << cache.description() << endl;
+  } else {
+    cached_clust_seq.reset(new fastjet::ClusterSequence(input_particles, jet_def));
+  }
+  const fastjet::ClusterSequence & clust_seq = *cached_clust_seq;
 
 
   // get the resulting jets ordered in pt
@@ -128,6 +176,15 @@ int main(){
   //----------------------------------------------------------
   cout << "Ran " << jet_def.description() << endl;
 
+  // or write them, column-wise, to a binary file
+  if (!jets_file.empty()) {
+    fcc::BinaryJetWriter writer(jets_file, false, false, compress);
+    for (unsigned int i = 0; i < inclusive_jets.size(); i++) writer.write(0, i, inclusive_jets[i]);
+    writer.close();
+    cout << "Wrote " << writer.n_jets() << " jets to " << jets_file << endl;
+    return 0;
+  }
+
   // label the columns
   printf("%5s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt");
  
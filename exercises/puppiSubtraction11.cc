@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------
+/// \file
+/// \page Example11 11 - PUPPI followed by constituent subtraction
+///
+/// The events are read once and go through a single stage
+/// (fcc::PuppiCSStage): PUPPI weighting, one grid-median estimate of
+/// rho, event-wide constituent subtraction of the weighted particles
+/// and anti-kt clustering of the result. The hard event (sub-event 0)
+/// is clustered as well for comparison.
+///
+/// The time of every step is shown for each event, and the summary
+/// compares the per-event time with a latency budget (in ms, 100 by
+/// default), e.g. on mu=200 events made with tools/pileup_mixer.
+///
+/// run it with    : ./puppiSubtraction11 [budget_ms] < data/Pythia-Zp2jets-lhc-pileup-1ev.dat
+///            or  : ./puppiSubtraction11 50 < mu200.dat
+///
+/// With --jets FILE, the corrected jets of every event are written to
+/// FILE as binary columns (fcc::BinaryJetWriter, compressed with
+/// --compress) instead of the per-event printout.
+///
+/// With --grid-cs, the subtraction is done by fcc::ConstituentSubtraction
+/// (same output, with the ghost pairs found on its grid) instead of
+/// fjcontrib's ConstituentSubtractor.
+///
+/// The code needs to be linked against the ConstituentSubtractor
+/// library from fjcontrib (-lConstituentSubtractor).
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/PuppiCSStage.hh"
+#include "fcc/Timer.hh"
+#include <cstdio>   // needed for io
+#include <cstdlib>
+#include <iostream> // needed for io
+#include <memory>
+
+using namespace std;
+
+int main(int argc, char ** argv){
+  double budget = 0.1;
+  bool compress = false, grid_cs = false;
+  string jets_file;
+  for (int iarg = 1; iarg < argc; iarg++) {
+    string arg = argv[iarg];
+    char * end;
+    double budget_ms = strtod(arg.c_str(), &end);
+    if      ((arg == "--jets") && (iarg+1 < argc)) jets_file = argv[++iarg];
+    else if (arg == "--compress") compress = true;
+    else if (arg == "--grid-cs")  grid_cs  = true;
+    else if ((!arg.empty()) && (*end == '\0') && (budget_ms > 0)) budget = budget_ms/1000;
+    else {
+      cerr << "usage: " << argv[0] << " [budget_ms] [--grid-cs] [--jets FILE [--compress]] < events.dat" << endl;
+      return 1;
+    }
+  }
+
+  // the PUPPI, background-estimation, subtraction and clustering
+  // setup is created once and reused for every event
+  //----------------------------------------------------------
+  fcc::PuppiCSStage stage(grid_cs);
+  cout << "Ran: " << stage.description() << endl;
+  cout << "Latency budget: " << 1000*budget << " ms per event" << endl << endl;
+
+  fcc::EventReader reader;
+  fcc::Event event;
+  fcc::Throughput throughput;
+  fcc::PuppiCSStage::Timings sum, max_time;
+  unsigned int n_over_budget = 0;
+  unique_ptr<fcc::BinaryJetWriter> jets_writer;
+  if (!jets_file.empty()) jets_writer.reset(new fcc::BinaryJetWriter(jets_file, false, false, compress));
+
+  fcc::Timer timer;
+  while (reader.next_event(event)) {
+    unsigned int iev = reader.n_events_read()-1;
+    if (event.empty()) {
+      cerr << "Error: read empty event (event " << iev << ")\n";
+      timer.start();
+      continue;
+    }
+
+    double read_time = timer.elapsed();
+    stage.process(event, iev);
+    double event_time = timer.elapsed();
+    throughput.add(event.size(), event_time);
+
+    const fcc::PuppiCSStage::Timings & t = stage.timings();
+    sum.puppi += t.puppi;  sum.rho += t.rho;  sum.subtraction += t.subtraction;  sum.clustering += t.clustering;
+    max_time.puppi       = max(max_time.puppi, t.puppi);
+    max_time.rho         = max(max_time.rho, t.rho);
+    max_time.subtraction = max(max_time.subtraction, t.subtraction);
+    max_time.clustering  = max(max_time.clustering, t.clustering);
+    if (t.total() > budget) n_over_budget++;
+
+    if (jets_writer) {
+      stage.write_jets(*jets_writer, iev);
+    } else {
+      cout << "Event " << iev << ": " << event.size() << " particles, "
+           << event.n_subevents() << " sub-events, read in " << read_time*1000
+           << " ms, processed in " << (event_time-read_time)*1000 << " ms"
+           << (t.total() > budget ? " (over budget)" : "") << endl;
+      stage.print(cout);
+      cout << endl;
+    }
+
+    timer.start();
+  }
+
+  if (throughput.n_events() == 0) {
+    cerr << "Error: read empty event\n";
+    exit(-1);
+  }
+
+  // per-step summary against the budget
+  //----------------------------------------------------------
+  unsigned long n = throughput.n_events();
+  cout << "Processed " << n << " events (" << throughput.n_particles() << " particles) in "
+       << throughput.time() << " s, " << throughput.events_per_second() << " events/s" << endl;
+  printf("%12s %12s %12s\n", "step", "mean [ms]", "max [ms]");
+  printf("%12s %12.3f %12.3f\n", "puppi",       1000*sum.puppi/n,       1000*max_time.puppi);
+  printf("%12s %12.3f %12.3f\n", "rho",         1000*sum.rho/n,         1000*max_time.rho);
+  printf("%12s %12.3f %12.3f\n", "subtraction", 1000*sum.subtraction/n, 1000*max_time.subtraction);
+  printf("%12s %12.3f %12.3f\n", "clustering",  1000*sum.clustering/n,  1000*max_time.clustering);
+  printf("%12s %12.3f\n", "total", 1000*sum.total()/n);
+  cout << n_over_budget << " of " << n << " events over the " << 1000*budget << " ms budget" << endl;
+  if (jets_writer) {
+    jets_writer->close();
+    cout << "Wrote " << jets_writer->n_jets() << " jets (" << jets_writer->n_bytes()
+         << " bytes) to " << jets_file << endl;
+  }
+
+  return 0;
+}
@@ -8,6 +8,8 @@
 /// identifying boosted higgs (and other objects)
 ///
 /// run it with    : ./10-subjets < data/single-event.dat
+///            or  : ./10-subjets 0.2 0.3 0.5 < data/single-event.dat
+///                  (subjets for each of the Rsub values given)
 ///
 /// Source code: 10-subjets.cc
 //----------------------------------------------------------------------
@@ -41,24 +43,29 @@
 //ENDHEADER
 
 #include "fastjet/ClusterSequence.hh"
+#include "fcc/ConstituentView.hh"
+#include "fcc/EventReader.hh"
+#include "fcc/SubjetScan.hh"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream> // needed for io
 #include <cstdio>   // needed for io
 
 using namespace std;
 using namespace fastjet;
 
-int main(){
+int main(int argc, char ** argv){
   
   // read in input particles
   //----------------------------------------------------------
-  vector<PseudoJet> input_particles;
-  
-  double px, py , pz, E;
-  while (cin >> px >> py >> pz >> E) {
-    // create a PseudoJet with these components and put it onto
-    // back of the input_particles vector
-    input_particles.push_back(PseudoJet(px,py,pz,E)); 
-  }
+  //
+  // the first event on the standard input is parsed by
+  // fcc::EventReader and handed back as an fcc::Event, from which
+  // the PseudoJets are built in one go
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  vector<PseudoJet> input_particles = event.pseudojets();
   
 
   // create a jet definition: 
@@ -75,42 +82,63 @@ int main(){
   double ptmin = 6.0;
   vector<PseudoJet> inclusive_jets = sorted_by_pt(clust_seq.inclusive_jets(ptmin));
 
-  // extract the subjets at a smaller angular scale (Rsub=0.5)
+  // extract the subjets at smaller angular scales (Rsub=0.5 by
+  // default, or the values given on the command line)
   //
-  // This is done by using ClusterSequence::exclusive_subjets(dcut):
-  // for the Cambridge/Aachen algorithm, running with R and then
-  // asking for exclusive subjets with dcut should give the same
-  // subjets as rerunning the algorithm with R'=R*sqrt(dcut) on the
-  // jet's constituents.
+  // For a single jet and scale, this is done by
+  // ClusterSequence::exclusive_subjets(dcut): for the Cambridge/Aachen
+  // algorithm, running with R and then asking for exclusive subjets
+  // with dcut should give the same subjets as rerunning the algorithm
+  // with R'=R*sqrt(dcut) on the jet's constituents.
+  //
+  // fcc::SubjetScan gives the same subjets for all the jets and all
+  // the scales at once, from a single pass over the clustering
+  // history, instead of walking it again for each jet and each scale.
   //
   // At the same time we output a summary of what has been done and the 
   // resulting subjets
   //----------------------------------------------------------
-  double Rsub = 0.5;
-  double dcut = pow(Rsub/R,2);
+  vector<double> Rsubs;
+  for (int iarg = 1; iarg < argc; iarg++){
+    char * end;
+    double Rsub = strtod(argv[iarg], &end);
+    if ((end == argv[iarg]) || (*end != '\0') || !(Rsub > 0)){
+      cerr << "usage: " << argv[0] << " [Rsub1 Rsub2 ...] < events.dat" << endl;
+      return 1;
+    }
+    Rsubs.push_back(Rsub);
+  }
+  if (Rsubs.empty()) Rsubs.push_back(0.5);
+  sort(Rsubs.begin(), Rsubs.end());
+  fcc::SubjetScan scan(fcc::SubjetScan::cambridge_dcuts(R, Rsubs));
+  scan.process(clust_seq, inclusive_jets);
 
   // a "header" for the output
   cout << "Ran " << jet_def.description() << endl;
   cout << "Showing the jets above " << ptmin << " GeV" << endl;
-  cout << "And their subjets for Rsub = " << Rsub << endl;
-  printf("%10s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "n constituents");
 
-  // show the jets and their subjets
-  for (unsigned int i = 0; i < inclusive_jets.size(); i++) {
-    // get the subjets
-    vector<PseudoJet> subjets = sorted_by_pt(inclusive_jets[i].exclusive_subjets(dcut));
+  for (unsigned int k = 0; k < Rsubs.size(); k++){
+    if (k > 0) cout << endl;
+    cout << "And their subjets for Rsub = " << Rsubs[k] << endl;
+    printf("%10s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "n constituents");
+
+    // show the jets and their subjets
+    for (unsigned int i = 0; i < inclusive_jets.size(); i++) {
+      // get the subjets
+      vector<PseudoJet> subjets = sorted_by_pt(scan.subjets(i, k));
 
-    cout << endl;
-    // print the jet and its subjets
-    printf("%5u      %15.8f %15.8f %15.8f %8d\n", i, 
-           inclusive_jets[i].rap(), inclusive_jets[i].phi(),
-           inclusive_jets[i].perp(), int(inclusive_jets[i].constituents().size()));
+      cout << endl;
+      // print the jet and its subjets
+      printf("%5u      %15.8f %15.8f %15.8f %8d\n", i, 
+             inclusive_jets[i].rap(), inclusive_jets[i].phi(),
+             inclusive_jets[i].perp(), int(fcc::ConstituentView(inclusive_jets[i]).size()));
 
-    for (unsigned int j=0; j<subjets.size(); j++)
-      printf("   sub%4u %15.8f %15.8f %15.8f %8u\n", j, 
-             subjets[j].rap(), subjets[j].phi(),
-             subjets[j].perp(), 
-             (unsigned int) subjets[j].constituents().size());
+      for (unsigned int j=0; j<subjets.size(); j++)
+        printf("   sub%4u %15.8f %15.8f %15.8f %8u\n", j, 
+               subjets[j].rap(), subjets[j].phi(),
+               subjets[j].perp(), 
+               fcc::ConstituentView(subjets[j]).size());
+    }
   }
 
   return 0;
@@ -4,7 +4,35 @@
 ///
 /// fastjet subtraction example program. 
 ///
+/// The events are processed one at a time: the jet, area and
+/// background definitions (and the subtractor) are set up once and
+/// reused for every event, and only the current event is kept in
+/// memory, so that files with many "#END"-delimited events can be
+/// streamed through. The time spent on each event and the overall
+/// throughput are reported.
+///
 /// run it with    : ./07-subtraction < data/Pythia-Zp2jets-lhc-pileup-1ev.dat
+///            or  : ./07-subtraction < data/Pythia-PtMin1000-LHC-10ev.dat
+///
+/// With --cached-ghosts, the ghosts of all the clusterings come from
+/// one lattice built at the start (fcc::GhostLattice) instead of
+/// being regenerated for every event and clustering. With
+/// --shared-clustering, fcc::SubtractionStage is used instead: one
+/// ghost set per event, shared by the signal and background
+/// clusterings, which run concurrently (it cannot be combined with
+/// --cached-ghosts or --grid-rho). With --grid-rho, rho is the
+/// median pt density of the cells of a rapidity-phi grid
+/// (fcc::GridRhoEstimator) rather than of kt jets, and no background
+/// clustering is needed. --soft-killer (which can be combined with
+/// the other options) removes the soft particles of the full event
+/// with a SoftKiller pre-filter (fcc::SoftKiller) before the
+/// clustering and the background estimation.
+///
+/// With --jets FILE, the subtracted full-event jets of every event are
+/// written to FILE as binary columns (fcc::BinaryJetWriter: pt,
+/// rapidity, phi, mass, area, subtracted pt and number of
+/// constituents; compressed with --compress) instead of the per-event
+/// printout; tools/jets2txt reads them back.
 ///
 /// Source code: 07-subtraction.cc
 //----------------------------------------------------------------------
@@ -42,89 +70,29 @@
 #include "fastjet/Selector.hh"
 #include "fastjet/tools/JetMedianBackgroundEstimator.hh"
 #include "fastjet/tools/Subtractor.hh" 
+#include "fcc/EventReader.hh"
+#include "fcc/Timer.hh"
+#include "fcc/ExerciseAnalyses.hh"
+#include "fcc/SubtractionStage.hh"
 #include <iostream> // needed for io
 
 using namespace std;
 using namespace fastjet;
 
-int main(){
+int main(int argc, char ** argv){
   
-  // read in input particles
+  // The clustering, area and background-estimation setup, and the
+  // per-event work, live in fcc::SubtractionAnalysis so that the same
+  // code is also run by the parallel driver (tools/parallel_analysis.cc).
   //
-  // since we use here simulated data we can split the hard event
-  // from the full (i.e. with pileup added) one
-  //----------------------------------------------------------
-
-  vector<PseudoJet> hard_event, full_event;
-  
-  // read in input particles. Keep the hard event generated by PYTHIA
-  // separated from the full event, so as to be able to gauge the
-  // "goodness" of the subtraction from the full event, which also
-  // includes pileup
-  double particle_maxrap = 5.0;
-
-  string line;
-  int  nsub  = 0; // counter to keep track of which sub-event we're reading
-  while (getline(cin, line)) {
-    istringstream linestream(line);
-    // take substrings to avoid problems when there are extra "pollution"
-    // characters (e.g. line-feed).
-    if (line.substr(0,4) == "#END") {break;}
-    if (line.substr(0,9) == "#SUBSTART") {
-      // if more sub events follow, make copy of first one (the hard one) here
-      if (nsub == 1) hard_event = full_event;
-      nsub += 1;
-    }
-    if (line.substr(0,1) == "#") {continue;}
-    double px,py,pz,E;
-    linestream >> px >> py >> pz >> E;
-    // you can construct 
-    PseudoJet particle(px,py,pz,E);
-
-    // push event onto back of full_event vector
-    if (abs(particle.rap()) <= particle_maxrap) full_event.push_back(particle);
-  }
-
-  // if we have read in only one event, copy it across here...
-  if (nsub == 1) hard_event = full_event;
-
-  // if there was nothing in the event 
-  if (nsub == 0) {
-    cerr << "Error: read empty event\n";
-    exit(-1);
-  }
-  
-  
-  // create a jet definition for the clustering
-  // We use the anti-kt algorithm with a radius of 0.5
-  //----------------------------------------------------------
-  double R = 0.5;
-  JetDefinition jet_def(antikt_algorithm, R);
-
-  // create an area definition for the clustering
-  //----------------------------------------------------------
-  // ghosts should go up to the acceptance of the detector or
-  // (with infinite acceptance) at least 2R beyond the region
-  // where you plan to investigate jets.
-  double ghost_maxrap = 6.0;
-  GhostedAreaSpec area_spec(ghost_maxrap);
-  AreaDefinition area_def(active_area, area_spec);
-
-  // run the jet clustering with the above jet and area definitions
-  // for both the hard and full event
+  // For the main clustering:
+  //  - particles are kept up to |y|=5
+  //  - we use the anti-kt algorithm with a radius of 0.5
+  //  - ghosts should go up to the acceptance of the detector or
+  //    (with infinite acceptance) at least 2R beyond the region
+  //    where you plan to investigate jets: we go up to |y|=6
   //
-  // We retrieve the jets above 7 GeV in both case (note that the
-  // 7-GeV cut we be applied again later on after we subtract the jets
-  // from the full event)
-  // ----------------------------------------------------------
-  ClusterSequenceArea clust_seq_hard(hard_event, jet_def, area_def);
-  ClusterSequenceArea clust_seq_full(full_event, jet_def, area_def);
-
-  double ptmin = 7.0;
-  vector<PseudoJet> hard_jets = sorted_by_pt(clust_seq_hard.inclusive_jets(ptmin));
-  vector<PseudoJet> full_jets = sorted_by_pt(clust_seq_full.inclusive_jets(ptmin));
-
-  // Now turn to the estimation of the background (for the full event)
+  // For the estimation of the background (for the full event)
   //
   // There are different ways to do that. In general, this also
   // requires clustering the particles that will be handled internally
@@ -151,81 +119,133 @@ int main(){
   //    cover the range, a warning will be issued otherwise).
   //    In this particular example, the two hardest jets in the event
   //    are removed from the background estimation
-  // ----------------------------------------------------------
-  JetDefinition jet_def_bkgd(kt_algorithm, 0.4);
-  AreaDefinition area_def_bkgd(active_area_explicit_ghosts, 
-                               GhostedAreaSpec(ghost_maxrap));
-  Selector selector = SelectorAbsRapMax(4.5) * (!SelectorNHardest(2));
-  JetMedianBackgroundEstimator bkgd_estimator(selector, jet_def_bkgd, area_def_bkgd);
-
+  //
   // To help manipulate the background estimator, we also provide a
   // transformer that allows to apply directly the background
   // subtraction on the jets. This will use the background estimator
   // to compute rho for the jets to be subtracted.
+  //
+  // All of these are created once here and reused for every event.
   // ----------------------------------------------------------
-  Subtractor subtractor(&bkgd_estimator);
-
-  // Finally, once we have an event, we can just tell the background
-  // estimator to use that list of particles
-  // This could be done directly when declaring the background
-  // estimator but the usage below can more easily be accomodated to a
-  // loop over a set of events.
-  // ----------------------------------------------------------
-  bkgd_estimator.set_particles(full_event);
+  bool shared_clustering = false, cached_ghosts = false, grid_rho = false, soft_killer = false;
+  bool compress = false, bad_option = false;
+  string jets_file;
+  for (int iarg = 1; iarg < argc && !bad_option; iarg++){
+    string option = argv[iarg];
+    if      (option == "--shared-clustering") shared_clustering = true;
+    else if (option == "--cached-ghosts")     cached_ghosts = true;
+    else if (option == "--grid-rho")          grid_rho = true;
+    else if (option == "--soft-killer")       soft_killer = true;
+    else if (option == "--compress")          compress = true;
+    else if ((option == "--jets") && (iarg+1 < argc)) jets_file = argv[++iarg];
+    else bad_option = true;
+  }
+  // fcc::SubtractionStage always draws its ghosts from its own lattice
+  // and estimates rho from kt jets, so it has no use for these two
+  if (shared_clustering && (cached_ghosts || grid_rho)){
+    cerr << "Error: --shared-clustering cannot be combined with --cached-ghosts or --grid-rho" << endl;
+    bad_option = true;
+  }
+  if (bad_option){
+    cerr << "usage: " << argv[0] << " [--shared-clustering | [--cached-ghosts] [--grid-rho]] [--soft-killer]" << endl
+         << "       [--jets FILE [--compress]] < events.dat" << endl;
+    return 1;
+  }
+  unique_ptr<fcc::SubtractionAnalysis> analysis_ptr;
+  if (shared_clustering) analysis_ptr.reset(new fcc::SubtractionStage());
+  else analysis_ptr.reset(new fcc::SubtractionAnalysis(cached_ghosts, grid_rho));
+  fcc::SubtractionAnalysis & analysis = *analysis_ptr;
+  if (soft_killer) analysis.set_soft_killer(fcc::SoftKiller());
 
-  // show a summary of what was done so far
+  // show a summary of what is being done
   //  - the description of the algorithms, areas and ranges used
-  //  - the background properties
-  //  - the jets in the hard event
   //----------------------------------------------------------
   cout << "Main clustering:" << endl;
-  cout << "  Ran:   " << jet_def.description() << endl;
-  cout << "  Area:  " << area_def.description() << endl;
-  cout << "  Particles up to |y|=" << particle_maxrap << endl;
+  cout << "  Ran:   " << analysis.jet_def().description() << endl;
+  cout << "  Area:  " << analysis.area_def().description() << endl;
+  cout << "  Particles up to |y|=" << analysis.particle_maxrap() << endl;
   cout << endl;
 
   cout << "Background estimation:" << endl;
-  cout << "  " << bkgd_estimator.description() << endl << endl;;
-  cout << "  Giving, for the full event" << endl;
-  cout << "    rho   = " << bkgd_estimator.rho()   << endl;
-  cout << "    sigma = " << bkgd_estimator.sigma() << endl;
-  cout << endl;
-
-  cout << "Jets above " << ptmin << " GeV in the hard event (" << hard_event.size() << " particles)" << endl;
-  cout << "---------------------------------------\n";
-  printf("%5s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "area");
-   for (unsigned int i = 0; i < hard_jets.size(); i++) {
-    printf("%5u %15.8f %15.8f %15.8f %15.8f\n", i,
-           hard_jets[i].rap(), hard_jets[i].phi(), hard_jets[i].perp(),
-           hard_jets[i].area());
+  cout << "  " << analysis.bkgd_estimator().description() << endl << endl;;
+  if (analysis.soft_killer()){
+    cout << "Pre-filter:" << endl;
+    cout << "  " << analysis.soft_killer()->description() << endl << endl;
   }
-  cout << endl;
 
-  // Once the background properties have been computed, subtraction
-  // can be applied on the jets. Subtraction is performed on the
-  // full 4-vector
+  // read in input particles
   //
-  // We output the jets before and after subtraction
-  // ----------------------------------------------------------
-  cout << "Jets above " << ptmin << " GeV in the full event (" << full_event.size() << " particles)" << endl;
-  cout << "---------------------------------------\n";
-  printf("%5s %15s %15s %15s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "area", "rap_sub", "phi_sub", "pt_sub");
-  unsigned int idx=0;
-
-  // get the subtracted jets
-  vector<PseudoJet> subtracted_jets = subtractor(full_jets);
-
-  for (unsigned int i=0; i<full_jets.size(); i++){
-    // re-apply the pt cut
-    if (subtracted_jets[i].perp2() >= ptmin*ptmin){
-      printf("%5u %15.8f %15.8f %15.8f %15.8f %15.8f %15.8f %15.8f\n", idx,
-             full_jets[i].rap(), full_jets[i].phi(), full_jets[i].perp(),
-             full_jets[i].area(),
-             subtracted_jets[i].rap(), subtracted_jets[i].phi(), 
-             subtracted_jets[i].perp());
-      idx++;
+  // since we use here simulated data we can split the hard event
+  // (the first sub-event) from the full (i.e. with pileup added)
+  // one. The event is declared outside of the event loop so that its
+  // memory gets reused from one event to the next.
+  //----------------------------------------------------------
+  fcc::EventReader reader;
+  fcc::Event event;
+  fcc::Throughput throughput;
+
+  // with --jets, the jets go to a binary file rather than to the
+  // printout
+  unique_ptr<fcc::BinaryJetWriter> jets_writer;
+  if (!jets_file.empty()) jets_writer.reset(new fcc::BinaryJetWriter(jets_file, true, true, compress));
+
+  // the timer covers the reading and processing of each event, but
+  // not its printout
+  fcc::Timer timer;
+  while (reader.next_event(event)) {
+    unsigned int iev = reader.n_events_read()-1;
+
+    // if there was nothing in the event 
+    if (event.empty()) {
+      cerr << "Error: read empty event (event " << iev << ")\n";
+      timer.start();
+      continue;
+    }
+
+    // cluster the hard and full events, estimate the background of
+    // the full event and subtract its jets
+    analysis.process(event, iev);
+
+    double event_time = timer.elapsed();
+    throughput.add(event.size(), event_time);
+
+    // show what was done for this event
+    //  - the background properties
+    //  - the jets in the hard event
+    //  - the jets before and after subtraction in the full event
+    //----------------------------------------------------------
+    if (jets_writer) {
+      analysis.write_jets(*jets_writer, iev);
+    } else {
+      cout << "Event " << iev << ": " << event.size() << " particles, "
+           << event.n_subevents() << " sub-events, processed in "
+           << event_time*1000 << " ms" << endl;
+      analysis.print(cout);
+      cout << endl;
     }
+
+    timer.start();
+  }
+
+  // if there was nothing in the input
+  if (throughput.n_events() == 0) {
+    cerr << "Error: read empty event\n";
+    exit(-1);
+  }
+
+  // overall throughput (time spent reading and processing the
+  // events, excluding the printout)
+  //----------------------------------------------------------
+  cout << "Processed " << throughput.n_events() << " events ("
+       << throughput.n_particles() << " particles) in "
+       << throughput.time() << " s" << endl;
+  cout << "  " << throughput.events_per_second() << " events/s, "
+       << throughput.particles_per_second() << " particles/s" << endl;
+  if (jets_writer) {
+    jets_writer->close();
+    cout << "Wrote " << jets_writer->n_jets() << " jets (" << jets_writer->n_bytes()
+         << " bytes) to " << jets_file << endl;
   }
 
   return 0;
-}
\ No newline at end of file
+}
@@ -16,7 +16,21 @@
 /// it might also be useful to define new recombination schemes using
 /// the extra information.
 ///
+/// By default the information is not attached to the particles but
+/// kept in an fcc::ParticleInfo: per-event columns of PDG ids, vertex
+/// numbers and charges, looked up through the user index, which
+/// avoids one heap allocation per particle and a dynamic_cast per
+/// access. The hard and pi0+gamma parts of all the jets are then
+/// summed in one pass over the clustering history
+/// (fcc::JetComposition), without building the constituents of each
+/// jet. With --column-selectors, the two selections are evaluated
+/// together on each jet's constituents, as bit masks
+/// (fcc::ColumnSelection). With --user-info, a MyUserInfo is attached
+/// to every particle and the Selectors below are used. All three
+/// give the same output.
+///
 /// run it with    : ./09-user_info < data/Pythia-dijet-ptmin100-lhc-pileup-1ev.dat
+///            or  : ./09-user_info [--column-selectors|--user-info] < data/Pythia-dijet-ptmin100-lhc-pileup-1ev.dat
 ///
 /// (Note that this event consists of many sub-events, the first one
 /// being the "hard" interaction and the following being minbias
@@ -56,6 +70,10 @@
 
 #include "fastjet/ClusterSequence.hh"
 #include "fastjet/Selector.hh"
+#include "fcc/EventReader.hh"
+#include "fcc/JetComposition.hh"
+#include "fcc/ColumnSelector.hh"
+#include "fcc/ParticleInfo.hh"
 #include <iostream> // needed for io
 #include <sstream>  // needed for io
 #include <cstdio>   // needed for io
@@ -191,52 +209,60 @@ Selector SelectorVertexNumber(const int & vertex_number){
 
 //------------------------------------------------------------------------
 // The example code associating user-info to the particles in the event
-int main(){
+int main(int argc, char ** argv){
+  string mode = (argc > 1) ? argv[1] : "";
+  bool use_user_info = (mode == "--user-info");
+  bool use_column_selectors = (mode == "--column-selectors");
+  if ((argc > 2) || (!mode.empty() && !use_user_info && !use_column_selectors)){
+    cerr << "usage: " << argv[0] << " [--user-info | --column-selectors] < events.dat" << endl;
+    return 1;
+  }
+
   // read in input particles
   //----------------------------------------------------------
   vector<PseudoJet> input_particles;
   
-  double px, py, pz, E;
-  string str;
-  int vertex_number=-1;
-  int pdg_id = 21;
-  while (getline(cin, str)){
-    // if the line does not start with #, it's a particle
-    // read its momentum and pdg id
-    if (str[0] != '#'){
-      istringstream iss(str);
-      if (! (iss >> px >> py >> pz >> E >> pdg_id)){
-        cerr << "Wrong file format: particles must be specified with" << endl;
-        cerr << "  px py pz E pdg_id" << endl;
-      }
-
-      // first create a PseudoJet with the correct momentum
-      PseudoJet p(px,py,pz,E);
-
-      // associate to that our user-defined extra information
-      // which is done using 
-      //   PseudoJet::set_user_info()
-      //
-      // IMPORTANT NOTE: set_user_info(...) takes a pointer as an
-      // argument. It will "own" that pointer i.e. will delete it when
-      // all the PseudoJet's using it will be deleted.
-      //
-      // NB: once you've done p.set_user_info(my_user_info_ptr), you must
-      // not call p2.set_user_info(my_user_info_ptr) with the same pointer
-      // because p and p2 will both attempt to delete it when they go out
-      // of scope causing a double-free corruption error. Instead do
-      // p2.user_info_shared_ptr() = p.user_info_shared_ptr();
-      p.set_user_info(new MyUserInfo(pdg_id, vertex_number));
-      PseudoJet p2; // defined only to make the above documentation consistent!
+  // the reader keeps track of the sub-event each particle comes from
+  // (incremented at every "#SUBSTART") and of its PDG id
+  fcc::EventReader reader;
+  fcc::Event event;
+  reader.next_event(event);
+  if (!event.has_pdg_id()){
+    cerr << "Wrong file format: particles must be specified with" << endl;
+    cerr << "  px py pz E pdg_id" << endl;
+  }
 
+  // the PDG ids and vertex numbers of the whole event, in columns
+  // indexed by the user index that event.pseudojet(i) sets to i.
+  // Nothing needs to be attached to the particles themselves.
+  fcc::ParticleInfo particle_info;
+  if (!use_user_info) particle_info.fill(event);
+
+  for (unsigned int i = 0; i < event.size(); i++){
+    // first create a PseudoJet with the correct momentum
+    PseudoJet p = event.pseudojet(i);
+    if (!use_user_info){
       input_particles.push_back(p);
       continue;
     }
 
-    // check if we start a new sub-event
-    if ((str.length()>=9) && (str.compare(0,9,"#SUBSTART")==0)){
-      vertex_number++;
-    }
+    // associate to that our user-defined extra information
+    // which is done using 
+    //   PseudoJet::set_user_info()
+    //
+    // IMPORTANT NOTE: set_user_info(...) takes a pointer as an
+    // argument. It will "own" that pointer i.e. will delete it when
+    // all the PseudoJet's using it will be deleted.
+    //
+    // NB: once you've done p.set_user_info(my_user_info_ptr), you must
+    // not call p2.set_user_info(my_user_info_ptr) with the same pointer
+    // because p and p2 will both attempt to delete it when they go out
+    // of scope causing a double-free corruption error. Instead do
+    // p2.user_info_shared_ptr() = p.user_info_shared_ptr();
+    p.set_user_info(new MyUserInfo(event.pdg_id(i), event.subevent(i)));
+    PseudoJet p2; // defined only to make the above documentation consistent!
+
+    input_particles.push_back(p);
   }
   
 
@@ -265,6 +291,9 @@ int main(){
   //      {index, rap, phi, pt}
   //----------------------------------------------------------
   cout << "Ran " << jet_def.description() << endl;
+  cout << "Particle information " << (use_user_info ? "attached as MyUserInfo" :
+                                      use_column_selectors ? "from fcc::ParticleInfo, selected on the constituents" :
+                                      "from fcc::ParticleInfo, summed over the clustering history") << endl;
 
   // label the columns
   printf("%5s %15s %15s %15s %15s %15s\n","jet #",
@@ -277,21 +306,47 @@ int main(){
   // a selection on the pi0
   Selector sel_pi0gamma = SelectorIsPi0Gamma();
 
+  // the same two selections on the fcc::ParticleInfo columns: both
+  // are evaluated together on the constituents of a jet, as bit masks
+  vector<fcc::ColumnSelector> column_selectors;
+  column_selectors.push_back(fcc::ColumnSelector::vertex_number(0));
+  column_selectors.push_back(fcc::ColumnSelector::pdg_id(111) || fcc::ColumnSelector::pdg_id(22));
+  fcc::ColumnSelection selection(particle_info, column_selectors);
+
+  // the hard and pi0+gamma parts of all the jets at once, from a
+  // single pass over the clustering history
+  fcc::JetComposition composition;
+  if (!use_user_info && !use_column_selectors)
+    composition.process(clust_seq, particle_info, inclusive_jets);
+
   // print out the details for each jet
   for (unsigned int i = 0; i < inclusive_jets.size(); i++) {
     const PseudoJet & full = inclusive_jets[i];
-    const vector<PseudoJet> constituents = full.constituents();
-
-    // get the contribution from the 1st vertex
-    PseudoJet hard = join(sel_vtx0(constituents));
-    
-    // get the contribution from the pi0's
-    PseudoJet pi0gamma = join(sel_pi0gamma(constituents));
+    double pt_hard, pt_pi0gamma;
+
+    if (use_user_info){
+      const vector<PseudoJet> constituents = full.constituents();
+
+      // get the contribution from the 1st vertex
+      pt_hard = join(sel_vtx0(constituents)).perp();
+
+      // get the contribution from the pi0's
+      pt_pi0gamma = join(sel_pi0gamma(constituents)).perp();
+    } else if (use_column_selectors){
+      // both contributions from a single pass over the constituents
+      const vector<PseudoJet> constituents = full.constituents();
+      selection.evaluate(constituents);
+      pt_hard     = selection.sum(0).perp();
+      pt_pi0gamma = selection.sum(1).perp();
+    } else {
+      pt_hard     = composition.pt_hard(i);
+      pt_pi0gamma = composition.pt(i, fcc::JetComposition::photon_pi0);
+    }
     
     // print the result
     printf("%5u %15.8f %15.8f %15.8f %15.8f %15.8f\n", i,
            full.rap(), full.phi(), full.perp(),
-           hard.perp(), pi0gamma.perp());
+           pt_hard, pt_pi0gamma);
   }
 
   return 0;
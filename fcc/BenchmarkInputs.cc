@@ -0,0 +1,69 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::BenchmarkInputs
+//----------------------------------------------------------------------
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/EventReader.hh"
+#include "fcc/PileupMixer.hh"
+#include <cstdlib>
+#include <sstream>
+
+using namespace std;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+bool BenchmarkInputs::parse_option(int argc, char ** argv, int & iarg){
+  string arg = argv[iarg];
+  if (iarg+1 >= argc) return false;
+  if      (arg == "--min-time") _min_time = atof(argv[++iarg]);
+  else if (arg == "--minbias")  _minbias_files.push_back(argv[++iarg]);
+  else if (arg == "--mu"){
+    istringstream iss(argv[++iarg]);
+    string item;
+    while (getline(iss, item, ',')) _mus.push_back(atof(item.c_str()));
+  }
+  else return false;
+  return true;
+}
+
+//----------------------------------------------------------------------
+vector<double> BenchmarkInputs::mus() const{
+  if (!_mus.empty()) return _mus;
+  vector<double> defaults;
+  defaults.push_back(200);
+  defaults.push_back(1000);
+  return defaults;
+}
+
+//----------------------------------------------------------------------
+bool BenchmarkInputs::run(const vector<string> & files, const Benchmark & benchmark) const{
+  bool all_ok = true;
+  vector<vector<Event> > file_events(files.size());
+  Event event;
+  for (unsigned int ifile = 0; ifile < files.size(); ifile++){
+    EventReader reader(files[ifile]);
+    while (reader.next_event(event)) file_events[ifile].push_back(event);
+    if (file_events[ifile].empty()) continue;
+    all_ok &= benchmark(files[ifile], file_events[ifile]);
+  }
+
+  if (_minbias_files.empty() || files.empty() || file_events[0].empty()) return all_ok;
+  PileupMixer mixer;
+  for (unsigned int ifile = 0; ifile < _minbias_files.size(); ifile++){
+    EventReader reader(_minbias_files[ifile]);
+    while (reader.next_event(event)) mixer.add_to_pool(event);
+  }
+  vector<double> mu_values = mus();
+  for (unsigned int imu = 0; imu < mu_values.size(); imu++){
+    vector<Event> mixed(file_events[0].size());
+    for (unsigned int iev = 0; iev < mixed.size(); iev++)
+      mixer.mix(file_events[0][iev], 0, mixer.n_pileup(mu_values[imu], false), mixed[iev]);
+    ostringstream label;
+    label << "mu=" << mu_values[imu];
+    all_ok &= benchmark(label.str(), mixed);
+  }
+  return all_ok;
+}
+
+} // namespace fcc
@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------
+/// \file
+/// The inputs shared by the benchmark tools: event files, and the same
+/// events with mu minimum-bias sub-events overlaid
+//----------------------------------------------------------------------
+#ifndef __FCC_BENCHMARKINPUTS_HH__
+#define __FCC_BENCHMARKINPUTS_HH__
+
+#include "fcc/Event.hh"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class BenchmarkInputs
+/// command-line options and event samples common to the benchmarks
+///
+/// The options are
+///   --minbias FILE   pileup file whose sub-events 1, 2, ... fill the
+///                    minimum-bias pool (may be repeated)
+///   --mu L           comma-separated list of mu (default 200,1000)
+///   --min-time T     time spent on each measurement
+///
+/// run() hands the events of every file to the benchmark, then, when
+/// --minbias was given, the events of the first file with mu
+/// phi-rotated minimum-bias sub-events overlaid (fcc::PileupMixer),
+/// labelled "mu=...".
+///
+/// Usage:
+///   fcc::BenchmarkInputs inputs;
+///   for (int iarg = 1; iarg < argc; iarg++){
+///     if (inputs.parse_option(argc, argv, iarg)) continue;
+///     ...
+///   }
+///   bool ok = inputs.run(files, [&](const string & label, const vector<fcc::Event> & events){
+///     return benchmark(label, events, inputs.min_time()); });
+class BenchmarkInputs {
+public:
+  typedef std::function<bool(const std::string & label, const std::vector<Event> & events)> Benchmark;
+
+  /// min_time is the default of --min-time
+  BenchmarkInputs(double min_time = 0.2) : _min_time(min_time) {}
+
+  /// if argv[iarg] is one of the options above, take it (and its
+  /// value, advancing iarg) and return true
+  bool parse_option(int argc, char ** argv, int & iarg);
+
+  /// the options, as given in the usage messages
+  static const char * usage() { return "[--minbias pileup.dat] [--mu m1,m2,...] [--min-time T]"; }
+
+  double min_time() const { return _min_time; }
+
+  /// the mu values (200 and 1000 unless --mu was given)
+  std::vector<double> mus() const;
+
+  /// run "benchmark" on the events of each file (files without events
+  /// are skipped), then on the mixed events at each mu; returns true
+  /// if all the calls returned true
+  bool run(const std::vector<std::string> & files, const Benchmark & benchmark) const;
+
+private:
+  double _min_time;
+  std::vector<double> _mus;
+  std::vector<std::string> _minbias_files;
+};
+
+} // namespace fcc
+
+#endif // __FCC_BENCHMARKINPUTS_HH__
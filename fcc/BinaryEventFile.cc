@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of the binary event file reading and writing
+//----------------------------------------------------------------------
+#include "fcc/BinaryEventFile.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace binary_format {
+
+//----------------------------------------------------------------------
+bool is_binary(const char * data, size_t size){
+  return (size >= sizeof(magic)) && (memcmp(data, magic, sizeof(magic)) == 0);
+}
+
+//----------------------------------------------------------------------
+// the int columns are padded so that every block is a multiple of 8
+// bytes long
+size_t Block::size(const BlockHeader & header, uint32_t flags){
+  size_t n = header.n_particles;
+  size_t int_columns = ((flags & has_pdg_id) ? 1 : 0) + ((flags & has_subevent) ? 1 : 0);
+  size_t int_bytes = int_columns * n * sizeof(int32_t);
+  return sizeof(BlockHeader) + (header.n_events+1)*sizeof(uint64_t)
+    + 4*n*sizeof(double) + (int_bytes+7)/8*8;
+}
+
+//----------------------------------------------------------------------
+void Block::set(const char * data, uint32_t flags){
+  const BlockHeader * header = reinterpret_cast<const BlockHeader*>(data);
+  _n_events    = header->n_events;
+  _n_particles = header->n_particles;
+  size_t n = _n_particles;
+
+  _offsets = reinterpret_cast<const uint64_t*>(data + sizeof(BlockHeader));
+  _px = reinterpret_cast<const double*>(_offsets + _n_events+1);
+  _py = _px + n;
+  _pz = _py + n;
+  _E  = _pz + n;
+  const int * next = reinterpret_cast<const int*>(_E + n);
+  _pdg_id   = 0;
+  _subevent = 0;
+  if (flags & has_pdg_id){   _pdg_id   = next; next += n;}
+  if (flags & has_subevent){ _subevent = next;}
+}
+
+//----------------------------------------------------------------------
+bool Block::offsets_valid() const{
+  if (_offsets[0] != 0) return false;
+  for (unsigned int i = 0; i < _n_events; i++){
+    if (_offsets[i+1] < _offsets[i]) return false;
+  }
+  return _offsets[_n_events] == _n_particles;
+}
+
+//----------------------------------------------------------------------
+EventColumns Block::event(unsigned int i) const{
+  EventColumns columns;
+  size_t begin = _offsets[i];
+  columns.n  = _offsets[i+1] - begin;
+  columns.px = _px + begin;
+  columns.py = _py + begin;
+  columns.pz = _pz + begin;
+  columns.E  = _E  + begin;
+  columns.pdg_id   = _pdg_id   ? _pdg_id   + begin : 0;
+  columns.subevent = _subevent ? _subevent + begin : 0;
+  return columns;
+}
+
+} // namespace binary_format
+
+//----------------------------------------------------------------------
+// BinaryEventWriter
+//----------------------------------------------------------------------
+BinaryEventWriter::BinaryEventWriter(const string & filename,
+                                     bool with_pdg_id, bool with_subevent,
+                                     unsigned int max_block_particles)
+  : _filename(filename), _flags(0),
+    _max_block_particles(max_block_particles), _n_events(0){
+  if (with_pdg_id)   _flags |= binary_format::has_pdg_id;
+  if (with_subevent) _flags |= binary_format::has_subevent;
+
+  _file = (filename == "-") ? stdout : fopen(filename.c_str(), "wb");
+  if (!_file) throw Error("BinaryEventWriter: could not create "+filename);
+
+  binary_format::FileHeader header;
+  memcpy(header.magic, binary_format::magic, sizeof(header.magic));
+  header.version = binary_format::version;
+  header.flags   = _flags;
+  header.byte_order_mark = binary_format::byte_order_mark;
+  header.unused  = 0;
+  if (fwrite(&header, sizeof(header), 1, _file) != 1)
+    throw Error("BinaryEventWriter: error while writing "+_filename);
+
+  _offsets.push_back(0);
+}
+
+//----------------------------------------------------------------------
+BinaryEventWriter::~BinaryEventWriter(){
+  // do not throw from the destructor
+  try { close(); } catch (const Error &) {}
+}
+
+//----------------------------------------------------------------------
+void BinaryEventWriter::write(const Event & event){
+  if (!_file) throw Error("BinaryEventWriter: writing to closed file "+_filename);
+
+  unsigned int n = event.size();
+  _px.insert(_px.end(), event.px(), event.px()+n);
+  _py.insert(_py.end(), event.py(), event.py()+n);
+  _pz.insert(_pz.end(), event.pz(), event.pz()+n);
+  _E .insert(_E .end(), event.E(),  event.E() +n);
+  if (_flags & binary_format::has_pdg_id)
+    _pdg_id.insert(_pdg_id.end(), event.pdg_id(), event.pdg_id()+n);
+  if (_flags & binary_format::has_subevent)
+    _subevent.insert(_subevent.end(), event.subevent(), event.subevent()+n);
+  _offsets.push_back(_px.size());
+  _n_events++;
+
+  if (_px.size() >= _max_block_particles) _flush();
+}
+
+//----------------------------------------------------------------------
+void BinaryEventWriter::_flush(){
+  if (_offsets.size() < 2) return;
+
+  binary_format::BlockHeader header;
+  header.n_events    = _offsets.size()-1;
+  header.n_particles = _px.size();
+
+  size_t n = _px.size();
+  bool ok = (fwrite(&header, sizeof(header), 1, _file) == 1)
+    && (fwrite(&_offsets[0], sizeof(uint64_t), _offsets.size(), _file) == _offsets.size());
+  if (n > 0){
+    ok = ok && (fwrite(&_px[0], sizeof(double), n, _file) == n)
+            && (fwrite(&_py[0], sizeof(double), n, _file) == n)
+            && (fwrite(&_pz[0], sizeof(double), n, _file) == n)
+            && (fwrite(&_E [0], sizeof(double), n, _file) == n);
+    if (_flags & binary_format::has_pdg_id)
+      ok = ok && (fwrite(&_pdg_id[0], sizeof(int32_t), n, _file) == n);
+    if (_flags & binary_format::has_subevent)
+      ok = ok && (fwrite(&_subevent[0], sizeof(int32_t), n, _file) == n);
+  }
+  // padding of the int columns
+  size_t int_bytes = (_pdg_id.size() + _subevent.size())*sizeof(int32_t);
+  static const char zeros[8] = {0,0,0,0,0,0,0,0};
+  size_t padding = (int_bytes+7)/8*8 - int_bytes;
+  if (padding) ok = ok && (fwrite(zeros, 1, padding, _file) == padding);
+  if (!ok) throw Error("BinaryEventWriter: error while writing "+_filename);
+
+  _offsets.resize(1);
+  _px.clear(); _py.clear(); _pz.clear(); _E.clear();
+  _pdg_id.clear(); _subevent.clear();
+}
+
+//----------------------------------------------------------------------
+void BinaryEventWriter::close(){
+  if (!_file) return;
+  _flush();
+  bool ok = (_file == stdout) ? (fflush(_file) == 0) : (fclose(_file) == 0);
+  _file = 0;
+  if (!ok) throw Error("BinaryEventWriter: error while closing "+_filename);
+}
+
+//----------------------------------------------------------------------
+// BinaryEventFile
+//----------------------------------------------------------------------
+BinaryEventFile::BinaryEventFile(const string & filename)
+  : _filename(filename), _map(0), _map_size(0){
+  _fd = open(filename.c_str(), O_RDONLY);
+  if (_fd < 0) throw Error("BinaryEventFile: could not open "+filename);
+
+  struct stat info;
+  if ((fstat(_fd, &info) != 0) || (size_t(info.st_size) < sizeof(binary_format::FileHeader))){
+    ::close(_fd);
+    throw Error("BinaryEventFile: "+filename+" is too short to be a binary event file");
+  }
+  void * map = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+  if (map == MAP_FAILED){
+    ::close(_fd);
+    throw Error("BinaryEventFile: could not map "+filename);
+  }
+  _map = static_cast<char*>(map);
+  _map_size = info.st_size;
+
+  const binary_format::FileHeader * header =
+    reinterpret_cast<const binary_format::FileHeader*>(_map);
+  if ((!binary_format::is_binary(_map, _map_size)) ||
+      (header->byte_order_mark != binary_format::byte_order_mark) ||
+      (header->version != binary_format::version)){
+    munmap(_map, _map_size);
+    ::close(_fd);
+    throw Error("BinaryEventFile: "+filename+" is not a (compatible) binary event file");
+  }
+  _flags = header->flags;
+
+  // index the blocks
+  _event_starts.push_back(0);
+  size_t position = sizeof(binary_format::FileHeader);
+  while (position + sizeof(binary_format::BlockHeader) <= _map_size){
+    const binary_format::BlockHeader * block_header =
+      reinterpret_cast<const binary_format::BlockHeader*>(_map + position);
+    size_t block_size = binary_format::Block::size(*block_header, _flags);
+    if (position + block_size > _map_size){
+      munmap(_map, _map_size);
+      ::close(_fd);
+      throw Error("BinaryEventFile: "+filename+" is truncated");
+    }
+    _blocks.push_back(binary_format::Block());
+    _blocks.back().set(_map + position, _flags);
+    if (!_blocks.back().offsets_valid()){
+      munmap(_map, _map_size);
+      ::close(_fd);
+      throw Error("BinaryEventFile: "+filename+" has invalid event offsets");
+    }
+    _event_starts.push_back(_event_starts.back() + block_header->n_events);
+    position += block_size;
+  }
+}
+
+//----------------------------------------------------------------------
+BinaryEventFile::~BinaryEventFile(){
+  munmap(_map, _map_size);
+  ::close(_fd);
+}
+
+//----------------------------------------------------------------------
+EventColumns BinaryEventFile::columns(unsigned long i) const{
+  if (i >= n_events()) throw Error("BinaryEventFile: event index out of range");
+  // _event_starts is sorted: find the block holding event i
+  unsigned int iblock = upper_bound(_event_starts.begin(), _event_starts.end(), i)
+    - _event_starts.begin() - 1;
+  return _blocks[iblock].event(i - _event_starts[iblock]);
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> BinaryEventFile::pseudojets(unsigned long i) const{
+  vector<PseudoJet> particles;
+  columns(i).append_pseudojets(particles);
+  return particles;
+}
+
+//----------------------------------------------------------------------
+void BinaryEventFile::load(unsigned long i, Event & event) const{
+  event.assign(columns(i));
+}
+
+} // namespace fcc
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------
+/// \file
+/// Binary, column-wise storage of events
+///
+/// The layout of a file is
+///
+///   header   : char magic[8] = "FCCEVT01"
+///              uint32 version, uint32 flags, uint32 byte-order mark,
+///              uint32 (unused)
+///   block 0  : uint64 n_events, uint64 n_particles
+///              uint64 offsets[n_events+1]  (first particle of each
+///                                           event within the block)
+///              double px[n_particles], py[...], pz[...], E[...]
+///              int32  pdg_id[n_particles]   (if flags & has_pdg_id)
+///              int32  subevent[n_particles] (if flags & has_subevent)
+///              padding to a multiple of 8 bytes
+///   block 1  : ...
+///
+/// Numbers are stored in the native byte order of the machine that
+/// wrote the file (files from a machine with a different byte order
+/// are rejected). Blocks let the writer work with bounded memory and
+/// keep every column 8-byte aligned, so that a memory-mapped file
+/// can be used in place.
+//----------------------------------------------------------------------
+#ifndef __FCC_BINARYEVENTFILE_HH__
+#define __FCC_BINARYEVENTFILE_HH__
+
+#include "fcc/Event.hh"
+#include "fcc/EventWriter.hh"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace fcc {
+
+namespace binary_format {
+  /// the magic string at the start of every binary event file
+  const char magic[8] = {'F','C','C','E','V','T','0','1'};
+  const uint32_t version = 1;
+  const uint32_t byte_order_mark = 0x01020304;
+
+  /// flags describing the optional columns
+  enum Flags { has_pdg_id = 1, has_subevent = 2 };
+
+  struct FileHeader {
+    char     magic[8];
+    uint32_t version, flags, byte_order_mark, unused;
+  };
+
+  struct BlockHeader {
+    uint64_t n_events, n_particles;
+  };
+
+  /// true if the "size" bytes at "data" start like a binary event file
+  bool is_binary(const char * data, size_t size);
+
+  /// \class Block
+  /// decoding of one block of events sitting in memory
+  class Block {
+  public:
+    Block() : _n_events(0), _n_particles(0) {}
+
+    /// number of bytes a block takes, given its header
+    static size_t size(const BlockHeader & header, uint32_t flags);
+
+    /// decode the block starting at "data"
+    void set(const char * data, uint32_t flags);
+
+    unsigned int n_events()    const { return _n_events; }
+    unsigned int n_particles() const { return _n_particles; }
+
+    /// true if the event offsets start at 0, never decrease and end at
+    /// n_particles(), i.e. if every event lies within the block; to be
+    /// checked after set() before calling event()
+    bool offsets_valid() const;
+
+    /// view of event i of the block
+    EventColumns event(unsigned int i) const;
+
+  private:
+    unsigned int _n_events, _n_particles;
+    const uint64_t * _offsets;
+    const double *_px, *_py, *_pz, *_E;
+    const int *_pdg_id, *_subevent;
+  };
+}
+
+/// \class BinaryEventWriter
+/// writes events to a binary event file
+///
+/// Events are accumulated in memory until a block holds at least
+/// max_block_particles particles, at which point it is written out.
+class BinaryEventWriter : public EventWriter {
+public:
+  /// create the file, with or without the optional columns
+  BinaryEventWriter(const std::string & filename,
+                    bool with_pdg_id, bool with_subevent,
+                    unsigned int max_block_particles = 1 << 20);
+
+  /// flushes and closes the file
+  virtual ~BinaryEventWriter();
+
+  /// add one event
+  virtual void write(const Event & event);
+
+  /// write out the pending block and close the file
+  virtual void close();
+
+  /// number of events written so far
+  virtual unsigned long n_events() const { return _n_events; }
+
+protected:
+  void _flush();
+
+  std::string _filename;
+  FILE * _file;
+  uint32_t _flags;
+  unsigned int _max_block_particles;
+  unsigned long _n_events;
+
+  // the block being filled
+  std::vector<uint64_t> _offsets;
+  std::vector<double> _px, _py, _pz, _E;
+  std::vector<int> _pdg_id, _subevent;
+
+private:
+  BinaryEventWriter(const BinaryEventWriter &);
+  BinaryEventWriter & operator=(const BinaryEventWriter &);
+};
+
+/// \class BinaryEventFile
+/// random access to the events of a (memory-mapped) binary event file
+class BinaryEventFile {
+public:
+  BinaryEventFile(const std::string & filename);
+  ~BinaryEventFile();
+
+  /// number of events in the file
+  unsigned long n_events() const { return _event_starts.empty() ? 0 : _event_starts.back(); }
+
+  /// whether the optional columns are present
+  bool has_pdg_id()   const { return _flags & binary_format::has_pdg_id; }
+  bool has_subevent() const { return _flags & binary_format::has_subevent; }
+
+  /// view of the columns of event i
+  EventColumns columns(unsigned long i) const;
+
+  /// the particles of event i, built straight from the columns
+  std::vector<fastjet::PseudoJet> pseudojets(unsigned long i) const;
+
+  /// copy event i into "event"
+  void load(unsigned long i, Event & event) const;
+
+protected:
+  std::string _filename;
+  int _fd;
+  char * _map;
+  size_t _map_size;
+  uint32_t _flags;
+  std::vector<binary_format::Block> _blocks;
+  std::vector<unsigned long> _event_starts; ///< first event of each block (+ total)
+
+private:
+  BinaryEventFile(const BinaryEventFile &);
+  BinaryEventFile & operator=(const BinaryEventFile &);
+};
+
+} // namespace fcc
+
+#endif // __FCC_BINARYEVENTFILE_HH__
@@ -0,0 +1,378 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of the binary jet file writing and reading
+//----------------------------------------------------------------------
+#include "fcc/BinaryJetFile.hh"
+#include "fcc/ConstituentView.hh"
+#include "fastjet/Error.hh"
+#include <cstring>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+//----------------------------------------------------------------------
+// the double columns present with "flags", in file order
+vector<vector<double>*> double_columns(JetColumns & columns, uint32_t flags){
+  vector<vector<double>*> result;
+  result.push_back(&columns.pt);
+  result.push_back(&columns.rap);
+  result.push_back(&columns.phi);
+  result.push_back(&columns.m);
+  if (flags & jet_format::has_area)       result.push_back(&columns.area);
+  if (flags & jet_format::has_subtracted) result.push_back(&columns.pt_sub);
+  return result;
+}
+
+//----------------------------------------------------------------------
+// LEB128 varints, and zigzag coding of signed differences
+void put_varint(vector<unsigned char> & out, uint64_t value){
+  while (value >= 0x80){
+    out.push_back((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(value);
+}
+
+bool get_varint(const unsigned char * & p, const unsigned char * end, uint64_t & value){
+  value = 0;
+  for (unsigned int shift = 0; (p < end) && (shift < 64); shift += 7){
+    unsigned char byte = *p++;
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+inline uint64_t zigzag(int64_t value){ return (uint64_t(value) << 1) ^ uint64_t(value >> 63); }
+inline int64_t unzigzag(uint64_t value){ return int64_t(value >> 1) ^ -int64_t(value & 1); }
+
+//----------------------------------------------------------------------
+// run-length coding of a byte string: a control byte c < 128 is
+// followed by c+1 literal bytes, c >= 128 by one byte repeated c-125
+// times (3 to 130)
+void pack_bytes(const unsigned char * in, size_t n, vector<unsigned char> & out){
+  size_t i = 0;
+  while (i < n){
+    size_t j = i+1;
+    while ((j < n) && (in[j] == in[i]) && (j-i < 130)) j++;
+    if (j-i >= 3){
+      out.push_back(125 + (j-i));
+      out.push_back(in[i]);
+      i = j;
+      continue;
+    }
+    // literals, up to the start of the next run of 3
+    size_t start = i;
+    i++;
+    while ((i < n) && (i-start < 128) &&
+           !((i+2 < n) && (in[i] == in[i+1]) && (in[i] == in[i+2]))) i++;
+    out.push_back(i-start-1);
+    out.insert(out.end(), in+start, in+i);
+  }
+}
+
+bool unpack_bytes(const unsigned char * & p, const unsigned char * end, unsigned char * out, size_t n){
+  size_t i = 0;
+  while (i < n){
+    if (p >= end) return false;
+    unsigned int control = *p++;
+    if (control < 128){
+      size_t count = control+1;
+      if ((count > n-i) || (count > size_t(end-p))) return false;
+      memcpy(out+i, p, count);
+      p += count;
+      i += count;
+    } else {
+      size_t count = control-125;
+      if ((count > n-i) || (p >= end)) return false;
+      memset(out+i, *p++, count);
+      i += count;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+// a double column as its 8 byte planes
+void pack_doubles(const vector<double> & values, vector<unsigned char> & planes, vector<unsigned char> & out){
+  size_t n = values.size();
+  const unsigned char * bytes = reinterpret_cast<const unsigned char*>(&values[0]);
+  planes.resize(n);
+  for (unsigned int k = 0; k < sizeof(double); k++){
+    for (size_t i = 0; i < n; i++) planes[i] = bytes[i*sizeof(double) + k];
+    pack_bytes(&planes[0], n, out);
+  }
+}
+
+bool unpack_doubles(const unsigned char * & p, const unsigned char * end,
+                    vector<unsigned char> & planes, vector<double> & values){
+  size_t n = values.size();
+  unsigned char * bytes = reinterpret_cast<unsigned char*>(&values[0]);
+  planes.resize(n);
+  for (unsigned int k = 0; k < sizeof(double); k++){
+    if (!unpack_bytes(p, end, &planes[0], n)) return false;
+    for (size_t i = 0; i < n; i++) bytes[i*sizeof(double) + k] = planes[i];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+// the number of constituents of a jet, ghosts excluded; the
+// constituents of clustered jets are counted in place in the history
+unsigned int n_real_constituents(const PseudoJet & jet){
+  if (!jet.has_constituents()) return 0;
+  if (!jet.has_associated_cluster_sequence()){
+    vector<PseudoJet> constituents = jet.constituents();
+    if (!jet.has_area()) return constituents.size();
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < constituents.size(); i++){
+      if (!constituents[i].is_pure_ghost()) n++;
+    }
+    return n;
+  }
+  ConstituentView view(jet);
+  if (!jet.has_area()) return view.size();
+  unsigned int n = 0;
+  for (ConstituentView::iterator it = view.begin(); it != view.end(); ++it){
+    if (!it->is_pure_ghost()) n++;
+  }
+  return n;
+}
+
+}
+
+//----------------------------------------------------------------------
+// JetColumns
+//----------------------------------------------------------------------
+void JetColumns::clear(){
+  event.clear(); jet.clear(); n_constituents.clear();
+  pt.clear(); rap.clear(); phi.clear(); m.clear(); area.clear(); pt_sub.clear();
+}
+
+//----------------------------------------------------------------------
+// the columns absent with "flags" are filled with zeros
+void JetColumns::resize(unsigned int n, uint32_t flags){
+  event.resize(n); jet.resize(n); n_constituents.resize(n);
+  pt.resize(n); rap.resize(n); phi.resize(n); m.resize(n);
+  if (flags & jet_format::has_area) area.resize(n);
+  else area.assign(n, 0.0);
+  if (flags & jet_format::has_subtracted) pt_sub.resize(n);
+  else pt_sub.assign(n, 0.0);
+}
+
+//----------------------------------------------------------------------
+// BinaryJetWriter
+//----------------------------------------------------------------------
+BinaryJetWriter::BinaryJetWriter(const string & filename, bool with_area, bool with_subtracted,
+                                 bool compressed, unsigned int max_block_jets)
+  : _filename(filename), _flags(0), _max_block_jets(max_block_jets), _n_jets(0), _n_bytes(0){
+  if (with_area)       _flags |= jet_format::has_area;
+  if (with_subtracted) _flags |= jet_format::has_subtracted;
+  if (compressed)      _flags |= jet_format::compressed;
+
+  _file = (filename == "-") ? stdout : fopen(filename.c_str(), "wb");
+  if (!_file) throw Error("BinaryJetWriter: could not create "+filename);
+
+  jet_format::FileHeader header;
+  memcpy(header.magic, jet_format::magic, sizeof(header.magic));
+  header.version = jet_format::version;
+  header.flags   = _flags;
+  header.byte_order_mark = jet_format::byte_order_mark;
+  header.unused  = 0;
+  _write(&header, sizeof(header));
+}
+
+//----------------------------------------------------------------------
+BinaryJetWriter::~BinaryJetWriter(){
+  // do not throw from the destructor
+  try { close(); } catch (const Error &) {}
+}
+
+//----------------------------------------------------------------------
+void BinaryJetWriter::write(const JetRecord & record){
+  if (!_file) throw Error("BinaryJetWriter: writing to closed file "+_filename);
+
+  _block.event.push_back(record.event);
+  _block.jet.push_back(record.jet);
+  _block.n_constituents.push_back(record.n_constituents);
+  _block.pt.push_back(record.pt);
+  _block.rap.push_back(record.rap);
+  _block.phi.push_back(record.phi);
+  _block.m.push_back(record.m);
+  _block.area.push_back(record.area);
+  _block.pt_sub.push_back(record.pt_sub);
+  _n_jets++;
+
+  if (_block.size() >= _max_block_jets) _flush();
+}
+
+//----------------------------------------------------------------------
+void BinaryJetWriter::write(unsigned long iev, unsigned int ijet, const PseudoJet & jet,
+                            double area, double pt_sub){
+  JetRecord record;
+  record.event = iev;
+  record.jet = ijet;
+  record.n_constituents = n_real_constituents(jet);
+  record.pt  = jet.perp();
+  record.rap = jet.rap();
+  record.phi = jet.phi();
+  record.m   = jet.m();
+  record.area = area;
+  record.pt_sub = pt_sub;
+  write(record);
+}
+
+//----------------------------------------------------------------------
+void BinaryJetWriter::_write(const void * data, size_t size){
+  if (fwrite(data, 1, size, _file) != size)
+    throw Error("BinaryJetWriter: error while writing "+_filename);
+  _n_bytes += size;
+}
+
+//----------------------------------------------------------------------
+void BinaryJetWriter::_flush(){
+  size_t n = _block.size();
+  if (n == 0) return;
+  vector<vector<double>*> doubles = double_columns(_block, _flags);
+
+  jet_format::BlockHeader header;
+  header.n_jets = n;
+  if (_flags & jet_format::compressed){
+    _encoded.clear();
+    uint64_t previous = 0;
+    for (size_t i = 0; i < n; i++){
+      put_varint(_encoded, zigzag(int64_t(_block.event[i] - previous)));
+      previous = _block.event[i];
+    }
+    vector<unsigned char> planes;
+    for (unsigned int icol = 0; icol < doubles.size(); icol++) pack_doubles(*doubles[icol], planes, _encoded);
+    for (size_t i = 0; i < n; i++) put_varint(_encoded, _block.jet[i]);
+    for (size_t i = 0; i < n; i++) put_varint(_encoded, _block.n_constituents[i]);
+    header.n_bytes = _encoded.size();
+    _write(&header, sizeof(header));
+    _write(&_encoded[0], _encoded.size());
+  } else {
+    header.n_bytes = n*(sizeof(uint64_t) + doubles.size()*sizeof(double) + 2*sizeof(uint32_t));
+    _write(&header, sizeof(header));
+    _write(&_block.event[0], n*sizeof(uint64_t));
+    for (unsigned int icol = 0; icol < doubles.size(); icol++) _write(&(*doubles[icol])[0], n*sizeof(double));
+    _write(&_block.jet[0], n*sizeof(uint32_t));
+    _write(&_block.n_constituents[0], n*sizeof(uint32_t));
+  }
+  _block.clear();
+}
+
+//----------------------------------------------------------------------
+void BinaryJetWriter::close(){
+  if (!_file) return;
+  _flush();
+  bool ok = (_file == stdout) ? (fflush(_file) == 0) : (fclose(_file) == 0);
+  _file = 0;
+  if (!ok) throw Error("BinaryJetWriter: error while closing "+_filename);
+}
+
+//----------------------------------------------------------------------
+// BinaryJetReader
+//----------------------------------------------------------------------
+BinaryJetReader::BinaryJetReader(const string & filename)
+  : _filename(filename), _n_jets_read(0), _next_in_block(0){
+  _file = (filename == "-") ? stdin : fopen(filename.c_str(), "rb");
+  if (!_file) throw Error("BinaryJetReader: could not open "+filename);
+
+  jet_format::FileHeader header;
+  if ((fread(&header, sizeof(header), 1, _file) != 1) ||
+      (memcmp(header.magic, jet_format::magic, sizeof(header.magic)) != 0) ||
+      (header.byte_order_mark != jet_format::byte_order_mark) ||
+      (header.version != jet_format::version)){
+    if (_file != stdin) fclose(_file);
+    throw Error("BinaryJetReader: "+filename+" is not a (compatible) binary jet file");
+  }
+  _flags = header.flags;
+}
+
+//----------------------------------------------------------------------
+BinaryJetReader::~BinaryJetReader(){
+  if (_file != stdin) fclose(_file);
+}
+
+//----------------------------------------------------------------------
+void BinaryJetReader::_read(void * data, size_t size){
+  if (fread(data, 1, size, _file) != size)
+    throw Error("BinaryJetReader: "+_filename+" is truncated");
+}
+
+//----------------------------------------------------------------------
+bool BinaryJetReader::next_block(JetColumns & columns){
+  jet_format::BlockHeader header;
+  size_t n_read = fread(&header, 1, sizeof(header), _file);
+  if (n_read == 0) return false;
+  if (n_read != sizeof(header)) throw Error("BinaryJetReader: "+_filename+" is truncated");
+
+  size_t n = header.n_jets;
+  columns.resize(n, _flags);
+  vector<vector<double>*> doubles = double_columns(columns, _flags);
+  if (n == 0) return true;
+
+  if (_flags & jet_format::compressed){
+    _encoded.resize(header.n_bytes);
+    if (header.n_bytes) _read(&_encoded[0], header.n_bytes);
+    const unsigned char * p = header.n_bytes ? &_encoded[0] : 0, * end = p + header.n_bytes;
+    bool ok = true;
+    uint64_t value, previous = 0;
+    for (size_t i = 0; ok && (i < n); i++){
+      ok = get_varint(p, end, value);
+      previous += unzigzag(value);
+      columns.event[i] = previous;
+    }
+    vector<unsigned char> planes;
+    for (unsigned int icol = 0; ok && (icol < doubles.size()); icol++)
+      ok = unpack_doubles(p, end, planes, *doubles[icol]);
+    for (size_t i = 0; ok && (i < n); i++){
+      ok = get_varint(p, end, value);
+      columns.jet[i] = value;
+    }
+    for (size_t i = 0; ok && (i < n); i++){
+      ok = get_varint(p, end, value);
+      columns.n_constituents[i] = value;
+    }
+    if (!ok || (p != end)) throw Error("BinaryJetReader: corrupted block in "+_filename);
+  } else {
+    if (header.n_bytes != n*(sizeof(uint64_t) + doubles.size()*sizeof(double) + 2*sizeof(uint32_t)))
+      throw Error("BinaryJetReader: corrupted block in "+_filename);
+    _read(&columns.event[0], n*sizeof(uint64_t));
+    for (unsigned int icol = 0; icol < doubles.size(); icol++) _read(&(*doubles[icol])[0], n*sizeof(double));
+    _read(&columns.jet[0], n*sizeof(uint32_t));
+    _read(&columns.n_constituents[0], n*sizeof(uint32_t));
+  }
+  _n_jets_read += n;
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool BinaryJetReader::next(JetRecord & record){
+  while (_next_in_block >= _block.size()){
+    // next_block() counts the whole block as read: undo that, as
+    // next() counts the jets one at a time
+    if (!next_block(_block)) return false;
+    _n_jets_read -= _block.size();
+    _next_in_block = 0;
+  }
+  unsigned int i = _next_in_block++;
+  record.event = _block.event[i];
+  record.jet = _block.jet[i];
+  record.n_constituents = _block.n_constituents[i];
+  record.pt  = _block.pt[i];
+  record.rap = _block.rap[i];
+  record.phi = _block.phi[i];
+  record.m   = _block.m[i];
+  record.area = _block.area[i];
+  record.pt_sub = _block.pt_sub[i];
+  _n_jets_read++;
+  return true;
+}
+
+} // namespace fcc
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------
+/// \file
+/// Binary, column-wise storage of jets, in place of the printed
+/// per-jet tables
+///
+/// The layout of a file is
+///
+///   header   : char magic[8] = "FCCJET01"
+///              uint32 version, uint32 flags, uint32 byte-order mark,
+///              uint32 (unused)
+///   block 0  : uint64 n_jets, uint64 n_bytes (of the columns below)
+///              uint64 event[n_jets]
+///              double pt[n_jets], rap[...], phi[...], m[...]
+///              double area[n_jets]     (if flags & has_area)
+///              double pt_sub[n_jets]   (if flags & has_subtracted)
+///              uint32 jet[n_jets], n_constituents[n_jets]
+///   block 1  : ...
+///
+/// With flags & compressed, the columns of a block are stored in the
+/// same order but encoded: event as varints of the difference with
+/// the previous jet's event (zigzag-coded), jet and n_constituents as
+/// varints, and each double column as its 8 byte planes (byte k of
+/// every value, then byte k+1, ...), each run-length coded. Jets come
+/// in order within an event, so the integer columns mostly take one
+/// byte per jet, and the sign/exponent planes of the doubles mostly
+/// collapse into runs. This is lossless.
+///
+/// As for binary event files, numbers are in the native byte order of
+/// the machine that wrote the file (other byte orders are rejected).
+//----------------------------------------------------------------------
+#ifndef __FCC_BINARYJETFILE_HH__
+#define __FCC_BINARYJETFILE_HH__
+
+#include "fastjet/PseudoJet.hh"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace fcc {
+
+namespace jet_format {
+  /// the magic string at the start of every binary jet file
+  const char magic[8] = {'F','C','C','J','E','T','0','1'};
+  const uint32_t version = 1;
+  const uint32_t byte_order_mark = 0x01020304;
+
+  /// flags describing the optional columns and the encoding
+  enum Flags { has_area = 1, has_subtracted = 2, compressed = 4 };
+
+  struct FileHeader {
+    char     magic[8];
+    uint32_t version, flags, byte_order_mark, unused;
+  };
+
+  struct BlockHeader {
+    uint64_t n_jets, n_bytes;
+  };
+}
+
+/// one jet (area and pt_sub are 0 if the file does not have them)
+struct JetRecord {
+  uint64_t event;
+  uint32_t jet, n_constituents;
+  double pt, rap, phi, m, area, pt_sub;
+};
+
+/// the columns of a block of jets
+struct JetColumns {
+  std::vector<uint64_t> event;
+  std::vector<uint32_t> jet, n_constituents;
+  std::vector<double> pt, rap, phi, m, area, pt_sub;
+
+  unsigned int size() const { return event.size(); }
+  void clear();
+  void resize(unsigned int n, uint32_t flags);
+};
+
+/// \class BinaryJetWriter
+/// writes jets to a binary jet file
+///
+/// Jets are accumulated column-wise in memory and written out (and
+/// compressed, if asked for) a block of max_block_jets at a time.
+class BinaryJetWriter {
+public:
+  /// create the file ("-" is the standard output), with or without
+  /// the area and subtracted-pt columns
+  BinaryJetWriter(const std::string & filename, bool with_area, bool with_subtracted,
+                  bool compressed = false, unsigned int max_block_jets = 1 << 16);
+
+  /// flushes and closes the file
+  ~BinaryJetWriter();
+
+  bool has_area()       const { return _flags & jet_format::has_area; }
+  bool has_subtracted() const { return _flags & jet_format::has_subtracted; }
+  bool compressed()     const { return _flags & jet_format::compressed; }
+
+  /// add one jet
+  void write(const JetRecord & record);
+
+  /// add jet number ijet of event iev, with its pt, rapidity, phi,
+  /// mass and number of constituents (ghosts excluded)
+  void write(unsigned long iev, unsigned int ijet, const fastjet::PseudoJet & jet,
+             double area = 0.0, double pt_sub = 0.0);
+
+  /// write out the pending block and close the file
+  void close();
+
+  /// number of jets written so far, and bytes written to the file
+  unsigned long n_jets() const { return _n_jets; }
+  unsigned long n_bytes() const { return _n_bytes; }
+
+protected:
+  void _flush();
+  void _write(const void * data, size_t size);
+
+  std::string _filename;
+  FILE * _file;
+  uint32_t _flags;
+  unsigned int _max_block_jets;
+  unsigned long _n_jets, _n_bytes;
+  JetColumns _block;
+  std::vector<unsigned char> _encoded;
+
+private:
+  BinaryJetWriter(const BinaryJetWriter &);
+  BinaryJetWriter & operator=(const BinaryJetWriter &);
+};
+
+/// \class BinaryJetReader
+/// sequential reading of a binary jet file, a block or a jet at a time
+class BinaryJetReader {
+public:
+  /// open "filename" ("-" is the standard input)
+  BinaryJetReader(const std::string & filename);
+  ~BinaryJetReader();
+
+  bool has_area()       const { return _flags & jet_format::has_area; }
+  bool has_subtracted() const { return _flags & jet_format::has_subtracted; }
+  bool compressed()     const { return _flags & jet_format::compressed; }
+
+  /// read the next block into "columns"; false at the end of the file
+  bool next_block(JetColumns & columns);
+
+  /// the next jet; false at the end of the file
+  bool next(JetRecord & record);
+
+  /// number of jets read so far
+  unsigned long n_jets_read() const { return _n_jets_read; }
+
+protected:
+  void _read(void * data, size_t size);
+
+  std::string _filename;
+  FILE * _file;
+  uint32_t _flags;
+  unsigned long _n_jets_read;
+  std::vector<unsigned char> _encoded;
+  JetColumns _block;        ///< for next()
+  unsigned int _next_in_block;
+
+private:
+  BinaryJetReader(const BinaryJetReader &);
+  BinaryJetReader & operator=(const BinaryJetReader &);
+};
+
+} // namespace fcc
+
+#endif // __FCC_BINARYJETFILE_HH__
@@ -0,0 +1,471 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::ClusteringCache
+//----------------------------------------------------------------------
+#include "fcc/ClusteringCache.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+const char magic[8] = {'F','C','C','C','S','0','0','1'};
+const uint32_t version = 1;
+const uint32_t byte_order_mark = 0x01020304;
+const char * const extension = ".fcs";
+
+/// when entries have to be evicted, the directory is brought down to
+/// this fraction of its bound (so that evictions are not needed again
+/// for every new entry)
+const double low_water_mark = 0.9;
+
+struct Header {
+  char     magic[8];
+  uint32_t version, byte_order_mark;
+  uint64_t key[2];
+  uint32_t n_particles, n_ghosts, n_steps, description_length;
+  double   ghost_area;
+};
+
+size_t padded(size_t bytes) { return (bytes+7)/8*8; }
+
+/// the size of an entry
+size_t entry_size(size_t description_length, size_t n_steps, size_t n_ghosts){
+  return sizeof(Header) + padded(description_length)
+    + n_steps*(sizeof(double) + 2*sizeof(int32_t)) + 4*n_ghosts*sizeof(double);
+}
+
+//----------------------------------------------------------------------
+/// two independent 64-bit hashes of a stream of 64-bit words
+class Hasher {
+public:
+  Hasher() : _a(0x243f6a8885a308d3ull), _b(0x13198a2e03707344ull), _n(0) {}
+
+  void add(uint64_t word){
+    _a = mix(_a ^ word);
+    _b = mix(_b + word*0x9e3779b97f4a7c15ull + (++_n));
+  }
+  void add(double x){
+    uint64_t word;
+    memcpy(&word, &x, sizeof(word));
+    add(word);
+  }
+  void add(const string & text){
+    add(uint64_t(text.size()));
+    for (size_t i = 0; i < text.size(); i += 8){
+      uint64_t word = 0;
+      memcpy(&word, text.data() + i, min(size_t(8), text.size() - i));
+      add(word);
+    }
+  }
+
+  uint64_t a() const { return mix(_a ^ _n); }
+  uint64_t b() const { return mix(_b ^ _a); }
+
+private:
+  /// the splitmix64 finaliser
+  static uint64_t mix(uint64_t x){
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+  }
+  uint64_t _a, _b, _n;
+};
+
+void key_words(const vector<PseudoJet> & particles, const string & description, uint64_t words[2]){
+  Hasher hasher;
+  hasher.add(description);
+  hasher.add(uint64_t(particles.size()));
+  for (unsigned int i = 0; i < particles.size(); i++){
+    hasher.add(particles[i].px());
+    hasher.add(particles[i].py());
+    hasher.add(particles[i].pz());
+    hasher.add(particles[i].E());
+  }
+  words[0] = hasher.a();
+  words[1] = hasher.b();
+}
+
+string hex(const uint64_t words[2]){
+  char text[33];
+  snprintf(text, sizeof(text), "%016llx%016llx",
+           (unsigned long long)(words[0]), (unsigned long long)(words[1]));
+  return text;
+}
+
+//----------------------------------------------------------------------
+/// the plugin that records the steps of a cache entry into a
+/// ClusterSequence, posing as the jet definition they came from
+class ReplayPlugin : public JetDefinition::Plugin {
+public:
+  ReplayPlugin(const JetDefinition & jet_def)
+    : _description(jet_def.description()), _R(jet_def.R()), _n_steps(0), _dij(0), _jet1(0), _jet2(0){
+    JetAlgorithm algorithm = jet_def.jet_algorithm();
+    if (algorithm == plugin_algorithm){
+      _exclusive_meaningful = jet_def.plugin()->exclusive_sequence_meaningful();
+      _spherical = jet_def.plugin()->is_spherical();
+      return;
+    }
+    bool genkt = (algorithm == genkt_algorithm) || (algorithm == ee_genkt_algorithm) ||
+                 (algorithm == genkt_for_passive_algorithm);
+    _exclusive_meaningful = (algorithm != antikt_algorithm) && !(genkt && (jet_def.extra_param() < 0));
+    _spherical = (algorithm == ee_kt_algorithm) || (algorithm == ee_genkt_algorithm);
+  }
+
+  /// the steps to record (only used while the ClusterSequence is
+  /// being built)
+  void set_steps(unsigned int n_steps, const double * dij, const int32_t * jet1, const int32_t * jet2){
+    _n_steps = n_steps;
+    _dij = dij;
+    _jet1 = jet1;
+    _jet2 = jet2;
+  }
+
+  virtual string description() const { return _description; }
+  virtual double R() const { return _R; }
+  virtual bool exclusive_sequence_meaningful() const { return _exclusive_meaningful; }
+  virtual bool is_spherical() const { return _spherical; }
+
+  virtual void run_clustering(ClusterSequence & cs) const{
+    for (unsigned int i = 0; i < _n_steps; i++){
+      if (_jet2[i] < 0){
+        cs.plugin_record_iB_recombination(_jet1[i], _dij[i]);
+      } else {
+        int k;
+        cs.plugin_record_ij_recombination(_jet1[i], _jet2[i], _dij[i], k);
+      }
+    }
+  }
+
+private:
+  string _description;
+  double _R;
+  bool _exclusive_meaningful, _spherical;
+  unsigned int _n_steps;
+  const double * _dij;
+  const int32_t *_jet1, *_jet2;
+};
+
+} // anonymous namespace
+
+//----------------------------------------------------------------------
+/// a memory-mapped cache entry
+class ClusteringCache::Entry {
+public:
+  /// map the entry at "path" if there is one
+  Entry(const string & path) : _map(0), _map_size(0), _header(0){
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat info;
+    if ((fstat(fd, &info) == 0) && (size_t(info.st_size) >= sizeof(Header))){
+      void * map = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED){
+        _map = static_cast<char*>(map);
+        _map_size = info.st_size;
+        _header = reinterpret_cast<const Header*>(_map);
+      }
+    }
+    ::close(fd);
+  }
+  ~Entry(){ if (_map) munmap(_map, _map_size); }
+
+  /// true if the entry is complete and is the clustering of these
+  /// particles with this description
+  bool matches(const uint64_t key[2], const string & description, unsigned int n_particles) const{
+    if (!_header) return false;
+    const Header & h = *_header;
+    return (memcmp(h.magic, magic, sizeof(magic)) == 0) && (h.version == version) &&
+      (h.byte_order_mark == byte_order_mark) && (h.key[0] == key[0]) && (h.key[1] == key[1]) &&
+      (h.n_particles == n_particles) && (h.description_length == description.size()) &&
+      (_map_size == entry_size(h.description_length, h.n_steps, h.n_ghosts)) &&
+      (memcmp(_map + sizeof(Header), description.data(), description.size()) == 0);
+  }
+
+  unsigned int n_steps() const { return _header->n_steps; }
+  unsigned int n_ghosts() const { return _header->n_ghosts; }
+  double ghost_area() const { return _header->ghost_area; }
+
+  const double * dij() const {
+    return reinterpret_cast<const double*>(_map + sizeof(Header) + padded(_header->description_length));
+  }
+  const int32_t * jet1() const { return reinterpret_cast<const int32_t*>(dij() + n_steps()); }
+  const int32_t * jet2() const { return jet1() + n_steps(); }
+
+  /// true if every stored step only refers to jets that exist and
+  /// have not been merged yet when it is replayed, starting from
+  /// "n_initial" particles (ghosts included); anything else would
+  /// trip the checks inside ClusterSequence
+  bool steps_valid(unsigned int n_initial) const {
+    const int32_t * j1 = jet1(), * j2 = jet2();
+    vector<bool> merged(n_initial + n_steps(), false);
+    unsigned int n_jets = n_initial;
+    for (unsigned int i = 0; i < n_steps(); i++){
+      if ((j1[i] < 0) || (unsigned(j1[i]) >= n_jets) || merged[j1[i]]) return false;
+      merged[j1[i]] = true;
+      if (j2[i] == -1) continue;
+      if ((j2[i] < 0) || (unsigned(j2[i]) >= n_jets) || merged[j2[i]]) return false;
+      merged[j2[i]] = true;
+      n_jets++;
+    }
+    return true;
+  }
+
+  /// the stored ghosts
+  vector<PseudoJet> ghosts() const {
+    const double * px = reinterpret_cast<const double*>(jet2() + n_steps());
+    const double * py = px + n_ghosts(), * pz = py + n_ghosts(), * E = pz + n_ghosts();
+    vector<PseudoJet> ghosts;
+    ghosts.reserve(n_ghosts());
+    for (unsigned int i = 0; i < n_ghosts(); i++) ghosts.push_back(PseudoJet(px[i], py[i], pz[i], E[i]));
+    return ghosts;
+  }
+
+private:
+  char * _map;
+  size_t _map_size;
+  const Header * _header;
+
+  Entry(const Entry &);
+  Entry & operator=(const Entry &);
+};
+
+//----------------------------------------------------------------------
+ClusteringCache::ClusteringCache(const string & directory, unsigned long max_bytes)
+  : _directory(directory), _max_bytes(max_bytes), _size_bytes(0),
+    _n_hits(0), _n_misses(0), _n_evictions(0){
+  if ((mkdir(directory.c_str(), 0755) != 0) && (errno != EEXIST))
+    throw Error("ClusteringCache: could not create "+directory);
+  _scan();
+}
+
+//----------------------------------------------------------------------
+string ClusteringCache::description() const{
+  ostringstream oss;
+  oss << "clustering cache in " << _directory << " (" << _entries.size() << " entries, "
+      << _size_bytes/1048576.0 << " of at most " << _max_bytes/1048576.0 << " MB)";
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+string ClusteringCache::key(const vector<PseudoJet> & particles, const string & description){
+  uint64_t words[2];
+  key_words(particles, description, words);
+  return hex(words);
+}
+
+//----------------------------------------------------------------------
+string ClusteringCache::_path(const string & key) const{
+  return _directory + "/" + key + extension;
+}
+
+//----------------------------------------------------------------------
+unique_ptr<ClusterSequence> ClusteringCache::cluster(const vector<PseudoJet> & particles,
+                                                     const JetDefinition & jet_def){
+  string description = jet_def.description();
+  uint64_t words[2];
+  key_words(particles, description, words);
+  string key = hex(words);
+  {
+    Entry entry(_path(key));
+    if (entry.matches(words, description, particles.size()) && (entry.n_ghosts() == 0) &&
+        entry.steps_valid(particles.size())){
+      _n_hits++;
+      ReplayPlugin * plugin = new ReplayPlugin(jet_def);
+      plugin->set_steps(entry.n_steps(), entry.dij(), entry.jet1(), entry.jet2());
+      JetDefinition replay_def(plugin);
+      replay_def.set_recombiner(jet_def);
+      replay_def.delete_plugin_when_unused();
+      unique_ptr<ClusterSequence> cs(new ClusterSequence(particles, replay_def));
+      plugin->set_steps(0, 0, 0, 0);
+      _touch(key);
+      return cs;
+    }
+  }
+
+  _n_misses++;
+  unique_ptr<ClusterSequence> cs(new ClusterSequence(particles, jet_def));
+  _store(words, description, *cs, particles.size(), 0.0);
+  return cs;
+}
+
+//----------------------------------------------------------------------
+unique_ptr<ClusterSequenceActiveAreaExplicitGhosts>
+ClusteringCache::cluster(const vector<PseudoJet> & particles, const JetDefinition & jet_def,
+                         const AreaDefinition & area_def){
+  AreaType type = area_def.area_type();
+  if (!((type == active_area_explicit_ghosts) || ((type == active_area) && (area_def.ghost_spec().repeat() == 1))))
+    throw Error("ClusteringCache: only active areas with a single set of ghosts can be cached");
+
+  string description = jet_def.description() + "; " + area_def.description();
+  uint64_t words[2];
+  key_words(particles, description, words);
+  string key = hex(words);
+  {
+    Entry entry(_path(key));
+    if (entry.matches(words, description, particles.size()) &&
+        entry.steps_valid(particles.size() + entry.n_ghosts())){
+      _n_hits++;
+      ReplayPlugin * plugin = new ReplayPlugin(jet_def);
+      plugin->set_steps(entry.n_steps(), entry.dij(), entry.jet1(), entry.jet2());
+      JetDefinition replay_def(plugin);
+      replay_def.set_recombiner(jet_def);
+      replay_def.delete_plugin_when_unused();
+      unique_ptr<ClusterSequenceActiveAreaExplicitGhosts>
+        cs(new ClusterSequenceActiveAreaExplicitGhosts(particles, replay_def, entry.ghosts(), entry.ghost_area()));
+      plugin->set_steps(0, 0, 0, 0);
+      _touch(key);
+      return cs;
+    }
+  }
+
+  _n_misses++;
+  unique_ptr<ClusterSequenceActiveAreaExplicitGhosts>
+    cs(new ClusterSequenceActiveAreaExplicitGhosts(particles, jet_def, area_def.ghost_spec()));
+  _store(words, description, *cs, particles.size(), area_def.ghost_spec().actual_ghost_area());
+  return cs;
+}
+
+//----------------------------------------------------------------------
+// the history elements after the initial particles (and ghosts) are
+// written as (dij, jet1, jet2), with the jets of their parents
+void ClusteringCache::_store(const uint64_t words[2], const string & description,
+                             const ClusterSequence & cs, unsigned int n_particles, double ghost_area){
+  string key = hex(words);
+  const vector<ClusterSequence::history_element> & history = cs.history();
+  const vector<PseudoJet> & jets = cs.jets();
+  unsigned int n_initial = cs.n_particles(), n_steps = history.size() - n_initial;
+  unsigned int n_ghosts = n_initial - n_particles;
+  size_t bytes = entry_size(description.size(), n_steps, n_ghosts);
+  if (bytes > _max_bytes) return;
+  _make_room(bytes);
+
+  vector<char> buffer(bytes, 0);
+  Header * header = reinterpret_cast<Header*>(&buffer[0]);
+  memcpy(header->magic, magic, sizeof(magic));
+  header->version = version;
+  header->byte_order_mark = byte_order_mark;
+  header->key[0] = words[0];
+  header->key[1] = words[1];
+  header->n_particles = n_particles;
+  header->n_ghosts = n_ghosts;
+  header->n_steps = n_steps;
+  header->description_length = description.size();
+  header->ghost_area = ghost_area;
+  memcpy(&buffer[sizeof(Header)], description.data(), description.size());
+
+  double * dij = reinterpret_cast<double*>(&buffer[sizeof(Header) + padded(description.size())]);
+  int32_t * jet1 = reinterpret_cast<int32_t*>(dij + n_steps), * jet2 = jet1 + n_steps;
+  for (unsigned int i = 0; i < n_steps; i++){
+    const ClusterSequence::history_element & step = history[n_initial + i];
+    dij[i]  = step.dij;
+    jet1[i] = history[step.parent1].jetp_index;
+    jet2[i] = (step.parent2 == ClusterSequence::BeamJet) ? -1 : history[step.parent2].jetp_index;
+  }
+  double * px = reinterpret_cast<double*>(jet2 + n_steps);
+  double * py = px + n_ghosts, * pz = py + n_ghosts, * E = pz + n_ghosts;
+  for (unsigned int i = 0; i < n_ghosts; i++){
+    const PseudoJet & ghost = jets[n_particles + i];
+    px[i] = ghost.px();
+    py[i] = ghost.py();
+    pz[i] = ghost.pz();
+    E[i]  = ghost.E();
+  }
+
+  // written aside and renamed, so that no reader sees a partial entry
+  ostringstream temporary;
+  temporary << _path(key) << ".tmp." << getpid();
+  FILE * file = fopen(temporary.str().c_str(), "wb");
+  if (!file) throw Error("ClusteringCache: could not create "+temporary.str());
+  bool ok = (fwrite(&buffer[0], 1, bytes, file) == bytes);
+  ok = (fclose(file) == 0) && ok;
+  ok = ok && (rename(temporary.str().c_str(), _path(key).c_str()) == 0);
+  if (!ok){
+    remove(temporary.str().c_str());
+    throw Error("ClusteringCache: error while writing "+_path(key));
+  }
+
+  map<string, EntryInfo>::iterator existing = _entries.find(key);
+  if (existing != _entries.end()) _size_bytes -= existing->second.bytes;
+  EntryInfo & info = _entries[key];
+  info.bytes = bytes;
+  info.last_used = time(0);
+  _size_bytes += bytes;
+}
+
+//----------------------------------------------------------------------
+// remove the least recently used entries until "bytes" more fit
+// within the low-water mark
+void ClusteringCache::_make_room(unsigned long bytes){
+  if (_size_bytes + bytes <= _max_bytes) return;
+  vector<pair<time_t, string> > by_age;
+  for (map<string, EntryInfo>::const_iterator it = _entries.begin(); it != _entries.end(); it++)
+    by_age.push_back(make_pair(it->second.last_used, it->first));
+  sort(by_age.begin(), by_age.end());
+  double target = low_water_mark * _max_bytes;
+  for (unsigned int i = 0; (i < by_age.size()) && (_size_bytes + bytes > target); i++){
+    remove(_path(by_age[i].second).c_str());
+    _size_bytes -= _entries[by_age[i].second].bytes;
+    _entries.erase(by_age[i].second);
+    _n_evictions++;
+  }
+}
+
+//----------------------------------------------------------------------
+void ClusteringCache::_touch(const string & key){
+  utime(_path(key).c_str(), 0);
+  map<string, EntryInfo>::iterator it = _entries.find(key);
+  if (it == _entries.end()){
+    // written by another process since the directory was scanned
+    struct stat info;
+    if (stat(_path(key).c_str(), &info) != 0) return;
+    it = _entries.insert(make_pair(key, EntryInfo())).first;
+    it->second.bytes = info.st_size;
+    _size_bytes += info.st_size;
+  }
+  it->second.last_used = time(0);
+}
+
+//----------------------------------------------------------------------
+void ClusteringCache::_scan(){
+  _entries.clear();
+  _size_bytes = 0;
+  DIR * dir = opendir(_directory.c_str());
+  if (!dir) throw Error("ClusteringCache: could not read "+_directory);
+  size_t extension_length = strlen(extension);
+  while (struct dirent * item = readdir(dir)){
+    string name = item->d_name;
+    if ((name.size() != 32 + extension_length) || (name.compare(32, extension_length, extension) != 0)) continue;
+    struct stat info;
+    if (stat((_directory + "/" + name).c_str(), &info) != 0) continue;
+    EntryInfo & entry = _entries[name.substr(0, 32)];
+    entry.bytes = info.st_size;
+    entry.last_used = info.st_mtime;
+    _size_bytes += info.st_size;
+  }
+  closedir(dir);
+}
+
+//----------------------------------------------------------------------
+void ClusteringCache::clear(){
+  for (map<string, EntryInfo>::const_iterator it = _entries.begin(); it != _entries.end(); it++)
+    remove(_path(it->first).c_str());
+  _entries.clear();
+  _size_bytes = 0;
+}
+
+} // namespace fcc
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------
+/// \file
+/// An on-disk cache of clustering results, keyed by the content of
+/// the event and the jet (and area) definition
+///
+/// Every entry is one file, named after the 128-bit key, laid out as
+///
+///   header      : char magic[8] = "FCCCS001"
+///                 uint32 version, uint32 byte-order mark,
+///                 uint64 key[2],
+///                 uint32 n_particles, uint32 n_ghosts, uint32 n_steps,
+///                 uint32 description length, double ghost area
+///   description : the jet (and area) definition, padded to 8 bytes
+///   steps       : double dij[n_steps]
+///                 int32 jet1[n_steps], int32 jet2[n_steps] (-1 for a
+///                 recombination with the beam)
+///   ghosts      : double px[n_ghosts], py[...], pz[...], E[...]
+///
+/// jet1 and jet2 are indices in ClusterSequence::jets(), so that the
+/// steps can be handed back to plugin_record_ij_recombination() and
+/// plugin_record_iB_recombination() as they are. As for binary event
+/// files, numbers are in the native byte order and every column is
+/// 8-byte aligned, so that a memory-mapped entry is used in place.
+//----------------------------------------------------------------------
+#ifndef __FCC_CLUSTERINGCACHE_HH__
+#define __FCC_CLUSTERINGCACHE_HH__
+
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace fcc {
+
+/// \class ClusteringCache
+/// clustering results stored in a directory, rebuilt without
+/// reclustering when the same event is clustered again with the same
+/// definitions
+///
+/// The key hashes the four-momenta of the particles, in order, and
+/// jet_def.description() (plus area_def.description() for areas). An
+/// entry holds the recombination steps of the clustering (and the
+/// ghosts, for areas). On a hit, the entry is memory-mapped and its
+/// steps are replayed into a new ClusterSequence through a plugin, so
+/// that inclusive_jets(), exclusive_jets(), constituents() and the
+/// rest of the ClusterSequence interface give the results of the
+/// original clustering. The particles passed in are used as they are,
+/// with their user indices and user info. The jet definition of the
+/// rebuilt sequence is a plugin with the same description, R and
+/// recombiner as the original.
+///
+/// Areas are cached for active areas with one set of ghosts
+/// (active_area_explicit_ghosts, or active_area with one repetition).
+/// The ghosts are stored with the steps, and the sequence is rebuilt
+/// as a ClusterSequenceActiveAreaExplicitGhosts on them.
+///
+/// The directory is bounded to max_bytes: when a new entry would
+/// exceed it, the least recently used entries are removed. Hits
+/// refresh the modification time of their file, which serves as the
+/// last-use time. Entries are written to a temporary file and renamed
+/// into place, so that several processes may share a directory.
+/// A ClusteringCache object itself must not be used by several
+/// threads at once.
+class ClusteringCache {
+public:
+  /// use (and create if needed) "directory"
+  ClusteringCache(const std::string & directory, unsigned long max_bytes = 1ul << 30);
+
+  std::string description() const;
+
+  /// the clustering of "particles" with jet_def, from the cache if
+  /// present (and stored in it otherwise)
+  std::unique_ptr<fastjet::ClusterSequence>
+  cluster(const std::vector<fastjet::PseudoJet> & particles, const fastjet::JetDefinition & jet_def);
+
+  /// the same with active areas
+  std::unique_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>
+  cluster(const std::vector<fastjet::PseudoJet> & particles, const fastjet::JetDefinition & jet_def,
+          const fastjet::AreaDefinition & area_def);
+
+  /// the size bound, and the size of the entries currently known
+  unsigned long max_bytes() const { return _max_bytes; }
+  unsigned long size_bytes() const { return _size_bytes; }
+  unsigned long n_entries() const { return _entries.size(); }
+
+  /// the lookups so far
+  unsigned long n_hits() const { return _n_hits; }
+  unsigned long n_misses() const { return _n_misses; }
+  unsigned long n_evictions() const { return _n_evictions; }
+
+  /// remove every entry
+  void clear();
+
+  /// the 128-bit key of a clustering, as 32 hex digits
+  static std::string key(const std::vector<fastjet::PseudoJet> & particles, const std::string & description);
+
+private:
+  /// a mapped entry
+  class Entry;
+
+  void _scan();
+  void _store(const uint64_t key[2], const std::string & description,
+              const fastjet::ClusterSequence & cs, unsigned int n_particles, double ghost_area);
+  void _make_room(unsigned long bytes);
+  void _touch(const std::string & key);
+  std::string _path(const std::string & key) const;
+
+  std::string _directory;
+  unsigned long _max_bytes, _size_bytes;
+  unsigned long _n_hits, _n_misses, _n_evictions;
+
+  /// size and last use of every entry
+  struct EntryInfo {
+    unsigned long bytes;
+    std::time_t last_used;
+  };
+  std::map<std::string, EntryInfo> _entries;
+};
+
+} // namespace fcc
+
+#endif // __FCC_CLUSTERINGCACHE_HH__
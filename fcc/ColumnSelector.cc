@@ -0,0 +1,196 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::ColumnSelector and fcc::ColumnSelection
+//----------------------------------------------------------------------
+#include "fcc/ColumnSelector.hh"
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+void SelectionMask::assign(unsigned int n, bool value){
+  _n = n;
+  _words.assign((n+63)/64, value ? ~uint64_t(0) : uint64_t(0));
+  if (value && (n & 63)) _words.back() = (uint64_t(1) << (n & 63)) - 1;
+}
+
+unsigned int SelectionMask::count() const{
+  unsigned int n = 0;
+  for (unsigned int w = 0; w < _words.size(); w++) n += __builtin_popcountll(_words[w]);
+  return n;
+}
+
+SelectionMask & SelectionMask::operator&=(const SelectionMask & other){
+  for (unsigned int w = 0; w < _words.size(); w++) _words[w] &= other._words[w];
+  return *this;
+}
+
+SelectionMask & SelectionMask::operator|=(const SelectionMask & other){
+  for (unsigned int w = 0; w < _words.size(); w++) _words[w] |= other._words[w];
+  return *this;
+}
+
+void SelectionMask::flip(){
+  for (unsigned int w = 0; w < _words.size(); w++) _words[w] = ~_words[w];
+  if (_n & 63) _words.back() &= (uint64_t(1) << (_n & 63)) - 1;
+}
+
+//----------------------------------------------------------------------
+// the expression tree: a comparison of one column with a value, or a
+// combination of one or two sub-expressions
+struct ColumnSelector::Node {
+  enum Kind { vertex, pdg_id, charged, and_, or_, not_ };
+  Node(Kind kind_in, int value_in = 0) : kind(kind_in), value(value_in) {}
+  Kind kind;
+  int value;
+  shared_ptr<const Node> left, right;
+};
+
+ColumnSelector ColumnSelector::vertex_number(int vertex_number){
+  return ColumnSelector(make_shared<Node>(Node::vertex, vertex_number));
+}
+
+ColumnSelector ColumnSelector::pdg_id(int pdg_id){
+  return ColumnSelector(make_shared<Node>(Node::pdg_id, pdg_id));
+}
+
+ColumnSelector ColumnSelector::charged(){
+  return ColumnSelector(make_shared<Node>(Node::charged));
+}
+
+ColumnSelector ColumnSelector::operator&&(const ColumnSelector & other) const{
+  shared_ptr<Node> node = make_shared<Node>(Node::and_);
+  node->left = _node;
+  node->right = other._node;
+  return ColumnSelector(node);
+}
+
+ColumnSelector ColumnSelector::operator||(const ColumnSelector & other) const{
+  shared_ptr<Node> node = make_shared<Node>(Node::or_);
+  node->left = _node;
+  node->right = other._node;
+  return ColumnSelector(node);
+}
+
+ColumnSelector ColumnSelector::operator!() const{
+  shared_ptr<Node> node = make_shared<Node>(Node::not_);
+  node->left = _node;
+  return ColumnSelector(node);
+}
+
+//----------------------------------------------------------------------
+string ColumnSelector::description() const{
+  return _description(*_node);
+}
+
+string ColumnSelector::_description(const Node & node){
+  ostringstream oss;
+  switch (node.kind){
+  case Node::vertex:  oss << "vertex number " << node.value; break;
+  case Node::pdg_id:  oss << "PDG id " << node.value; break;
+  case Node::charged: oss << "charged"; break;
+  case Node::and_: oss << "(" << _description(*node.left) << " && " << _description(*node.right) << ")"; break;
+  case Node::or_:  oss << "(" << _description(*node.left) << " || " << _description(*node.right) << ")"; break;
+  case Node::not_: oss << "!" << _description(*node.left); break;
+  }
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+namespace {
+
+// bit i of the mask set when column[i] == value (or != value)
+template<bool equal>
+void compare(const vector<int> & column, int value, SelectionMask & mask){
+  unsigned int n = column.size();
+  mask.assign(n, false);
+  vector<uint64_t> & words = mask.words();
+  const int * v = column.data();
+  for (unsigned int w = 0; w < words.size(); w++, v += 64){
+    unsigned int n_bits = min(64u, n - 64*w);
+    uint64_t bits = 0;
+    for (unsigned int b = 0; b < n_bits; b++)
+      bits |= uint64_t(equal ? (v[b] == value) : (v[b] != value)) << b;
+    words[w] = bits;
+  }
+}
+
+}
+
+void ColumnSelector::evaluate(const Columns & columns, SelectionMask & mask) const{
+  _evaluate(*_node, columns, mask);
+}
+
+void ColumnSelector::_evaluate(const Node & node, const Columns & columns, SelectionMask & mask){
+  switch (node.kind){
+  case Node::vertex:  compare<true> (columns.vertex, node.value, mask); return;
+  case Node::pdg_id:  compare<true> (columns.pdg_id, node.value, mask); return;
+  case Node::charged: compare<false>(columns.charge, 0, mask);          return;
+  case Node::not_:
+    _evaluate(*node.left, columns, mask);
+    mask.flip();
+    return;
+  case Node::and_:
+  case Node::or_: {
+    SelectionMask right;
+    _evaluate(*node.left,  columns, mask);
+    _evaluate(*node.right, columns, right);
+    if (node.kind == Node::and_) mask &= right;
+    else                         mask |= right;
+    return;
+  }
+  }
+}
+
+//----------------------------------------------------------------------
+// one gather of the metadata for all the selectors
+void ColumnSelection::evaluate(const vector<PseudoJet> & particles){
+  _particles = &particles;
+  unsigned int n = particles.size();
+  _columns.pdg_id.resize(n);
+  _columns.vertex.resize(n);
+  _columns.charge.resize(n);
+  _valid.assign(n, true);
+  for (unsigned int i = 0; i < n; i++){
+    int index = particles[i].user_index();
+    if (index < 0){
+      _columns.pdg_id[i] = _columns.vertex[i] = _columns.charge[i] = -1;
+      _valid.words()[i >> 6] &= ~(uint64_t(1) << (i & 63));
+      continue;
+    }
+    _columns.pdg_id[i] = _info.pdg_id(index);
+    _columns.vertex[i] = _info.vertex(index);
+    _columns.charge[i] = _info.charge(index);
+  }
+
+  for (unsigned int k = 0; k < _selectors.size(); k++){
+    _selectors[k].evaluate(_columns, _masks[k]);
+    _masks[k] &= _valid;
+  }
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> ColumnSelection::selected(unsigned int k) const{
+  vector<PseudoJet> result;
+  const vector<uint64_t> & words = _masks[k].words();
+  for (unsigned int w = 0; w < words.size(); w++){
+    for (uint64_t bits = words[w]; bits; bits &= bits-1)
+      result.push_back((*_particles)[64*w + __builtin_ctzll(bits)]);
+  }
+  return result;
+}
+
+PseudoJet ColumnSelection::sum(unsigned int k) const{
+  PseudoJet result(0.0, 0.0, 0.0, 0.0);
+  const vector<uint64_t> & words = _masks[k].words();
+  for (unsigned int w = 0; w < words.size(); w++){
+    for (uint64_t bits = words[w]; bits; bits &= bits-1)
+      result += (*_particles)[64*w + __builtin_ctzll(bits)];
+  }
+  return result;
+}
+
+} // namespace fcc
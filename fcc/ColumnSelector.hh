@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------
+/// \file
+/// Selectors on the fcc::ParticleInfo columns, evaluated on whole
+/// lists of particles at once into bit masks
+//----------------------------------------------------------------------
+#ifndef __FCC_COLUMNSELECTOR_HH__
+#define __FCC_COLUMNSELECTOR_HH__
+
+#include "fcc/ParticleInfo.hh"
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class SelectionMask
+/// one bit per particle of a list, packed in 64-bit words
+class SelectionMask {
+public:
+  SelectionMask() : _n(0) {}
+
+  /// n bits, all set to "value"
+  void assign(unsigned int n, bool value);
+
+  /// number of bits
+  unsigned int size() const { return _n; }
+
+  /// true if bit i is set
+  bool test(unsigned int i) const { return (_words[i >> 6] >> (i & 63)) & 1; }
+
+  /// number of bits set
+  unsigned int count() const;
+
+  /// the words (the bits beyond size() are 0)
+  std::vector<uint64_t> & words() { return _words; }
+  const std::vector<uint64_t> & words() const { return _words; }
+
+  /// word-wise combinations with another mask of the same size
+  SelectionMask & operator&=(const SelectionMask & other);
+  SelectionMask & operator|=(const SelectionMask & other);
+
+  /// invert all the bits
+  void flip();
+
+private:
+  unsigned int _n;
+  std::vector<uint64_t> _words;
+};
+
+/// \class ColumnSelector
+/// a condition on the PDG id, vertex number or charge of particles,
+/// or a combination of such conditions with &&, || (or *) and !
+///
+/// Unlike a fastjet::Selector, a ColumnSelector does not test one
+/// PseudoJet at a time through a virtual call: it is evaluated on the
+/// (gathered) metadata columns of a whole list of particles, each
+/// elementary condition giving a bit mask, and the combinations are
+/// done word by word on these masks. All the conditions apply
+/// particle by particle, so that s1*s2 is the same as s1 && s2.
+///
+/// Copies share the (immutable) expression.
+class ColumnSelector {
+public:
+  /// the particles from vertex (sub-event) "vertex_number"
+  static ColumnSelector vertex_number(int vertex_number);
+  /// the particles with the given PDG id
+  static ColumnSelector pdg_id(int pdg_id);
+  /// the charged particles
+  static ColumnSelector charged();
+
+  ColumnSelector operator&&(const ColumnSelector & other) const;
+  ColumnSelector operator||(const ColumnSelector & other) const;
+  ColumnSelector operator* (const ColumnSelector & other) const { return (*this) && other; }
+  ColumnSelector operator!() const;
+
+  std::string description() const;
+
+  /// the metadata of a list of particles, gathered from the
+  /// ParticleInfo columns (entries -1 for particles without user index)
+  struct Columns {
+    std::vector<int> pdg_id, vertex, charge;
+  };
+
+  /// set "mask" to the particles of "columns" passing the condition
+  void evaluate(const Columns & columns, SelectionMask & mask) const;
+
+private:
+  struct Node;
+  ColumnSelector(const std::shared_ptr<const Node> & node) : _node(node) {}
+  static void _evaluate(const Node & node, const Columns & columns, SelectionMask & mask);
+  static std::string _description(const Node & node);
+
+  std::shared_ptr<const Node> _node;
+};
+
+/// \class ColumnSelection
+/// several ColumnSelectors evaluated together on the same particles
+///
+/// evaluate() gathers the metadata of the particles (e.g. the
+/// constituents of a jet) once, and evaluates every selector on it;
+/// the masks, the selected particles and their sums are then read
+/// per selector. Particles without a user index pass no selector.
+///
+/// The ParticleInfo must be filled with the event of the particles
+/// and stay alive while the selection is used.
+class ColumnSelection {
+public:
+  ColumnSelection(const ParticleInfo & info, const std::vector<ColumnSelector> & selectors)
+    : _info(info), _selectors(selectors), _particles(0), _masks(selectors.size()) {}
+
+  /// evaluate all the selectors on "particles" (which are kept
+  /// by reference until the next call)
+  void evaluate(const std::vector<fastjet::PseudoJet> & particles);
+
+  /// number of selectors
+  unsigned int size() const { return _selectors.size(); }
+
+  /// the particles passing selector k
+  const SelectionMask & mask(unsigned int k) const { return _masks[k]; }
+
+  /// the particles passing selector k, and their sum
+  std::vector<fastjet::PseudoJet> selected(unsigned int k) const;
+  fastjet::PseudoJet sum(unsigned int k) const;
+
+private:
+  const ParticleInfo & _info;
+  std::vector<ColumnSelector> _selectors;
+  const std::vector<fastjet::PseudoJet> * _particles;
+  ColumnSelector::Columns _columns;
+  SelectionMask _valid;
+  std::vector<SelectionMask> _masks;
+};
+
+} // namespace fcc
+
+#endif // __FCC_COLUMNSELECTOR_HH__
@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::ConstituentSubtraction
+//----------------------------------------------------------------------
+#include "fcc/ConstituentSubtraction.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+const double pi = M_PI, twopi = 2*M_PI;
+
+/// 2 pi as the contrib writes it when it builds its ghost grid
+const double contrib_twopi = 2*3.14159265;
+
+/// squared rapidity-phi distance (phi in [0, 2pi))
+inline double delta_R2(double rap1, double phi1, double rap2, double phi2){
+  double dphi = std::abs(phi1 - phi2);
+  if (dphi > pi) dphi = twopi - dphi;
+  double drap = rap1 - rap2;
+  return drap*drap + dphi*dphi;
+}
+
+}
+
+//----------------------------------------------------------------------
+// the grid of ConstituentSubtractor::construct_ghosts_uniformly():
+// n_rap x n_phi cells covering |eta| < max_eta, with the numbers of
+// cells rounded to the nearest integer
+ConstituentSubtraction::ConstituentSubtraction(double max_eta, double ghost_area,
+                                               double max_distance, double alpha)
+  : _max_eta(max_eta), _ghost_area(ghost_area), _max_distance(max_distance), _alpha(alpha),
+    _bge_rho(0), _bge_rhom(0), _rho(0.0), _rho_m(0.0), _keep_masses(false), _mass_subtraction(false),
+    _n_pairs(0){
+  if ((max_eta <= 0) || (ghost_area <= 0) || (max_distance <= 0))
+    throw Error("ConstituentSubtraction: max_eta, ghost_area and max_distance must be positive");
+  double size = sqrt(ghost_area);
+  _n_rap = max(1, int(2*max_eta/size + 0.5));
+  _n_phi = max(1, int(contrib_twopi/size + 0.5));
+  _drap = 2*max_eta/_n_rap;
+  _dphi = contrib_twopi/_n_phi;
+  for (int r = 0; r < _n_rap; r++) _ghost_rap.push_back((r+0.5)*_drap - max_eta);
+  for (int c = 0; c < _n_phi; c++) _ghost_phi.push_back((c+0.5)*_dphi);
+}
+
+//----------------------------------------------------------------------
+string ConstituentSubtraction::description() const{
+  ostringstream oss;
+  oss << "event-wide constituent subtraction up to |eta| = " << _max_eta
+      << ", ghost area " << _drap*_dphi << ", max DeltaR " << _max_distance
+      << ", alpha " << _alpha << (_mass_subtraction ? ", with rho_m" : "")
+      << " (pairs from the ghost grid)";
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+unsigned long ConstituentSubtraction::state_bytes() const{
+  return sizeof(unsigned int)*_selected.capacity() +
+    sizeof(double)*(_rap.capacity() + _phi.capacity() + _pt.capacity() + _mtmpt.capacity() +
+                    _weight.capacity() + _ghost_pt.capacity() + _ghost_mtmpt.capacity()) +
+    sizeof(Pair)*_heap.capacity();
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> ConstituentSubtraction::subtract_event(const vector<PseudoJet> & particles){
+  // the particles in the acceptance
+  _selected.clear();
+  _rap.clear(); _phi.clear(); _pt.clear(); _mtmpt.clear(); _weight.clear();
+  for (unsigned int i = 0; i < particles.size(); i++){
+    const PseudoJet & particle = particles[i];
+    if (std::abs(particle.eta()) >= _max_eta) continue;
+    double pt = particle.pt();
+    _selected.push_back(i);
+    _rap.push_back(particle.rap());
+    _phi.push_back(particle.phi_02pi());
+    _pt.push_back(pt);
+    _mtmpt.push_back(_mass_subtraction ? particle.mt() - pt : 0.0);
+    // pairs are ordered in pt^alpha DeltaR, i.e. in pt^(2 alpha) DeltaR^2
+    _weight.push_back(_alpha == 0 ? 1.0 : pow(pt, 2*_alpha));
+  }
+
+  // the ghosts' pt and mt - pt, from rho and rho_m in each row
+  _ghost_pt.resize(n_ghosts());
+  _ghost_mtmpt.resize(n_ghosts());
+  double area = _drap*_dphi;
+  for (int r = 0; r < _n_rap; r++){
+    double rho = _rho, rho_m = _rho_m;
+    PseudoJet ghost = PtYPhiM(1.0, _ghost_rap[r], _ghost_phi[0]);
+    if (_bge_rho) rho = _bge_rho->rho(ghost);
+    if (_mass_subtraction && _bge_rho) rho_m = (_bge_rhom ? _bge_rhom : _bge_rho)->rho_m(ghost);
+    fill(_ghost_pt.begin()    + r*_n_phi, _ghost_pt.begin()    + (r+1)*_n_phi, rho*area);
+    fill(_ghost_mtmpt.begin() + r*_n_phi, _ghost_mtmpt.begin() + (r+1)*_n_phi,
+         _mass_subtraction ? rho_m*area : 0.0);
+  }
+
+  // the closest pair of every particle
+  _heap.clear();
+  Pair pair;
+  for (unsigned int i = 0; i < _rap.size(); i++){
+    if (_particle_used_up(i)) continue;
+    if (_next_pair(i, -numeric_limits<double>::infinity(), -1, pair)) _heap.push_back(pair);
+  }
+  make_heap(_heap.begin(), _heap.end());
+
+  // the pairs, closest first: each takes the smaller of the two pts
+  // (and of the two mt - pt) from both, then the particle moves on to
+  // its next pair
+  _n_pairs = 0;
+  while (!_heap.empty()){
+    pop_heap(_heap.begin(), _heap.end());
+    pair = _heap.back();
+    _heap.pop_back();
+    _n_pairs++;
+    unsigned int i = pair.particle, g = pair.ghost;
+    if ((_pt[i] > 0) && (_ghost_pt[g] > 0)){
+      if (_pt[i] > _ghost_pt[g]){
+        _pt[i] -= _ghost_pt[g];
+        _ghost_pt[g] = 0;
+      } else {
+        _ghost_pt[g] -= _pt[i];
+        _pt[i] = 0;
+      }
+    }
+    if ((_mtmpt[i] > 0) && (_ghost_mtmpt[g] > 0)){
+      if (_mtmpt[i] > _ghost_mtmpt[g]){
+        _mtmpt[i] -= _ghost_mtmpt[g];
+        _ghost_mtmpt[g] = 0;
+      } else {
+        _ghost_mtmpt[g] -= _mtmpt[i];
+        _mtmpt[i] = 0;
+      }
+    }
+    if (_particle_used_up(i)) continue;
+    if (_next_pair(i, pair.distance, g, pair)){
+      _heap.push_back(pair);
+      push_heap(_heap.begin(), _heap.end());
+    }
+  }
+
+  vector<PseudoJet> subtracted;
+  for (unsigned int i = 0; i < _selected.size(); i++){
+    if (_particle_used_up(i)) continue;
+    const PseudoJet & particle = particles[_selected[i]];
+    double m = 0.0;
+    if (_mass_subtraction){
+      double mt = _mtmpt[i] + _pt[i], m2 = mt*mt - _pt[i]*_pt[i];
+      m = (m2 > 0) ? sqrt(m2) : 0.0;
+    } else if (_keep_masses){
+      m = particle.m();
+    }
+    subtracted.push_back(PtYPhiM(_pt[i], _rap[i], _phi[i], m));
+    subtracted.back().set_user_index(particle.user_index());
+  }
+  return subtracted;
+}
+
+//----------------------------------------------------------------------
+inline bool ConstituentSubtraction::_particle_used_up(unsigned int i) const{
+  return (_pt[i] <= 0) && (_mtmpt[i] <= 0);
+}
+
+inline bool ConstituentSubtraction::_ghost_used_up(unsigned int g) const{
+  return (_ghost_pt[g] <= 0) && (_ghost_mtmpt[g] <= 0);
+}
+
+//----------------------------------------------------------------------
+// the pair of particle i that comes next after (distance, ghost) in
+// the order of the sorted pairs, among the ghosts within max_distance
+// that still have something left; only the rows and columns within
+// max_distance of the particle (with a one-cell margin) are tried
+bool ConstituentSubtraction::_next_pair(unsigned int i, double distance, int ghost, Pair & next) const{
+  double rap = _rap[i], phi = _phi[i], max_dR2 = _max_distance*_max_distance;
+  int row_min = int(floor((rap + _max_eta - _max_distance)/_drap - 0.5));
+  int row_max = int(ceil ((rap + _max_eta + _max_distance)/_drap - 0.5));
+  row_min = max(row_min, 0);
+  row_max = min(row_max, _n_rap-1);
+  int column_min = int(floor((phi - _max_distance)/_dphi - 0.5));
+  int column_max = int(ceil ((phi + _max_distance)/_dphi - 0.5));
+  bool all_columns = (column_max - column_min + 1 >= _n_phi);
+  if (all_columns){
+    column_min = 0;
+    column_max = _n_phi-1;
+  }
+
+  bool found = false;
+  for (int row = row_min; row <= row_max; row++){
+    for (int c = column_min; c <= column_max; c++){
+      int column = all_columns ? c : ((c % _n_phi) + _n_phi) % _n_phi;
+      int g = row*_n_phi + column;
+      if (_ghost_used_up(g)) continue;
+      double dR2 = delta_R2(rap, phi, _ghost_rap[row], _ghost_phi[column]);
+      if (dR2 > max_dR2) continue;
+      double d = _weight[i]*dR2;
+      // strictly after the previous pair, and before the best so far
+      if ((d < distance) || ((d == distance) && (g <= ghost))) continue;
+      if (found && ((d > next.distance) || ((d == next.distance) && (unsigned(g) > next.ghost)))) continue;
+      next.distance = d;
+      next.particle = i;
+      next.ghost = g;
+      found = true;
+    }
+  }
+  return found;
+}
+
+} // namespace fcc
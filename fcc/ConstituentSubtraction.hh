@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------
+/// \file
+/// Event-wide constituent subtraction with the particle-ghost pairs
+/// found on the ghost grid instead of among all the pairs
+//----------------------------------------------------------------------
+#ifndef __FCC_CONSTITUENTSUBTRACTION_HH__
+#define __FCC_CONSTITUENTSUBTRACTION_HH__
+
+#include "fastjet/PseudoJet.hh"
+#include "fastjet/tools/BackgroundEstimatorBase.hh"
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class ConstituentSubtraction
+/// event-wide constituent subtraction (Berta, Spousta, Miller,
+/// Leitner), giving the same output as fjcontrib's
+/// ConstituentSubtractor::subtract_event() with the DeltaR distance
+/// and the same max_eta, ghost_area, max_distance and alpha
+///
+/// As in the contrib, massless ghosts are placed at the centres of a
+/// regular grid in eta (= y for them) and phi up to |eta| = max_eta,
+/// each carrying pt = rho * area and mt - pt = rho_m * area (rho and
+/// rho_m from the background estimators, evaluated at the first ghost
+/// of each row, or fixed values). The particles with |eta| < max_eta
+/// and the ghosts within DeltaR <= max_distance of them are paired,
+/// and the pairs are processed in order of increasing
+/// pt_i^(2 alpha) * DeltaR^2: the smaller of the two pts is subtracted
+/// from both (and likewise for mt - pt with set_do_mass_subtraction()).
+/// The particles left with something are returned with their original
+/// rapidity and phi; they are massless unless
+/// set_keep_original_masses() or set_do_mass_subtraction() was called.
+/// Particles beyond max_eta are not returned.
+///
+/// Since the ghosts sit on a grid, the ghosts near a particle are
+/// found directly from its rapidity and phi. Instead of building and
+/// sorting all the pairs of the event, each particle only holds its
+/// next pair in a heap ordered like the sorted list; when that pair
+/// has been used, the particle's next one is looked up among its
+/// ~pi max_distance^2/ghost_area neighbouring ghosts. The memory is
+/// then a few words per particle and per ghost, whatever the number
+/// of candidate pairs. The pairs at exactly the same distance, which
+/// the contrib leaves in the order of its sort, are taken by particle
+/// and then ghost index.
+class ConstituentSubtraction {
+public:
+  ConstituentSubtraction(double max_eta = 6.0, double ghost_area = 0.01,
+                         double max_distance = 0.3, double alpha = 1.0);
+
+  /// take rho (and rho_m, from bge_rhom if given, otherwise from
+  /// bge_rho) from these estimators, which must have been given the
+  /// event's particles
+  void set_background_estimator(fastjet::BackgroundEstimatorBase * bge_rho,
+                                fastjet::BackgroundEstimatorBase * bge_rhom = 0){
+    _bge_rho = bge_rho;
+    _bge_rhom = bge_rhom;
+  }
+
+  /// use fixed rho and rho_m instead of estimators
+  void set_rho(double rho, double rho_m = 0.0){ _bge_rho = _bge_rhom = 0; _rho = rho; _rho_m = rho_m; }
+
+  /// keep the masses of the particles instead of making them massless
+  void set_keep_original_masses(bool keep = true){ _keep_masses = keep; }
+
+  /// subtract rho_m from the particles' mt - pt as well
+  void set_do_mass_subtraction(bool subtract = true){ _mass_subtraction = subtract; }
+
+  std::string description() const;
+
+  /// the subtracted particles of the event
+  std::vector<fastjet::PseudoJet> subtract_event(const std::vector<fastjet::PseudoJet> & particles);
+
+  /// number of ghosts, and of pairs used for the last event
+  unsigned int n_ghosts() const { return _n_rap*_n_phi; }
+  unsigned long n_pairs() const { return _n_pairs; }
+
+  /// memory held for the last event (particles, ghosts and heap) [bytes]
+  unsigned long state_bytes() const;
+
+private:
+  /// the next pair of a particle
+  struct Pair {
+    double distance;
+    unsigned int particle, ghost;
+    /// reversed, so that the front of a std heap is the closest pair
+    bool operator<(const Pair & other) const {
+      if (distance != other.distance) return distance > other.distance;
+      if (particle != other.particle) return particle > other.particle;
+      return ghost > other.ghost;
+    }
+  };
+
+  bool _next_pair(unsigned int i, double distance, int ghost, Pair & next) const;
+  bool _particle_used_up(unsigned int i) const;
+  bool _ghost_used_up(unsigned int g) const;
+
+  double _max_eta, _ghost_area, _max_distance, _alpha;
+  fastjet::BackgroundEstimatorBase * _bge_rho, * _bge_rhom;
+  double _rho, _rho_m;
+  bool _keep_masses, _mass_subtraction;
+
+  // the ghost grid
+  int _n_rap, _n_phi;
+  double _drap, _dphi;
+  std::vector<double> _ghost_rap, _ghost_phi;  ///< per row, per column
+
+  // the selected particles and the ghosts of the current event
+  std::vector<unsigned int> _selected;
+  std::vector<double> _rap, _phi, _pt, _mtmpt, _weight;
+  std::vector<double> _ghost_pt, _ghost_mtmpt;
+  std::vector<Pair> _heap;
+  unsigned long _n_pairs;
+};
+
+} // namespace fcc
+
+#endif // __FCC_CONSTITUENTSUBTRACTION_HH__
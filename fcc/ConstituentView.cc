@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::ConstituentView and fcc::ConstituentIndices
+//----------------------------------------------------------------------
+#include "fcc/ConstituentView.hh"
+#include "fastjet/Error.hh"
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+ConstituentView::ConstituentView(const PseudoJet & jet)
+  : _cs(0), _root(jet.cluster_hist_index()){
+  if (!jet.has_associated_cluster_sequence())
+    throw Error("ConstituentView: the jet has no associated ClusterSequence");
+  _cs = jet.associated_cluster_sequence();
+}
+
+//----------------------------------------------------------------------
+unsigned int ConstituentView::size() const{
+  unsigned int n = 0;
+  for (iterator it = begin(); it != end(); ++it) n++;
+  return n;
+}
+
+//----------------------------------------------------------------------
+void ConstituentIndices::fill(const ClusterSequence & cs, const vector<PseudoJet> & jets){
+  _offsets.resize(jets.size()+1);
+  _indices.clear();
+  for (unsigned int ijet = 0; ijet < jets.size(); ijet++){
+    if (jets[ijet].associated_cluster_sequence() != &cs)
+      throw Error("ConstituentIndices: the jets must come from the ClusterSequence given");
+    _offsets[ijet] = _indices.size();
+    ConstituentView view(cs, jets[ijet].cluster_hist_index());
+    for (ConstituentView::iterator it = view.begin(); it != view.end(); ++it)
+      _indices.push_back(it.particle_index());
+  }
+  _offsets[jets.size()] = _indices.size();
+}
+
+} // namespace fcc
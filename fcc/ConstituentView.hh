@@ -0,0 +1,139 @@
+//----------------------------------------------------------------------
+/// \file
+/// Views of the constituents of jets that read the clustering history
+/// in place instead of copying the constituents into new vectors
+//----------------------------------------------------------------------
+#ifndef __FCC_CONSTITUENTVIEW_HH__
+#define __FCC_CONSTITUENTVIEW_HH__
+
+#include "fastjet/ClusterSequence.hh"
+#include <iterator>
+#include <vector>
+
+namespace fcc {
+
+/// \class ConstituentView
+/// the constituents of a jet, as a range over its ClusterSequence
+///
+/// Iterating goes down the history tree below the jet, parent1 first,
+/// and climbs back through the child links, so that it needs neither
+/// a stack nor any allocation. The constituents come in the same
+/// order as with PseudoJet::constituents(), and are references to the
+/// particles held by the ClusterSequence, which must outlive the
+/// view.
+///
+///   for (ConstituentView::iterator it = view.begin(); it != view.end(); ++it)
+///     it->user_index() ... it.particle_index() ...
+///
+/// size() walks the tree: it is O(number of constituents).
+class ConstituentView {
+public:
+  /// the constituents of "jet", which must come from a ClusterSequence
+  ConstituentView(const fastjet::PseudoJet & jet);
+
+  /// the constituents of history element "hist_index" of "cs"
+  ConstituentView(const fastjet::ClusterSequence & cs, int hist_index)
+    : _cs(&cs), _root(hist_index) {}
+
+  class iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef fastjet::PseudoJet value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const fastjet::PseudoJet * pointer;
+    typedef const fastjet::PseudoJet & reference;
+
+    iterator() : _history(0), _jets(0), _root(-1), _current(-1) {}
+
+    reference operator*()  const { return (*_jets)[(*_history)[_current].jetp_index]; }
+    pointer   operator->() const { return &(operator*()); }
+
+    /// position of the constituent among the ClusterSequence inputs
+    int particle_index() const { return _current; }
+
+    /// next constituent: climb while coming from a parent2 (or until
+    /// the root), then go down the parent2 branch of the first child
+    /// reached from its parent1
+    iterator & operator++() {
+      const std::vector<fastjet::ClusterSequence::history_element> & history = *_history;
+      int h = _current;
+      while (h != _root){
+        int child = history[h].child;
+        if (history[child].parent1 == h){
+          _current = _leftmost(history[child].parent2);
+          return *this;
+        }
+        h = child;
+      }
+      _current = -1;
+      return *this;
+    }
+    iterator operator++(int) { iterator tmp(*this); ++(*this); return tmp; }
+
+    bool operator==(const iterator & other) const { return _current == other._current; }
+    bool operator!=(const iterator & other) const { return _current != other._current; }
+
+  private:
+    friend class ConstituentView;
+    iterator(const fastjet::ClusterSequence & cs, int root)
+      : _history(&cs.history()), _jets(&cs.jets()), _root(root), _current(_leftmost(root)) {}
+
+    /// the first particle below h (following parent1)
+    int _leftmost(int h) const {
+      while ((*_history)[h].parent1 >= 0) h = (*_history)[h].parent1;
+      return h;
+    }
+
+    const std::vector<fastjet::ClusterSequence::history_element> * _history;
+    const std::vector<fastjet::PseudoJet> * _jets;
+    int _root, _current;
+  };
+
+  iterator begin() const { return iterator(*_cs, _root); }
+  iterator end() const { return iterator(); }
+
+  /// number of constituents
+  unsigned int size() const;
+
+private:
+  const fastjet::ClusterSequence * _cs;
+  int _root;
+};
+
+/// \class ConstituentIndices
+/// the constituents of a set of jets, as one flat array
+///
+/// After fill(), the inputs of the ClusterSequence (their positions
+/// in the vector that was clustered) making up jet ijet are
+/// indices()[offset(ijet)] ... indices()[offset(ijet+1)-1], in the
+/// order of PseudoJet::constituents(). The two arrays are reused by
+/// the next call.
+class ConstituentIndices {
+public:
+  /// the constituents of "jets", which must all come from "cs"
+  void fill(const fastjet::ClusterSequence & cs, const std::vector<fastjet::PseudoJet> & jets);
+
+  /// number of jets
+  unsigned int n_jets() const { return _offsets.empty() ? 0 : _offsets.size()-1; }
+
+  /// first entry of jet ijet in indices() (offset(n_jets()) is the total)
+  unsigned int offset(unsigned int ijet) const { return _offsets[ijet]; }
+
+  /// number of constituents of jet ijet
+  unsigned int size(unsigned int ijet) const { return _offsets[ijet+1] - _offsets[ijet]; }
+
+  /// the constituents of jet ijet
+  const unsigned int * begin(unsigned int ijet) const { return _indices.data() + _offsets[ijet]; }
+  const unsigned int * end(unsigned int ijet)   const { return _indices.data() + _offsets[ijet+1]; }
+
+  /// the flat arrays themselves
+  const std::vector<unsigned int> & offsets() const { return _offsets; }
+  const std::vector<unsigned int> & indices() const { return _indices; }
+
+private:
+  std::vector<unsigned int> _offsets, _indices;
+};
+
+} // namespace fcc
+
+#endif // __FCC_CONSTITUENTVIEW_HH__
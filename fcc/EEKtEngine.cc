@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::EEKtEngine
+//----------------------------------------------------------------------
+#include "fcc/EEKtEngine.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+/// below this, 1 - cos theta comes from the cross product
+const double small_distance2 = numeric_limits<double>::epsilon();
+/// the distance to the neighbour of a jet that has none
+const double no_neighbour = numeric_limits<double>::max();
+}
+
+//----------------------------------------------------------------------
+EEKtEngine::EEKtEngine(unsigned int n_max)
+  : _n_max(n_max), _n(0), _Q(0.0), _exclusive(n_max+1) {}
+
+//----------------------------------------------------------------------
+string EEKtEngine::description() const{
+  ostringstream oss;
+  oss << "e+e- kt (Durham) algorithm with E-scheme recombination, exclusive jets kept up to n = "
+      << _n_max;
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void EEKtEngine::_set_direction(int slot, const PseudoJet & jet){
+  double p2 = jet.modp2();
+  double norm = p2 > 0 ? 1.0/sqrt(p2) : 0.0;
+  _nx[slot] = jet.px()*norm;
+  _ny[slot] = jet.py()*norm;
+  _nz[slot] = jet.pz()*norm;
+  _e2[slot] = jet.E()*jet.E();
+}
+
+//----------------------------------------------------------------------
+// 2 (1 - cos theta) between the jets in two slots
+double EEKtEngine::_distance(int a, int b) const{
+  double cos_theta = _nx[a]*_nx[b] + _ny[a]*_ny[b] + _nz[a]*_nz[b];
+  double dist = 1.0 - cos_theta;
+  if (dist*dist < small_distance2){
+    double cx = _ny[a]*_nz[b] - _nz[a]*_ny[b];
+    double cy = _nz[a]*_nx[b] - _nx[a]*_nz[b];
+    double cz = _nx[a]*_ny[b] - _ny[a]*_nx[b];
+    dist = (cx*cx + cy*cy + cz*cz)/(1.0 + cos_theta);
+  }
+  return 2*dist;
+}
+
+//----------------------------------------------------------------------
+void EEKtEngine::_find_neighbour(int slot, int n_active){
+  int nn = slot;
+  double nn_dist = no_neighbour;
+  for (int i = 0; i < n_active; i++){
+    if (i == slot) continue;
+    double dist = _distance(slot, i);
+    if (dist < nn_dist){
+      nn_dist = dist;
+      nn = i;
+    }
+  }
+  _nn[slot] = nn;
+  _nn_dist[slot] = nn_dist;
+}
+
+//----------------------------------------------------------------------
+void EEKtEngine::_store_jets(int n_active){
+  if (n_active > int(_n_max)) return;
+  vector<PseudoJet> & jets = _exclusive[n_active];
+  jets.clear();
+  for (int i = 0; i < n_active; i++) jets.push_back(_jets[_jet[i]]);
+}
+
+//----------------------------------------------------------------------
+void EEKtEngine::cluster(const vector<PseudoJet> & particles){
+  _n = particles.size();
+  _jets.clear();
+  _jets.reserve(2*_n);
+  _jets.insert(_jets.end(), particles.begin(), particles.end());
+  _nx.resize(_n);
+  _ny.resize(_n);
+  _nz.resize(_n);
+  _e2.resize(_n);
+  _nn_dist.resize(_n);
+  _nn.resize(_n);
+  _jet.resize(_n);
+  _dmerge.resize(_n);
+  _dmerge_max.resize(_n);
+  for (unsigned int n = 0; n <= _n_max; n++) _exclusive[n].clear();
+
+  _Q = 0.0;
+  for (unsigned int i = 0; i < _n; i++){
+    _Q += particles[i].E();
+    _set_direction(i, particles[i]);
+    _jet[i] = i;
+  }
+  if (_n == 0) return;
+
+  int n_active = _n;
+  for (int i = 0; i < n_active; i++) _find_neighbour(i, n_active);
+  _store_jets(n_active);
+
+  double dmax = 0.0;
+  for (unsigned int step = 0; step+1 < _n; step++){
+    // the smallest d_ij is that of a jet with its angular neighbour
+    int a = 0;
+    double dmin = _nn_dist[0]*min(_e2[0], _e2[_nn[0]]);
+    for (int i = 1; i < n_active; i++){
+      double d = _nn_dist[i]*min(_e2[i], _e2[_nn[i]]);
+      if (d < dmin){
+        dmin = d;
+        a = i;
+      }
+    }
+    int b = _nn[a];
+    if (b < a) swap(a, b);
+    dmax = max(dmax, dmin);
+    _dmerge[step] = dmin;
+    _dmerge_max[step] = dmax;
+
+    // the merged jet goes in slot a, the last jet moves to slot b
+    _jets.push_back(_jets[_jet[a]] + _jets[_jet[b]]);
+    _jet[a] = _jets.size()-1;
+    _set_direction(a, _jets.back());
+    n_active--;
+    int last = n_active;
+    if (b != last){
+      _nx[b] = _nx[last];
+      _ny[b] = _ny[last];
+      _nz[b] = _nz[last];
+      _e2[b] = _e2[last];
+      _nn[b] = _nn[last];
+      _nn_dist[b] = _nn_dist[last];
+      _jet[b] = _jet[last];
+    }
+
+    // the jets whose neighbour was merged are rescanned, the others
+    // only compared with the new jet
+    for (int i = 0; i < n_active; i++){
+      if (i == a) continue;
+      int nn = _nn[i];
+      if ((nn == a) || (nn == b)){
+        _find_neighbour(i, n_active);
+        continue;
+      }
+      if (nn == last) _nn[i] = b;
+      double dist = _distance(i, a);
+      if (dist < _nn_dist[i]){
+        _nn_dist[i] = dist;
+        _nn[i] = a;
+      }
+    }
+    _find_neighbour(a, n_active);
+    _store_jets(n_active);
+  }
+
+  // the last jet goes to the beam
+  dmax = max(dmax, _e2[0]);
+  _dmerge[_n-1] = _e2[0];
+  _dmerge_max[_n-1] = dmax;
+}
+
+//----------------------------------------------------------------------
+const vector<PseudoJet> & EEKtEngine::exclusive_jets(int n) const{
+  if ((n < 0) || (n > int(_n_max))){
+    ostringstream oss;
+    oss << "EEKtEngine: exclusive jets are only kept for 0 <= n <= " << _n_max << " (requested " << n << ")";
+    throw Error(oss.str());
+  }
+  return _exclusive[n];
+}
+
+//----------------------------------------------------------------------
+int EEKtEngine::n_exclusive_jets(double dcut) const{
+  // the steps with a largest d so far up to dcut are done
+  int n_done = upper_bound(_dmerge_max.begin(), _dmerge_max.begin() + _n, dcut) - _dmerge_max.begin();
+  return _n - n_done;
+}
+
+} // namespace fcc
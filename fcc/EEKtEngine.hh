@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------
+/// \file
+/// A dedicated e+e- kt (Durham) clustering that keeps the exclusive
+/// jets and merging scales of every jet multiplicity up to n_max
+//----------------------------------------------------------------------
+#ifndef __FCC_EEKTENGINE_HH__
+#define __FCC_EEKTENGINE_HH__
+
+#include "fastjet/PseudoJet.hh"
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class EEKtEngine
+/// the ee_kt_algorithm of FastJet (E-scheme), clustered once per
+/// event, with every exclusive-jet query answered from the result
+///
+/// The particles are kept as unit 3-vectors and E^2 in flat arrays;
+/// no rapidity or azimuth is ever computed. The distance is
+///
+///   d_ij = 2 min(E_i^2, E_j^2) (1 - cos theta_ij)
+///
+/// with 1 - cos theta_ij taken from the cross product for nearly
+/// collinear pairs, where 1 - n_i.n_j loses its precision. The
+/// clustering is the nearest-neighbour O(N^2) one of FastJet's
+/// N2Plain strategy (which it uses for e+e- events): each jet keeps
+/// its closest neighbour in angle, and only the jets whose neighbour
+/// was merged are rescanned.
+///
+/// cluster() records the merging scale of every step, together with
+/// the largest one so far, and copies the jets present whenever at
+/// most n_max (default 6) are left. After that:
+///  - exclusive_jets(n) for n <= n_max, exclusive_dmerge(n),
+///    exclusive_ymerge(n) and their _max versions are lookups;
+///  - n_exclusive_jets(dcut) and the ycut versions are a binary
+///    search over the merging scales.
+/// The numbers are those of the FastJet ClusterSequence methods of the
+/// same names with ee_kt_algorithm, with y = d / Q^2 and Q the sum of
+/// the particle energies. As for FastJet, the last jet is merged with
+/// the "beam" at d = E_jet^2, so that exclusive_dmerge(0) is defined.
+/// The jets of each multiplicity are in no particular order.
+class EEKtEngine {
+public:
+  EEKtEngine(unsigned int n_max = 6);
+
+  std::string description() const;
+
+  /// cluster one event; the buffers are reused from one event to the
+  /// next
+  void cluster(const std::vector<fastjet::PseudoJet> & particles);
+
+  unsigned int n_max() const { return _n_max; }
+  unsigned int n_particles() const { return _n; }
+  double Q()  const { return _Q; }
+  double Q2() const { return _Q*_Q; }
+
+  /// the jets left when n remain (0 <= n <= n_max; empty if n exceeds
+  /// the number of particles)
+  const std::vector<fastjet::PseudoJet> & exclusive_jets(int n) const;
+
+  /// the d of the step from n+1 to n jets, and the largest d up to
+  /// that step (0 if there are no more than n particles)
+  double exclusive_dmerge(int n) const     { return n < int(_n) ? _dmerge[_n-1-n] : 0.0; }
+  double exclusive_dmerge_max(int n) const { return n < int(_n) ? _dmerge_max[_n-1-n] : 0.0; }
+  double exclusive_ymerge(int n) const     { return exclusive_dmerge(n)/Q2(); }
+  double exclusive_ymerge_max(int n) const { return exclusive_dmerge_max(n)/Q2(); }
+
+  /// the number of jets at dcut (ycut): the steps up to the first
+  /// whose d is above dcut are undone
+  int n_exclusive_jets(double dcut) const;
+  int n_exclusive_jets_ycut(double ycut) const { return n_exclusive_jets(ycut*Q2()); }
+
+  /// the jets at dcut (ycut), which must leave at most n_max of them
+  const std::vector<fastjet::PseudoJet> & exclusive_jets(double dcut) const {
+    return exclusive_jets(n_exclusive_jets(dcut));
+  }
+  const std::vector<fastjet::PseudoJet> & exclusive_jets_ycut(double ycut) const {
+    return exclusive_jets(n_exclusive_jets_ycut(ycut));
+  }
+
+private:
+  void _set_direction(int slot, const fastjet::PseudoJet & jet);
+  double _distance(int a, int b) const;
+  void _find_neighbour(int slot, int n_active);
+  void _store_jets(int n_active);
+
+  unsigned int _n_max, _n;
+  double _Q;
+
+  // per active jet, compacted as jets are merged
+  std::vector<double> _nx, _ny, _nz, _e2, _nn_dist;
+  std::vector<int> _nn, _jet;
+
+  std::vector<fastjet::PseudoJet> _jets;   ///< particles, then merged jets
+  std::vector<double> _dmerge, _dmerge_max; ///< per step
+  std::vector<std::vector<fastjet::PseudoJet> > _exclusive; ///< per n <= n_max
+};
+
+} // namespace fcc
+
+#endif // __FCC_EEKTENGINE_HH__
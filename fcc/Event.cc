@@ -0,0 +1,119 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::Event
+//----------------------------------------------------------------------
+#include "fcc/Event.hh"
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+void Event::clear(){
+  _px.clear(); _py.clear(); _pz.clear(); _E.clear();
+  _pdg_id.clear();
+  _subevent.clear();
+  _subevent_starts.clear();
+  _n_with_pdg_id = 0;
+}
+
+//----------------------------------------------------------------------
+void EventColumns::append_pseudojets(vector<PseudoJet> & particles) const{
+  particles.reserve(particles.size() + n);
+  for (unsigned int i=0; i<n; i++){
+    particles.push_back(PseudoJet(px[i], py[i], pz[i], E[i]));
+    particles.back().set_user_index(i);
+  }
+}
+
+//----------------------------------------------------------------------
+void Event::assign(const EventColumns & columns){
+  unsigned int n = columns.n;
+  _px.assign(columns.px, columns.px+n);
+  _py.assign(columns.py, columns.py+n);
+  _pz.assign(columns.pz, columns.pz+n);
+  _E .assign(columns.E,  columns.E +n);
+
+  if (columns.pdg_id){
+    _pdg_id.assign(columns.pdg_id, columns.pdg_id+n);
+    _n_with_pdg_id = n;
+  } else {
+    _pdg_id.assign(n, 0);
+    _n_with_pdg_id = 0;
+  }
+
+  // sub-events are contiguous and numbered 0, 1, 2, ...: sub-event k
+  // starts at its first particle, and empty ones (e.g. an empty hard
+  // sub-event in a mixed event) start where the next one does
+  _subevent_starts.clear();
+  if (columns.subevent){
+    _subevent.assign(columns.subevent, columns.subevent+n);
+    for (unsigned int i=0; i<n; i++)
+      while (int(_subevent_starts.size()) <= _subevent[i]) _subevent_starts.push_back(i);
+  } else {
+    _subevent.assign(n, 0);
+    if (n>0) _subevent_starts.push_back(0);
+  }
+}
+
+//----------------------------------------------------------------------
+EventColumns Event::columns() const{
+  EventColumns columns;
+  columns.n  = size();
+  columns.px = _px.data();
+  columns.py = _py.data();
+  columns.pz = _pz.data();
+  columns.E  = _E.data();
+  columns.pdg_id   = has_pdg_id() ? _pdg_id.data() : 0;
+  columns.subevent = _subevent.data();
+  return columns;
+}
+
+//----------------------------------------------------------------------
+void Event::start_subevent(bool keep_empty){
+  if ((!keep_empty) && (!_subevent_starts.empty()) && (_subevent_starts.back() == size())) return;
+  _subevent_starts.push_back(size());
+}
+
+//----------------------------------------------------------------------
+void Event::_add(double px, double py, double pz, double E, int pdg_id){
+  if (_subevent_starts.empty()) _subevent_starts.push_back(0);
+  _px.push_back(px);
+  _py.push_back(py);
+  _pz.push_back(pz);
+  _E .push_back(E);
+  _pdg_id.push_back(pdg_id);
+  _subevent.push_back(_subevent_starts.size()-1);
+}
+
+//----------------------------------------------------------------------
+PseudoJet Event::pseudojet(unsigned int i) const{
+  PseudoJet p(_px[i], _py[i], _pz[i], _E[i]);
+  p.set_user_index(i);
+  return p;
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> Event::pseudojets() const{
+  vector<PseudoJet> particles;
+  append_pseudojets(particles, 0, size());
+  return particles;
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> Event::subevent_pseudojets(unsigned int isub) const{
+  vector<PseudoJet> particles;
+  append_pseudojets(particles, subevent_begin(isub), subevent_end(isub));
+  return particles;
+}
+
+//----------------------------------------------------------------------
+void Event::append_pseudojets(vector<PseudoJet> & particles,
+                              unsigned int begin, unsigned int end) const{
+  particles.reserve(particles.size() + (end-begin));
+  for (unsigned int i=begin; i<end; i++)
+    particles.push_back(pseudojet(i));
+}
+
+} // namespace fcc
@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------
+/// \file
+/// Storage for a single event read from one of the .dat files
+///
+/// The particles of an event are kept as contiguous columns
+/// (px, py, pz, E, PDG id and sub-event index) so that they can be
+/// turned into fastjet::PseudoJet's, or processed directly, without
+/// any further parsing.
+//----------------------------------------------------------------------
+#ifndef __FCC_EVENT_HH__
+#define __FCC_EVENT_HH__
+
+#include "fastjet/PseudoJet.hh"
+#include <vector>
+
+namespace fcc {
+
+/// \class EventColumns
+/// read-only view of the columns of one event
+///
+/// pdg_id and subevent are null when they are not available.
+struct EventColumns {
+  unsigned int n;
+  const double *px, *py, *pz, *E;
+  const int *pdg_id, *subevent;
+
+  /// append the PseudoJets of this event to "particles" (user index
+  /// set to the position in the event, as for Event::pseudojets())
+  void append_pseudojets(std::vector<fastjet::PseudoJet> & particles) const;
+};
+
+/// \class Event
+/// a single event, stored column-wise
+///
+/// An event is made of one or more sub-events: in the pileup files
+/// each of them starts with a "#SUBSTART" line, the first (number 0)
+/// being the hard interaction and the following ones minimum-bias
+/// collisions. Files without "#SUBSTART" markers give a single
+/// sub-event.
+class Event {
+public:
+  /// default ctor: an empty event
+  Event() : _n_with_pdg_id(0) {}
+
+  /// remove all particles (keeping the allocated memory)
+  void clear();
+
+  /// replace the content of the event by a copy of "columns"
+  void assign(const EventColumns & columns);
+
+  /// view of the columns of this event
+  EventColumns columns() const;
+
+  /// start a new sub-event. If the current sub-event is still empty,
+  /// this does nothing, unless keep_empty is true (e.g. to keep an
+  /// empty hard sub-event as number 0).
+  void start_subevent(bool keep_empty = false);
+
+  /// add a particle to the current sub-event
+  void add_particle(double px, double py, double pz, double E){
+    _add(px, py, pz, E, 0);
+  }
+
+  /// add a particle, with its PDG id, to the current sub-event
+  void add_particle(double px, double py, double pz, double E, int pdg_id){
+    _add(px, py, pz, E, pdg_id);
+    _n_with_pdg_id++;
+  }
+
+  /// number of particles in the event
+  unsigned int size() const { return _px.size(); }
+
+  /// true if there are no particles
+  bool empty() const { return _px.empty(); }
+
+  /// number of sub-events
+  unsigned int n_subevents() const { return _subevent_starts.size(); }
+
+  /// index of the first particle of sub-event isub
+  unsigned int subevent_begin(unsigned int isub) const {
+    return _subevent_starts[isub];
+  }
+
+  /// index one past the last particle of sub-event isub
+  unsigned int subevent_end(unsigned int isub) const {
+    return (isub+1 < _subevent_starts.size()) ? _subevent_starts[isub+1] : size();
+  }
+
+  /// true if every particle came with a PDG id
+  bool has_pdg_id() const { return _n_with_pdg_id > 0 && _n_with_pdg_id == size(); }
+
+  /// access to the individual columns
+  const double * px() const { return _px.data(); }
+  const double * py() const { return _py.data(); }
+  const double * pz() const { return _pz.data(); }
+  const double * E()  const { return _E.data(); }
+  const int * pdg_id() const { return _pdg_id.data(); }
+  const int * subevent() const { return _subevent.data(); }
+
+  /// the PDG id of particle i (0 when unknown)
+  int pdg_id(unsigned int i) const { return _pdg_id[i]; }
+
+  /// the sub-event (vertex) particle i belongs to
+  int subevent(unsigned int i) const { return _subevent[i]; }
+
+  /// particle i, as a PseudoJet with its user index set to i
+  fastjet::PseudoJet pseudojet(unsigned int i) const;
+
+  /// all the particles of the event, with user index set to their
+  /// position in the event
+  std::vector<fastjet::PseudoJet> pseudojets() const;
+
+  /// the particles of sub-event isub (user index still refers to the
+  /// position in the full event)
+  std::vector<fastjet::PseudoJet> subevent_pseudojets(unsigned int isub) const;
+
+  /// append the particles in [begin, end) to "particles"
+  void append_pseudojets(std::vector<fastjet::PseudoJet> & particles,
+                         unsigned int begin, unsigned int end) const;
+
+protected:
+  void _add(double px, double py, double pz, double E, int pdg_id);
+
+  std::vector<double> _px, _py, _pz, _E;  ///< the momenta
+  std::vector<int> _pdg_id;               ///< PDG ids (0 if unknown)
+  std::vector<int> _subevent;             ///< sub-event of each particle
+  std::vector<unsigned int> _subevent_starts; ///< first particle of each sub-event
+  unsigned int _n_with_pdg_id;            ///< how many particles had a PDG id
+};
+
+} // namespace fcc
+
+#endif // __FCC_EVENT_HH__
@@ -0,0 +1,48 @@
+//----------------------------------------------------------------------
+/// \file
+/// Common interface for the per-event analyses that the drivers run
+//----------------------------------------------------------------------
+#ifndef __FCC_EVENTANALYSIS_HH__
+#define __FCC_EVENTANALYSIS_HH__
+
+#include "fcc/BinaryJetFile.hh"
+#include "fcc/Event.hh"
+#include <iostream>
+#include <string>
+
+namespace fcc {
+
+/// \class EventAnalysis
+/// base class for an analysis run event by event
+///
+/// An analysis owns everything it needs to process an event (jet
+/// definitions, cluster sequences, background estimators, ...), so
+/// that independent copies obtained through clone() can run
+/// concurrently, one per thread.
+class EventAnalysis {
+public:
+  virtual ~EventAnalysis() {}
+
+  /// a fresh copy of this analysis, with its own clustering and
+  /// background-estimation objects
+  virtual EventAnalysis * clone() const = 0;
+
+  /// a description of what the analysis does
+  virtual std::string description() const = 0;
+
+  /// run the analysis on one event, number iev of the input (which
+  /// seeds anything random in the analysis, so that the results do
+  /// not depend on which copy processes the event)
+  virtual void process(const Event & event, unsigned long iev) = 0;
+
+  /// print the results for the last event processed
+  virtual void print(std::ostream & ostr) const = 0;
+
+  /// add the jets of the last event processed (those of the last
+  /// table of print()) to "writer", as event number iev
+  virtual void write_jets(BinaryJetWriter & writer, unsigned long iev) const = 0;
+};
+
+} // namespace fcc
+
+#endif // __FCC_EVENTANALYSIS_HH__
@@ -0,0 +1,350 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::EventReader
+//----------------------------------------------------------------------
+#include "fcc/EventReader.hh"
+#include "fastjet/Error.hh"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace fcc {
+
+namespace {
+  /// size of the chunks read in when the input is not memory-mapped
+  const size_t buffer_chunk = 1 << 16;
+
+  /// powers of ten that are exactly representable as doubles
+  const double exact_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  inline bool is_blank(char c){ return c==' ' || c=='\t' || c=='\r'; }
+  inline bool is_digit(char c){ return c>='0' && c<='9'; }
+
+  inline void skip_blanks(const char *& p, const char * end){
+    while ((p != end) && is_blank(*p)) ++p;
+  }
+
+  inline bool starts_with(const char * begin, const char * end, const char * tag){
+    size_t n = strlen(tag);
+    return (size_t(end-begin) >= n) && (strncmp(begin, tag, n) == 0);
+  }
+}
+
+//----------------------------------------------------------------------
+// number parsing
+//----------------------------------------------------------------------
+
+// Up to 19 significant digits are accumulated in an integer. When
+// this integer is exactly representable as a double (< 2^53) and the
+// decimal exponent is at most 22 in absolute value, a single
+// multiplication or division by an exact power of ten gives the
+// correctly-rounded result. This covers all the numbers in the .dat
+// files; anything else is handed over to strtod.
+bool parse_double(const char *& p, const char * end, double & x){
+  skip_blanks(p, end);
+  const char * start = p;
+
+  bool negative = false;
+  if ((p != end) && (*p == '-' || *p == '+')){ negative = (*p == '-'); ++p;}
+
+  uint64_t mantissa = 0;
+  int n_significant = 0, exponent = 0;
+  bool any_digit = false, truncated = false;
+  for (; (p != end) && is_digit(*p); ++p){
+    any_digit = true;
+    if (n_significant < 19){
+      mantissa = 10*mantissa + (*p-'0');
+      if (mantissa) n_significant++;
+    } else {
+      exponent++;
+      truncated = true;
+    }
+  }
+  if ((p != end) && (*p == '.')){
+    for (++p; (p != end) && is_digit(*p); ++p){
+      any_digit = true;
+      if (n_significant < 19){
+        mantissa = 10*mantissa + (*p-'0');
+        if (mantissa) n_significant++;
+        exponent--;
+      } else {
+        truncated = true;
+      }
+    }
+  }
+  if (!any_digit){ p = start; return false;}
+
+  if ((p != end) && (*p == 'e' || *p == 'E')){
+    const char * exp_start = p;
+    ++p;
+    bool exp_negative = false;
+    if ((p != end) && (*p == '-' || *p == '+')){ exp_negative = (*p == '-'); ++p;}
+    if ((p == end) || (!is_digit(*p))){
+      p = exp_start;
+    } else {
+      int exp_value = 0;
+      for (; (p != end) && is_digit(*p); ++p)
+        if (exp_value < 10000) exp_value = 10*exp_value + (*p-'0');
+      exponent += exp_negative ? -exp_value : exp_value;
+    }
+  }
+
+  if ((!truncated) && (mantissa <= (uint64_t(1) << 53)) &&
+      (exponent >= -22) && (exponent <= 22)){
+    x = double(mantissa);
+    if (exponent < 0) x /= exact_powers_of_ten[-exponent];
+    else              x *= exact_powers_of_ten[ exponent];
+    if (negative) x = -x;
+    return true;
+  }
+
+  // slow path: strtod needs a null-terminated string
+  char number[128];
+  size_t length = p - start;
+  if (length >= sizeof(number)){ p = start; return false;}
+  memcpy(number, start, length);
+  number[length] = '\0';
+  x = strtod(number, 0);
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool parse_int(const char *& p, const char * end, int & i){
+  skip_blanks(p, end);
+  const char * start = p;
+  bool negative = false;
+  if ((p != end) && (*p == '-' || *p == '+')){ negative = (*p == '-'); ++p;}
+  if ((p == end) || (!is_digit(*p))){ p = start; return false;}
+  long value = 0;
+  for (; (p != end) && is_digit(*p); ++p) value = 10*value + (*p-'0');
+  i = negative ? -value : value;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// EventReader
+//----------------------------------------------------------------------
+EventReader::EventReader() : _filename("<stdin>"){
+  _open(0, false);
+}
+
+//----------------------------------------------------------------------
+EventReader::EventReader(const string & filename) : _filename(filename){
+  if (filename == "-"){
+    _filename = "<stdin>";
+    _open(0, false);
+    return;
+  }
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) throw fastjet::Error("EventReader: could not open "+filename);
+  _open(fd, true);
+}
+
+//----------------------------------------------------------------------
+EventReader::~EventReader(){
+  if (_map) munmap(_map, _map_size);
+  if (_owns_fd) close(_fd);
+}
+
+//----------------------------------------------------------------------
+// map the input if it is a regular file, otherwise prepare for
+// buffered reads
+void EventReader::_open(int fd, bool owns_fd){
+  _fd = fd;
+  _owns_fd = owns_fd;
+  _map = 0;
+  _map_size = 0;
+  _cursor = _end = 0;
+  _eof = false;
+  _n_events_read = _n_lines_read = 0;
+  _binary = false;
+  _next_in_block = 0;
+
+  struct stat info;
+  if ((fstat(fd, &info) == 0) && S_ISREG(info.st_mode)){
+    // a redirected file may not be read from its start
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0) offset = 0;
+    if (info.st_size <= offset){ _eof = true; return;}
+
+    void * map = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED){
+      madvise(map, info.st_size, MADV_SEQUENTIAL);
+      _map      = static_cast<char*>(map);
+      _map_size = info.st_size;
+      _cursor   = _map + offset;
+      _end      = _map + _map_size;
+      _eof      = true;
+      _open_binary();
+      return;
+    }
+  }
+
+  // fall back on buffered reads
+  _buffer.resize(buffer_chunk);
+  _cursor = _end = &_buffer[0];
+  _open_binary();
+}
+
+//----------------------------------------------------------------------
+// check for a binary event file and, if so, read its header
+void EventReader::_open_binary(){
+  _binary = false;
+  _next_in_block = 0;
+  if (!_ensure(sizeof(binary_format::FileHeader))) return;
+  if (!binary_format::is_binary(_cursor, _end-_cursor)) return;
+
+  binary_format::FileHeader header;
+  memcpy(&header, _cursor, sizeof(header));
+  if ((header.byte_order_mark != binary_format::byte_order_mark) ||
+      (header.version != binary_format::version))
+    throw fastjet::Error("EventReader: "+_filename+" is not a compatible binary event file");
+
+  _binary = true;
+  _binary_flags = header.flags;
+  _cursor += sizeof(header);
+}
+
+//----------------------------------------------------------------------
+// move the unread part of the buffer to its front and read some more
+void EventReader::_refill(){
+  size_t n_left = _end - _cursor;
+  memmove(&_buffer[0], _cursor, n_left);
+  if (_buffer.size() - n_left < buffer_chunk/2) _buffer.resize(2*_buffer.size());
+
+  ssize_t n_read;
+  do {
+    n_read = read(_fd, &_buffer[n_left], _buffer.size()-n_left);
+  } while ((n_read < 0) && (errno == EINTR));
+  if (n_read < 0) throw fastjet::Error("EventReader: error while reading "+_filename);
+  if (n_read == 0) _eof = true;
+
+  _cursor = &_buffer[0];
+  _end    = _cursor + n_left + n_read;
+}
+
+//----------------------------------------------------------------------
+// make sure at least n_bytes are available after the cursor (as long
+// as the input has that many)
+bool EventReader::_ensure(size_t n_bytes){
+  while ((size_t(_end-_cursor) < n_bytes) && (!_eof)) _refill();
+  return size_t(_end-_cursor) >= n_bytes;
+}
+
+//----------------------------------------------------------------------
+// get the next line (without its end-of-line character)
+bool EventReader::_next_line(const char *& line_begin, const char *& line_end){
+  while (true){
+    const char * newline = static_cast<const char*>(memchr(_cursor, '\n', _end-_cursor));
+    if (newline){
+      line_begin = _cursor;
+      line_end   = newline;
+      _cursor    = newline+1;
+      _n_lines_read++;
+      return true;
+    }
+    if (_eof){
+      if (_cursor == _end) return false;
+      // last line, without a terminating newline
+      line_begin = _cursor;
+      line_end   = _end;
+      _cursor    = _end;
+      _n_lines_read++;
+      return true;
+    }
+    _refill();
+  }
+}
+
+//----------------------------------------------------------------------
+void EventReader::_parse_particle(const char * begin, const char * end, Event & event){
+  double px, py, pz, E;
+  const char * p = begin;
+  if (!(parse_double(p, end, px) && parse_double(p, end, py) &&
+        parse_double(p, end, pz) && parse_double(p, end, E))){
+    ostringstream oss;
+    oss << "EventReader: wrong format on line " << _n_lines_read << " of " << _filename
+        << " (particles must be specified with px py pz E [pdg_id])";
+    throw fastjet::Error(oss.str());
+  }
+
+  int pdg_id;
+  if (parse_int(p, end, pdg_id)) event.add_particle(px, py, pz, E, pdg_id);
+  else                           event.add_particle(px, py, pz, E);
+}
+
+//----------------------------------------------------------------------
+bool EventReader::next_event(Event & event){
+  if (_binary) return _next_binary_event(event);
+
+  event.clear();
+
+  const char *begin, *end;
+  bool started = false;
+  while (_next_line(begin, end)){
+    skip_blanks(begin, end);
+    if (begin == end) continue;
+
+    if (*begin == '#'){
+      if (starts_with(begin, end, "#END")){
+        _n_events_read++;
+        return true;
+      }
+      if (starts_with(begin, end, "#SUBSTART")){
+        event.start_subevent(true);
+        started = true;
+      }
+      continue;
+    }
+
+    _parse_particle(begin, end, event);
+    started = true;
+  }
+
+  // end of input: return what we have if anything
+  if (!started) return false;
+  _n_events_read++;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// the block being read stays in place (mapped, or at the front of the
+// buffer) until all its events have been returned
+bool EventReader::_next_binary_event(Event & event){
+  if (_next_in_block == _block.n_events()){
+    binary_format::BlockHeader header;
+    if (!_ensure(sizeof(header))){
+      event.clear();
+      return false;
+    }
+    memcpy(&header, _cursor, sizeof(header));
+    size_t block_size = binary_format::Block::size(header, _binary_flags);
+    if (!_ensure(block_size))
+      throw fastjet::Error("EventReader: "+_filename+" is truncated");
+    _block.set(_cursor, _binary_flags);
+    if (!_block.offsets_valid())
+      throw fastjet::Error("EventReader: "+_filename+" has invalid event offsets");
+    _cursor += block_size;
+    _next_in_block = 0;
+
+    // an empty block would only happen for a file written without events
+    if (_block.n_events() == 0) return _next_binary_event(event);
+  }
+
+  event.assign(_block.event(_next_in_block));
+  _next_in_block++;
+  _n_events_read++;
+  return true;
+}
+
+} // namespace fcc
@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------
+/// \file
+/// Reader for the .dat event files used by the exercises
+///
+/// The expected format is one particle per line,
+///
+///    px py pz E [pdg_id]
+///
+/// with lines starting with '#' treated as comments, except for
+///  - "#SUBSTART" which starts a new sub-event (vertex)
+///  - "#END"      which closes the current event
+///
+/// Files without "#END" markers are read as a single event.
+///
+/// Binary event files (see fcc/BinaryEventFile.hh) are recognised
+/// from their first bytes and read transparently, so that any program
+/// using an EventReader accepts either format.
+//----------------------------------------------------------------------
+#ifndef __FCC_EVENTREADER_HH__
+#define __FCC_EVENTREADER_HH__
+
+#include "fcc/Event.hh"
+#include "fcc/BinaryEventFile.hh"
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class EventReader
+/// sequential reader for the .dat files
+///
+/// Regular files (including a file redirected to the standard input)
+/// are memory-mapped and parsed in place; pipes are read through a
+/// small buffer that only ever holds a few lines, so that memory
+/// stays bounded however long the input is.
+///
+/// Numbers are parsed without going through iostreams or the C
+/// locale, which makes reading the large pileup files considerably
+/// cheaper than the usual "cin >> px >> py >> pz >> E" loop.
+class EventReader {
+public:
+  /// read from the standard input
+  EventReader();
+
+  /// read from the named file ("-" is the standard input)
+  EventReader(const std::string & filename);
+
+  ~EventReader();
+
+  /// read the next event into "event" (which is cleared first).
+  /// Returns false once the input is exhausted.
+  bool next_event(Event & event);
+
+  /// number of events returned so far
+  unsigned int n_events_read() const { return _n_events_read; }
+
+  /// number of input lines processed so far (text input only)
+  unsigned int n_lines_read() const { return _n_lines_read; }
+
+  /// true if the input is a binary event file
+  bool is_binary() const { return _binary; }
+
+protected:
+  void _open(int fd, bool owns_fd);
+  bool _next_line(const char *& line_begin, const char *& line_end);
+  void _refill();
+  bool _ensure(size_t n_bytes);
+  void _parse_particle(const char * begin, const char * end, Event & event);
+  void _open_binary();
+  bool _next_binary_event(Event & event);
+
+  std::string _filename;   ///< for error messages
+  int _fd;                 ///< underlying file descriptor
+  bool _owns_fd;           ///< true if we have to close _fd
+
+  // memory-mapped input
+  char * _map;             ///< start of the mapping (0 if not mapped)
+  size_t _map_size;        ///< size of the mapping
+
+  // buffered input (used when the input cannot be mapped)
+  std::vector<char> _buffer;
+
+  const char * _cursor;    ///< next character to be read
+  const char * _end;       ///< end of the valid data
+  bool _eof;               ///< true when nothing is left to read in
+
+  unsigned int _n_events_read, _n_lines_read;
+
+  // binary input
+  bool _binary;                    ///< true for a binary event file
+  uint32_t _binary_flags;          ///< which optional columns are present
+  binary_format::Block _block;     ///< the block currently being read
+  unsigned int _next_in_block;     ///< next event to return from _block
+
+private:
+  // non-copyable
+  EventReader(const EventReader &);
+  EventReader & operator=(const EventReader &);
+};
+
+/// parse a floating-point number starting at "p" (leading blanks are
+/// skipped) without depending on the locale. On success, "x" is set,
+/// "p" points just past the number and true is returned.
+bool parse_double(const char *& p, const char * end, double & x);
+
+/// same as parse_double for a (signed) integer
+bool parse_int(const char *& p, const char * end, int & i);
+
+} // namespace fcc
+
+#endif // __FCC_EVENTREADER_HH__
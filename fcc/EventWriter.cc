@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of the event writers
+//----------------------------------------------------------------------
+#include "fcc/EventWriter.hh"
+#include "fcc/BinaryEventFile.hh"
+#include "fastjet/Error.hh"
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+TextEventWriter::TextEventWriter(const string & filename)
+  : _filename(filename), _n_events(0){
+  _file = (filename == "-") ? stdout : fopen(filename.c_str(), "w");
+  if (!_file) throw Error("TextEventWriter: could not create "+filename);
+}
+
+//----------------------------------------------------------------------
+TextEventWriter::~TextEventWriter(){
+  try { close(); } catch (const Error &) {}
+}
+
+//----------------------------------------------------------------------
+// same layout as the Pythia pileup files
+void TextEventWriter::write(const Event & event){
+  if (!_file) throw Error("TextEventWriter: writing to closed file "+_filename);
+
+  bool with_pdg_id = event.has_pdg_id();
+  for (unsigned int isub = 0; isub < event.n_subevents(); isub++){
+    fputs("#SUBSTART\n", _file);
+    for (unsigned int i = event.subevent_begin(isub); i < event.subevent_end(isub); i++){
+      fprintf(_file, "%20.10f %20.10f %20.10f %20.10f",
+              event.px()[i], event.py()[i], event.pz()[i], event.E()[i]);
+      if (with_pdg_id) fprintf(_file, " %8d\n", event.pdg_id(i));
+      else             fputc('\n', _file);
+    }
+  }
+  if (fputs("#END\n", _file) < 0)
+    throw Error("TextEventWriter: error while writing "+_filename);
+  _n_events++;
+}
+
+//----------------------------------------------------------------------
+void TextEventWriter::close(){
+  if (!_file) return;
+  bool ok = (_file == stdout) ? (fflush(_file) == 0) : (fclose(_file) == 0);
+  _file = 0;
+  if (!ok) throw Error("TextEventWriter: error while closing "+_filename);
+}
+
+//----------------------------------------------------------------------
+EventWriter * make_event_writer(const string & filename, bool binary,
+                                bool with_pdg_id, bool with_subevent){
+  if (binary) return new BinaryEventWriter(filename, with_pdg_id, with_subevent);
+  return new TextEventWriter(filename);
+}
+
+} // namespace fcc
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------
+/// \file
+/// Writing of events, either in the .dat text format or in the
+/// binary format of fcc/BinaryEventFile.hh
+//----------------------------------------------------------------------
+#ifndef __FCC_EVENTWRITER_HH__
+#define __FCC_EVENTWRITER_HH__
+
+#include "fcc/Event.hh"
+#include <cstdio>
+#include <string>
+
+namespace fcc {
+
+/// \class EventWriter
+/// base class for the event writers
+class EventWriter {
+public:
+  virtual ~EventWriter() {}
+
+  /// add one event
+  virtual void write(const Event & event) = 0;
+
+  /// flush everything and close the output
+  virtual void close() = 0;
+
+  /// number of events written so far
+  virtual unsigned long n_events() const = 0;
+};
+
+/// \class TextEventWriter
+/// writes events in the .dat format read by EventReader
+///
+/// Every sub-event is preceded by a "#SUBSTART" line and every event
+/// is terminated by "#END". PDG ids are written as a fifth column
+/// for events that have them.
+class TextEventWriter : public EventWriter {
+public:
+  /// create the file ("-" is the standard output)
+  TextEventWriter(const std::string & filename);
+  virtual ~TextEventWriter();
+
+  virtual void write(const Event & event);
+  virtual void close();
+  virtual unsigned long n_events() const { return _n_events; }
+
+protected:
+  std::string _filename;
+  FILE * _file;
+  unsigned long _n_events;
+
+private:
+  TextEventWriter(const TextEventWriter &);
+  TextEventWriter & operator=(const TextEventWriter &);
+};
+
+/// a text or binary writer for "filename" (to be deleted by the caller)
+EventWriter * make_event_writer(const std::string & filename, bool binary,
+                                bool with_pdg_id = true, bool with_subevent = true);
+
+} // namespace fcc
+
+#endif // __FCC_EVENTWRITER_HH__
@@ -0,0 +1,325 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of the exercise analyses
+//----------------------------------------------------------------------
+#include "fcc/ExerciseAnalyses.hh"
+#include <cstdarg>
+#include <cstdio>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+void print_formatted(ostream & ostr, const char * format, ...){
+  char buffer[512];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  ostr << buffer;
+}
+
+//----------------------------------------------------------------------
+// BasicAnalysis
+//----------------------------------------------------------------------
+
+// create a jet definition: 
+// a jet algorithm with a given radius parameter
+BasicAnalysis::BasicAnalysis()
+  : _jet_def(antikt_algorithm, 0.6), _ptmin(5.0) {}
+
+//----------------------------------------------------------------------
+void BasicAnalysis::process(const Event & event, unsigned long){
+  _particles = event.pseudojets();
+
+  // run the jet clustering with the above jet definition (or get it
+  // back from the cache)
+  if (_cache) _clust_seq = _cache->cluster(_particles, _jet_def);
+  else        _clust_seq.reset(new ClusterSequence(_particles, _jet_def));
+
+  // get the resulting jets ordered in pt
+  _jets = sorted_by_pt(_clust_seq->inclusive_jets(_ptmin));
+}
+
+//----------------------------------------------------------------------
+// show the output as 
+//   {index, rap, phi, pt}
+void BasicAnalysis::print(ostream & ostr) const{
+  // label the columns
+  print_formatted(ostr, "%5s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt");
+ 
+  // print out the details for each jet
+  for (unsigned int i = 0; i < _jets.size(); i++) {
+    print_formatted(ostr, "%5u %15.8f %15.8f %15.8f\n",
+                    i, _jets[i].rap(), _jets[i].phi(), _jets[i].perp());
+  }
+}
+
+//----------------------------------------------------------------------
+void BasicAnalysis::write_jets(BinaryJetWriter & writer, unsigned long iev) const{
+  for (unsigned int i = 0; i < _jets.size(); i++) writer.write(iev, i, _jets[i]);
+}
+
+//----------------------------------------------------------------------
+// AreaAnalysis
+//----------------------------------------------------------------------
+
+// a kt jet definition and an AreaDefinition for active areas. For
+// the GhostedAreaSpec, ghosts are placed up to |y|=5 (the ghost
+// rapidity interval should cover the jets for which we want the
+// area, up to at least |y|+R), with 3 repetitions (i.e. sets of
+// ghosts) and the default ghost area of 0.01
+AreaAnalysis::AreaAnalysis(bool cached_ghosts)
+  : _jet_def(kt_algorithm, 0.6),
+    _area_def(active_area, GhostedAreaSpec(5.0, 3, 0.01)),
+    _ptmin(5.0) {
+  if (cached_ghosts)
+    _cached_clustering.reset(new CachedGhostClustering(_jet_def, _area_def.ghost_spec()));
+}
+
+//----------------------------------------------------------------------
+// the copy of the cached clustering shares the lattice and the
+// thread pool with this one
+EventAnalysis * AreaAnalysis::clone() const{
+  AreaAnalysis * analysis = new AreaAnalysis();
+  if (_cached_clustering) analysis->_cached_clustering.reset(new CachedGhostClustering(*_cached_clustering));
+  if (_soft_killer) analysis->set_soft_killer(*_soft_killer);
+  return analysis;
+}
+
+//----------------------------------------------------------------------
+string AreaAnalysis::description() const{
+  return _jet_def.description() + ", area: " + _area_def.description()
+    + (_cached_clustering ? " (cached ghost lattice)" : "")
+    + (_soft_killer ? "; pre-filter: " + _soft_killer->description() : "");
+}
+
+//----------------------------------------------------------------------
+void AreaAnalysis::process(const Event & event, unsigned long iev){
+  if (_soft_killer){
+    _unfiltered = event.pseudojets();
+    _soft_killer->apply(_unfiltered, _particles);
+  } else {
+    _particles = event.pseudojets();
+  }
+
+  _areas.clear();
+  _area_errors.clear();
+  if (_cached_clustering){
+    _cached_clustering->cluster(_particles, iev);
+    _jets = sorted_by_pt(_cached_clustering->inclusive_jets(_ptmin));
+    for (unsigned int i = 0; i < _jets.size(); i++){
+      _areas.push_back(_cached_clustering->area(_jets[i]));
+      _area_errors.push_back(_cached_clustering->area_error(_jets[i]));
+    }
+    return;
+  }
+
+  // the only change w.r.t. BasicAnalysis is the usage of a
+  // ClusterSequenceArea rather than a ClusterSequence
+  _clust_seq.reset(new ClusterSequenceArea(_particles, _jet_def, _area_def));
+  _jets = sorted_by_pt(_clust_seq->inclusive_jets(_ptmin));
+  for (unsigned int i = 0; i < _jets.size(); i++){
+    _areas.push_back(_jets[i].area());
+    _area_errors.push_back(_jets[i].area_error());
+  }
+}
+
+//----------------------------------------------------------------------
+// show the output as 
+//   {index, rap, phi, pt, area, area error}
+void AreaAnalysis::print(ostream & ostr) const{
+  if (_soft_killer)
+    print_formatted(ostr, "SoftKiller: pt > %.4f GeV, %u of %u particles kept\n",
+                    _soft_killer->pt_threshold(), _soft_killer->n_out(), _soft_killer->n_in());
+
+  // label the columns
+  print_formatted(ostr, "%5s %15s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "area", "area error");
+ 
+  // print out the details for each jet
+  for (unsigned int i = 0; i < _jets.size(); i++) {
+    print_formatted(ostr, "%5u %15.8f %15.8f %15.8f %15.8f %15.8f\n", i,
+                    _jets[i].rap(), _jets[i].phi(), _jets[i].perp(),
+                    _areas[i], _area_errors[i]);
+  }
+}
+
+//----------------------------------------------------------------------
+void AreaAnalysis::write_jets(BinaryJetWriter & writer, unsigned long iev) const{
+  for (unsigned int i = 0; i < _jets.size(); i++) writer.write(iev, i, _jets[i], _areas[i]);
+}
+
+//----------------------------------------------------------------------
+// SubtractionAnalysis
+//----------------------------------------------------------------------
+
+// - the main clustering uses anti-kt with R=0.5 and active areas,
+//   with ghosts up to |y|=6 (at least 2R beyond the region where
+//   jets are investigated)
+// - the background is estimated from kt R=0.4 jets with explicit
+//   ghosts, using the jets with |y|<4.5 except the two hardest
+//   (or, with grid_rho, from the median pt density of 0.55 x 0.55
+//   cells up to |y|=5)
+// - the Subtractor applies the background subtraction on the jets
+//   using rho from the above estimator
+SubtractionAnalysis::SubtractionAnalysis(bool cached_ghosts, bool grid_rho)
+  : _particle_maxrap(5.0), _ghost_maxrap(6.0), _ptmin(7.0),
+    _jet_def(antikt_algorithm, 0.5),
+    _area_def(active_area, GhostedAreaSpec(_ghost_maxrap)),
+    _jet_def_bkgd(kt_algorithm, 0.4),
+    _area_def_bkgd(active_area_explicit_ghosts, GhostedAreaSpec(_ghost_maxrap)),
+    _selector(SelectorAbsRapMax(4.5) * (!SelectorNHardest(2))),
+    _bkgd_estimator(_selector, _jet_def_bkgd, _area_def_bkgd),
+    _use_grid_rho(grid_rho),
+    _grid_rho(_particle_maxrap, 0.55),
+    _subtractor(grid_rho ? static_cast<BackgroundEstimatorBase*>(&_grid_rho) : &_bkgd_estimator),
+    _rho(0.0), _sigma(0.0) {
+  if (cached_ghosts){
+    // both GhostedAreaSpecs have a single repetition, so one lattice
+    // serves the three clusterings (each still draws its own jitter)
+    shared_ptr<const GhostLattice> lattice(new GhostLattice(_area_def.ghost_spec()));
+    _cached_hard.reset(new CachedGhostClustering(_jet_def,      lattice, 1, 1, 1));
+    _cached_full.reset(new CachedGhostClustering(_jet_def,      lattice, 1, 1, 2));
+    _cached_bkgd.reset(new CachedGhostClustering(_jet_def_bkgd, lattice, 1, 1, 3));
+  }
+}
+
+//----------------------------------------------------------------------
+// the copies of the cached clusterings share the lattice with these
+EventAnalysis * SubtractionAnalysis::clone() const{
+  SubtractionAnalysis * analysis = new SubtractionAnalysis(false, _use_grid_rho);
+  if (_cached_full){
+    analysis->_cached_hard.reset(new CachedGhostClustering(*_cached_hard));
+    analysis->_cached_full.reset(new CachedGhostClustering(*_cached_full));
+    analysis->_cached_bkgd.reset(new CachedGhostClustering(*_cached_bkgd));
+  }
+  if (_soft_killer) analysis->set_soft_killer(*_soft_killer);
+  return analysis;
+}
+
+//----------------------------------------------------------------------
+string SubtractionAnalysis::description() const{
+  ostringstream oss;
+  oss << _jet_def.description() << ", area: " << _area_def.description()
+      << ", particles up to |y|=" << _particle_maxrap
+      << "; background: " << bkgd_estimator().description();
+  if (_cached_full) oss << " (cached ghost lattice)";
+  if (_soft_killer) oss << "; pre-filter: " << _soft_killer->description();
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void SubtractionAnalysis::_filter_full_event(){
+  if (!_soft_killer) return;
+  _unfiltered.swap(_full_event);
+  _soft_killer->apply(_unfiltered, _full_event);
+}
+
+//----------------------------------------------------------------------
+void SubtractionAnalysis::process(const Event & event, unsigned long iev){
+  // keep the hard event (sub-event 0) separated from the full event,
+  // so as to be able to gauge the "goodness" of the subtraction
+  _hard_event.clear();
+  _full_event.clear();
+  for (unsigned int i = 0; i < event.size(); i++) {
+    PseudoJet particle = event.pseudojet(i);
+    if (abs(particle.rap()) > _particle_maxrap) continue;
+    _full_event.push_back(particle);
+    if (event.subevent(i) == 0) _hard_event.push_back(particle);
+  }
+  _filter_full_event();
+
+  if (_cached_full){
+    _cached_hard->cluster(_hard_event, iev);
+    _cached_full->cluster(_full_event, iev);
+    _hard_jets = sorted_by_pt(_cached_hard->inclusive_jets(_ptmin));
+    _full_jets = sorted_by_pt(_cached_full->inclusive_jets(_ptmin));
+    if (_use_grid_rho){
+      _grid_rho.set_particles(_full_event);
+      _rho   = _grid_rho.rho();
+      _sigma = _grid_rho.sigma();
+    } else {
+      _cached_bkgd->cluster(_full_event, iev);
+      _bkgd_estimator.set_cluster_sequence(_cached_bkgd->cluster_sequence());
+      _rho   = _bkgd_estimator.rho();
+      _sigma = _bkgd_estimator.sigma();
+    }
+    _subtracted_jets = _subtractor(_full_jets);
+    return;
+  }
+
+  // run the jet clustering for both the hard and full event, and get
+  // the jets above ptmin (the cut is applied again after subtraction)
+  _clust_seq_hard.reset(new ClusterSequenceArea(_hard_event, _jet_def, _area_def));
+  _clust_seq_full.reset(new ClusterSequenceArea(_full_event, _jet_def, _area_def));
+  _hard_jets = sorted_by_pt(_clust_seq_hard->inclusive_jets(_ptmin));
+  _full_jets = sorted_by_pt(_clust_seq_full->inclusive_jets(_ptmin));
+
+  // tell the background estimator to use this event and subtract
+  // the full-event jets
+  if (_use_grid_rho){
+    _grid_rho.set_particles(_full_event);
+    _rho   = _grid_rho.rho();
+    _sigma = _grid_rho.sigma();
+  } else {
+    _bkgd_estimator.set_particles(_full_event);
+    _rho   = _bkgd_estimator.rho();
+    _sigma = _bkgd_estimator.sigma();
+  }
+  _subtracted_jets = _subtractor(_full_jets);
+}
+
+//----------------------------------------------------------------------
+// the background properties, the jets in the hard event and the jets
+// before and after subtraction in the full event
+void SubtractionAnalysis::print(ostream & ostr) const{
+  ostr << "  Giving, for the full event" << endl;
+  ostr << "    rho   = " << _rho   << endl;
+  ostr << "    sigma = " << _sigma << endl;
+  if (_soft_killer)
+    print_formatted(ostr, "    after SoftKiller: pt > %.4f GeV, %u of %u particles kept\n",
+                    _soft_killer->pt_threshold(), _soft_killer->n_out(), _soft_killer->n_in());
+  ostr << endl;
+
+  ostr << "Jets above " << _ptmin << " GeV in the hard event (" << _hard_event.size() << " particles)" << endl;
+  ostr << "---------------------------------------\n";
+  print_formatted(ostr, "%5s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "area");
+  for (unsigned int i = 0; i < _hard_jets.size(); i++) {
+    print_formatted(ostr, "%5u %15.8f %15.8f %15.8f %15.8f\n", i,
+                    _hard_jets[i].rap(), _hard_jets[i].phi(), _hard_jets[i].perp(),
+                    _hard_jets[i].area());
+  }
+  ostr << endl;
+
+  ostr << "Jets above " << _ptmin << " GeV in the full event (" << _full_event.size() << " particles)" << endl;
+  ostr << "---------------------------------------\n";
+  print_formatted(ostr, "%5s %15s %15s %15s %15s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt", "area", "rap_sub", "phi_sub", "pt_sub");
+  unsigned int idx=0;
+  for (unsigned int i=0; i<_full_jets.size(); i++){
+    // re-apply the pt cut
+    if (_subtracted_jets[i].perp2() >= _ptmin*_ptmin){
+      print_formatted(ostr, "%5u %15.8f %15.8f %15.8f %15.8f %15.8f %15.8f %15.8f\n", idx,
+                      _full_jets[i].rap(), _full_jets[i].phi(), _full_jets[i].perp(),
+                      _full_jets[i].area(),
+                      _subtracted_jets[i].rap(), _subtracted_jets[i].phi(), 
+                      _subtracted_jets[i].perp());
+      idx++;
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// the full-event jets that pass the cut after subtraction, numbered
+// as in print()
+void SubtractionAnalysis::write_jets(BinaryJetWriter & writer, unsigned long iev) const{
+  unsigned int idx = 0;
+  for (unsigned int i = 0; i < _full_jets.size(); i++){
+    if (_subtracted_jets[i].perp2() < _ptmin*_ptmin) continue;
+    writer.write(iev, idx++, _full_jets[i], _full_jets[i].area(), _subtracted_jets[i].perp());
+  }
+}
+
+} // namespace fcc
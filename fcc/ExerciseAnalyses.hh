@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------
+/// \file
+/// The per-event bodies of the basic01, jetArea06 and subtraction07
+/// exercises, packaged as fcc::EventAnalysis's so that the same code
+/// runs in the exercises and in the parallel driver
+//----------------------------------------------------------------------
+#ifndef __FCC_EXERCISEANALYSES_HH__
+#define __FCC_EXERCISEANALYSES_HH__
+
+#include "fcc/ClusteringCache.hh"
+#include "fcc/EventAnalysis.hh"
+#include "fcc/GhostLattice.hh"
+#include "fcc/GridRho.hh"
+#include "fcc/SoftKiller.hh"
+#include "fastjet/ClusterSequenceArea.hh"
+#include "fastjet/Selector.hh"
+#include "fastjet/tools/JetMedianBackgroundEstimator.hh"
+#include "fastjet/tools/Subtractor.hh"
+#include <memory>
+
+namespace fcc {
+
+/// printf-style output to a stream (the exercises' tables are all
+/// written with printf formats)
+void print_formatted(std::ostream & ostr, const char * format, ...)
+#ifdef __GNUC__
+  __attribute__((format(printf, 2, 3)))
+#endif
+  ;
+
+//----------------------------------------------------------------------
+/// \class BasicAnalysis
+/// basic01: anti-kt R=0.6 inclusive jets above 5 GeV
+///
+/// With set_cache, the clustering is taken from (and stored in) an
+/// fcc::ClusteringCache. The cache is not passed on to clones, as it
+/// must not be shared between threads.
+class BasicAnalysis : public EventAnalysis {
+public:
+  BasicAnalysis();
+
+  virtual EventAnalysis * clone() const { return new BasicAnalysis(); }
+  virtual std::string description() const { return _jet_def.description(); }
+  virtual void process(const Event & event, unsigned long iev);
+  virtual void print(std::ostream & ostr) const;
+  virtual void write_jets(BinaryJetWriter & writer, unsigned long iev) const;
+
+  const fastjet::JetDefinition & jet_def() const { return _jet_def; }
+  const std::vector<fastjet::PseudoJet> & jets() const { return _jets; }
+
+  void set_cache(std::shared_ptr<ClusteringCache> cache) { _cache = cache; }
+  const ClusteringCache * cache() const { return _cache.get(); }
+
+protected:
+  fastjet::JetDefinition _jet_def;
+  double _ptmin;
+  std::vector<fastjet::PseudoJet> _particles;
+  std::unique_ptr<fastjet::ClusterSequence> _clust_seq;
+  std::shared_ptr<ClusteringCache> _cache;
+  std::vector<fastjet::PseudoJet> _jets;
+};
+
+//----------------------------------------------------------------------
+/// \class AreaAnalysis
+/// jetArea06: kt R=0.6 jets above 5 GeV with their active areas
+///
+/// With cached_ghosts, the ghost lattice is built once and reused for
+/// every event, and the repetitions run concurrently
+/// (fcc::CachedGhostClustering) instead of going through
+/// ClusterSequenceArea. With set_soft_killer, the particles go
+/// through a SoftKiller pre-filter before being clustered.
+class AreaAnalysis : public EventAnalysis {
+public:
+  AreaAnalysis(bool cached_ghosts = false);
+
+  virtual EventAnalysis * clone() const;
+  virtual std::string description() const;
+  virtual void process(const Event & event, unsigned long iev);
+  virtual void print(std::ostream & ostr) const;
+  virtual void write_jets(BinaryJetWriter & writer, unsigned long iev) const;
+
+  const fastjet::JetDefinition  & jet_def()  const { return _jet_def; }
+  const fastjet::AreaDefinition & area_def() const { return _area_def; }
+  const std::vector<fastjet::PseudoJet> & jets() const { return _jets; }
+
+  /// the areas of the jets (averaged over the repetitions) and their
+  /// errors
+  const std::vector<double> & areas() const { return _areas; }
+  const std::vector<double> & area_errors() const { return _area_errors; }
+
+  /// filter the particles with (a copy of) soft_killer before the
+  /// clustering
+  void set_soft_killer(const SoftKiller & soft_killer) { _soft_killer.reset(new SoftKiller(soft_killer)); }
+  const SoftKiller * soft_killer() const { return _soft_killer.get(); }
+
+protected:
+  fastjet::JetDefinition _jet_def;
+  fastjet::AreaDefinition _area_def;
+  double _ptmin;
+  std::unique_ptr<SoftKiller> _soft_killer;
+  std::vector<fastjet::PseudoJet> _particles, _unfiltered;
+  std::unique_ptr<fastjet::ClusterSequenceArea> _clust_seq;
+  std::unique_ptr<CachedGhostClustering> _cached_clustering;
+  std::vector<fastjet::PseudoJet> _jets;
+  std::vector<double> _areas, _area_errors;
+};
+
+//----------------------------------------------------------------------
+/// \class SubtractionAnalysis
+/// subtraction07: anti-kt R=0.5 jets in the hard and full events,
+/// with the full-event jets subtracted using a jet-median estimate
+/// of rho
+///
+/// With cached_ghosts, the hard, full and background clusterings all
+/// take their ghosts from one GhostLattice built at construction, and
+/// the background estimator is handed the resulting cluster sequence.
+/// With grid_rho, rho is instead the median over the cells of a
+/// rapidity-phi grid (fcc::GridRhoEstimator), which needs no
+/// background clustering. With set_soft_killer, the full event goes
+/// through a SoftKiller pre-filter before the clustering and the
+/// background estimation (the hard event is left as it is, as the
+/// reference).
+class SubtractionAnalysis : public EventAnalysis {
+public:
+  SubtractionAnalysis(bool cached_ghosts = false, bool grid_rho = false);
+
+  virtual EventAnalysis * clone() const;
+  virtual std::string description() const;
+  virtual void process(const Event & event, unsigned long iev);
+  virtual void print(std::ostream & ostr) const;
+  virtual void write_jets(BinaryJetWriter & writer, unsigned long iev) const;
+
+  const fastjet::JetDefinition  & jet_def()  const { return _jet_def; }
+  const fastjet::AreaDefinition & area_def() const { return _area_def; }
+  double particle_maxrap() const { return _particle_maxrap; }
+  double ptmin() const { return _ptmin; }
+  const fastjet::BackgroundEstimatorBase & bkgd_estimator() const {
+    if (_use_grid_rho) return _grid_rho;
+    return _bkgd_estimator;
+  }
+
+  const std::vector<fastjet::PseudoJet> & hard_event() const { return _hard_event; }
+  const std::vector<fastjet::PseudoJet> & full_event() const { return _full_event; }
+  const std::vector<fastjet::PseudoJet> & hard_jets()  const { return _hard_jets; }
+  const std::vector<fastjet::PseudoJet> & full_jets()  const { return _full_jets; }
+  const std::vector<fastjet::PseudoJet> & subtracted_jets() const { return _subtracted_jets; }
+
+  /// filter the full event with (a copy of) soft_killer
+  void set_soft_killer(const SoftKiller & soft_killer) { _soft_killer.reset(new SoftKiller(soft_killer)); }
+  const SoftKiller * soft_killer() const { return _soft_killer.get(); }
+
+protected:
+  /// apply the SoftKiller, if any, to _full_event
+  void _filter_full_event();
+
+  double _particle_maxrap, _ghost_maxrap, _ptmin;
+  fastjet::JetDefinition _jet_def;
+  fastjet::AreaDefinition _area_def;
+  fastjet::JetDefinition _jet_def_bkgd;
+  fastjet::AreaDefinition _area_def_bkgd;
+  fastjet::Selector _selector;
+  fastjet::JetMedianBackgroundEstimator _bkgd_estimator;
+  bool _use_grid_rho;
+  GridRhoEstimator _grid_rho;
+  fastjet::Subtractor _subtractor;
+
+  std::unique_ptr<SoftKiller> _soft_killer;
+  std::vector<fastjet::PseudoJet> _hard_event, _full_event, _unfiltered;
+  std::unique_ptr<fastjet::ClusterSequenceArea> _clust_seq_hard, _clust_seq_full;
+  std::unique_ptr<CachedGhostClustering> _cached_hard, _cached_full, _cached_bkgd;
+  std::vector<fastjet::PseudoJet> _hard_jets, _full_jets, _subtracted_jets;
+  double _rho, _sigma;
+};
+
+} // namespace fcc
+
+#endif // __FCC_EXERCISEANALYSES_HH__
@@ -0,0 +1,247 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::GhostLattice and fcc::CachedGhostClustering
+//----------------------------------------------------------------------
+#include "fcc/GhostLattice.hh"
+#include "fcc/ConstituentView.hh"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+// GhostLattice
+//----------------------------------------------------------------------
+
+// same cells as GhostedAreaSpec::_initialize() and add_ghosts(): with
+// the FastJet 2 placement, 2 nrap+1 rows at i*drap (numbers of cells
+// rounded up, ghosts beyond ghost_maxrap dropped); otherwise (the
+// default since FastJet 3.1) 2 nrap rows at (i+1/2)*drap (numbers of
+// cells rounded to the nearest integer)
+GhostLattice::GhostLattice(const GhostedAreaSpec & spec)
+  : _maxrap(spec.ghost_maxrap()),
+    _grid_scatter(spec.grid_scatter()), _pt_scatter(spec.pt_scatter()),
+    _mean_ghost_pt(spec.mean_ghost_pt()){
+  bool fj2 = spec.fj2_placement();
+  _drap = sqrt(spec.ghost_area());
+  _dphi = _drap;
+  int nphi = fj2 ? int(ceil(twopi/_dphi)) : int(twopi/_dphi + 0.5);
+  _dphi = twopi/nphi;
+  int nrap = fj2 ? int(ceil(_maxrap/_drap)) : int(_maxrap/_drap + 0.5);
+  _drap = _maxrap/nrap;
+
+  int irap_max = fj2 ? nrap : nrap-1;
+  double rap_offset = fj2 ? 0.0 : 0.5;
+  unsigned int n = (irap_max+nrap+1)*nphi;
+  _rap.reserve(n); _phi.reserve(n);
+  _exprap.reserve(n); _cosphi.reserve(n); _sinphi.reserve(n);
+  for (int irap = -nrap; irap <= irap_max; irap++){
+    for (int iphi = 0; iphi < nphi; iphi++){
+      _rap.push_back((irap+rap_offset)*_drap);
+      _phi.push_back((iphi+0.5)*_dphi);
+      _exprap.push_back(exp(_rap.back()));
+      _cosphi.push_back(cos(_phi.back()));
+      _sinphi.push_back(sin(_phi.back()));
+    }
+  }
+
+  // with |jitter| < 1e-3 the expansions below are good to 5e-14
+  _small_jitter = (0.5*max(_drap, _dphi)*_grid_scatter < 1e-3);
+}
+
+//----------------------------------------------------------------------
+void GhostLattice::seed_for_event(mt19937_64 & random, unsigned long seed,
+                                  unsigned long event_number, unsigned int stream){
+  seed_seq sequence = {uint32_t(seed), uint32_t(uint64_t(seed) >> 32), uint32_t(event_number),
+                       uint32_t(uint64_t(event_number) >> 32), uint32_t(stream)};
+  random.seed(sequence);
+}
+
+//----------------------------------------------------------------------
+// the three jitters of a ghost, in [-0.5, 0.5), come from the three
+// 21-bit fields of one draw
+void GhostLattice::generate(mt19937_64 & random, vector<PseudoJet> & ghosts) const{
+  const unsigned long long mask = (1ULL << 21) - 1;
+  const double scale = 1.0/(1ULL << 21), offset = 0.5*scale - 0.5;
+  ghosts.clear();
+  for (unsigned int i = 0; i < _rap.size(); i++){
+    unsigned long long bits = random();
+    double dphi = _dphi*((bits         & mask)*scale + offset)*_grid_scatter;
+    double drap = _drap*(((bits >> 21) & mask)*scale + offset)*_grid_scatter;
+    double pt   = _mean_ghost_pt*(1+(((bits >> 42) & mask)*scale + offset)*_pt_scatter);
+    if (std::abs(_rap[i] + drap) > _maxrap) continue;
+
+    double exprap, cosphi, sinphi;
+    if (_small_jitter){
+      double c = 1 - 0.5*dphi*dphi, s = dphi*(1 - dphi*dphi/6);
+      exprap = _exprap[i]*(1 + drap*(1 + drap*(0.5 + drap/6)));
+      cosphi = _cosphi[i]*c - _sinphi[i]*s;
+      sinphi = _sinphi[i]*c + _cosphi[i]*s;
+    } else {
+      exprap = exp(_rap[i] + drap);
+      cosphi = cos(_phi[i] + dphi);
+      sinphi = sin(_phi[i] + dphi);
+    }
+    double pminus = pt/exprap, pplus = pt*exprap;
+    ghosts.push_back(PseudoJet(pt*cosphi, pt*sinphi, 0.5*(pplus-pminus), 0.5*(pplus+pminus)));
+  }
+}
+
+//----------------------------------------------------------------------
+// CachedGhostClustering
+//----------------------------------------------------------------------
+
+CachedGhostClustering::CachedGhostClustering(const JetDefinition & jet_def,
+                                             const GhostedAreaSpec & spec,
+                                             unsigned int n_threads, unsigned long seed)
+  : _jet_def(jet_def), _lattice(new GhostLattice(spec)), _n_threads(n_threads), _seed(seed),
+    _repeats(spec.repeat()), _particles(0), _event_number(0){
+  _init();
+}
+
+//----------------------------------------------------------------------
+CachedGhostClustering::CachedGhostClustering(const JetDefinition & jet_def,
+                                             shared_ptr<const GhostLattice> lattice,
+                                             unsigned int n_repeat,
+                                             unsigned int n_threads, unsigned long seed)
+  : _jet_def(jet_def), _lattice(lattice), _n_threads(n_threads), _seed(seed),
+    _repeats(n_repeat), _particles(0), _event_number(0){
+  _init();
+}
+
+//----------------------------------------------------------------------
+CachedGhostClustering::CachedGhostClustering(const CachedGhostClustering & other)
+  : _jet_def(other._jet_def), _lattice(other._lattice), _n_threads(other._n_threads),
+    _seed(other._seed), _repeats(other._repeats.size()), _pool(other._pool), _particles(0), _event_number(0){
+  _init();
+}
+
+//----------------------------------------------------------------------
+// the ghost buffers, and (unless a copy brought one) a pool for the
+// repetitions that do not run on the calling thread
+void CachedGhostClustering::_init(){
+  if (_repeats.empty()) _repeats.resize(1);
+  for (unsigned int i = 0; i < _repeats.size(); i++) _repeats[i].ghosts.reserve(_lattice->n_cells());
+  if (_pool) return;
+  unsigned int n_threads = (_n_threads == 0) ? ThreadPool::hardware_threads() : _n_threads;
+  if (n_threads > _repeats.size()) n_threads = _repeats.size();
+  if (n_threads > 1) _pool.reset(new ThreadPool(n_threads-1));
+}
+
+//----------------------------------------------------------------------
+void CachedGhostClustering::cluster(const vector<PseudoJet> & particles, unsigned long event_number){
+  _particles = &particles;
+  _event_number = event_number;
+  if (_pool && (_repeats.size() > 1)){
+    // the pool may be shared with copies clustering at the same time,
+    // so only our own tasks are waited for (not ThreadPool::wait())
+    mutex done_mutex;
+    condition_variable done;
+    unsigned int n_left = _repeats.size()-1;
+    exception_ptr exception;
+    for (unsigned int i = 1; i < _repeats.size(); i++){
+      _pool->submit([this, i, &done_mutex, &done, &n_left, &exception](unsigned int){
+          exception_ptr task_exception;
+          try { _run_repeat(i); } catch (...) { task_exception = current_exception(); }
+          lock_guard<mutex> lock(done_mutex);
+          if (task_exception && !exception) exception = task_exception;
+          if (--n_left == 0) done.notify_all();
+        });
+    }
+    exception_ptr own_exception;
+    try { _run_repeat(0); } catch (...) { own_exception = current_exception(); }
+    {
+      unique_lock<mutex> lock(done_mutex);
+      done.wait(lock, [&n_left]{ return n_left == 0; });
+    }
+    if (own_exception) rethrow_exception(own_exception);
+    if (exception) rethrow_exception(exception);
+  } else {
+    for (unsigned int i = 0; i < _repeats.size(); i++) _run_repeat(i);
+  }
+
+  // average the areas over the repetitions
+  unsigned int n = particles.size();
+  _area_sum.assign(n, 0.0);
+  _area2_sum.assign(n, 0.0);
+  _area_count.assign(n, 0);
+  for (unsigned int i = 0; i < _repeats.size(); i++){
+    const vector<double> & area_by_key = _repeats[i].area_by_key;
+    for (unsigned int key = 0; key < n; key++){
+      if (area_by_key[key] < 0) continue;
+      _area_sum[key]  += area_by_key[key];
+      _area2_sum[key] += area_by_key[key]*area_by_key[key];
+      _area_count[key]++;
+    }
+  }
+
+  const ClusterSequence & cs = *_repeats[0].clust_seq;
+  _key_of_jet.assign(cs.history().size(), -1);
+  vector<PseudoJet> jets = cs.inclusive_jets();
+  for (unsigned int i = 0; i < jets.size(); i++)
+    _key_of_jet[jets[i].cluster_hist_index()] = _key(jets[i]);
+}
+
+//----------------------------------------------------------------------
+// cluster with the ghosts of this event and repetition, and record
+// the area of each jet against its lowest-index particle
+void CachedGhostClustering::_run_repeat(unsigned int irepeat){
+  Repeat & repeat = _repeats[irepeat];
+  GhostLattice::seed_for_event(repeat.random, _seed, _event_number, irepeat);
+  _lattice->generate(repeat.random, repeat.ghosts);
+  repeat.clust_seq.reset(new ClusterSequenceActiveAreaExplicitGhosts(
+                           *_particles, _jet_def, repeat.ghosts, _lattice->ghost_area()));
+
+  repeat.area_by_key.assign(_particles->size(), -1.0);
+  vector<PseudoJet> jets = repeat.clust_seq->inclusive_jets();
+  for (unsigned int i = 0; i < jets.size(); i++){
+    int key = _key(jets[i]);
+    if (key >= 0) repeat.area_by_key[key] = jets[i].area();
+  }
+}
+
+//----------------------------------------------------------------------
+// the lowest index of the particles (not ghosts) in a jet, -1 for
+// pure-ghost jets. The particles come first in the cluster sequence,
+// so their history indices are their indices in the input.
+int CachedGhostClustering::_key(const PseudoJet & jet) const{
+  int n = _particles->size(), key = -1;
+  ConstituentView constituents(jet);
+  for (ConstituentView::iterator it = constituents.begin(); it != constituents.end(); ++it){
+    int index = it.particle_index();
+    if ((index < n) && ((key < 0) || (index < key))) key = index;
+  }
+  return key;
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> CachedGhostClustering::inclusive_jets(double ptmin) const{
+  vector<PseudoJet> all_jets = _repeats[0].clust_seq->inclusive_jets(ptmin), jets;
+  for (unsigned int i = 0; i < all_jets.size(); i++){
+    if (_key_of_jet[all_jets[i].cluster_hist_index()] >= 0) jets.push_back(all_jets[i]);
+  }
+  return jets;
+}
+
+//----------------------------------------------------------------------
+double CachedGhostClustering::area(const PseudoJet & jet) const{
+  int key = _key_of_jet[jet.cluster_hist_index()];
+  if ((key < 0) || (_area_count[key] == 0)) return jet.area();
+  return _area_sum[key]/_area_count[key];
+}
+
+//----------------------------------------------------------------------
+double CachedGhostClustering::area_error(const PseudoJet & jet) const{
+  int key = _key_of_jet[jet.cluster_hist_index()];
+  if ((key < 0) || (_area_count[key] == 0)) return 0.0;
+  double mean = _area_sum[key]/_area_count[key];
+  return sqrt(std::abs(_area2_sum[key]/_area_count[key] - mean*mean));
+}
+
+} // namespace fcc
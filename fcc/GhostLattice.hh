@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------
+/// \file
+/// A ghost lattice built once and reused for every event, and an
+/// active-area clustering running its repetitions concurrently on
+/// that lattice
+//----------------------------------------------------------------------
+#ifndef __FCC_GHOSTLATTICE_HH__
+#define __FCC_GHOSTLATTICE_HH__
+
+#include "fcc/ThreadPool.hh"
+#include "fastjet/AreaDefinition.hh"
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace fcc {
+
+/// \class GhostLattice
+/// the rapidity-phi lattice of a GhostedAreaSpec
+///
+/// The cell centres are computed once, together with their exp(y),
+/// cos(phi) and sin(phi). A set of ghosts only adds the random jitter
+/// of the positions (grid_scatter) and of the transverse momenta
+/// (pt_scatter) to these centres, with the same cells as FastJet's
+/// own GhostedAreaSpec, including its fj2_placement() choice: by
+/// default 2 nrap rows at rapidities (i+1/2)*drap, or with the
+/// FastJet 2 placement 2 nrap+1 rows at i*drap (ghosts kept only up
+/// to ghost_maxrap); phi at (j+1/2)*dphi in both cases. The number of
+/// ghosts and their area are then those of FastJet's lattice.
+///
+/// Each ghost takes its three jitters from a single 64-bit draw (21
+/// bits each). For the default grid_scatter (1e-4) the position
+/// jitter is tiny, and it is applied to the cached exp(y), cos(phi)
+/// and sin(phi) as a truncated expansion, exact to double precision,
+/// so that no ghost needs exp, cos or sin. Larger jitters go through
+/// the exact functions.
+///
+/// The lattice holds no random state, so one lattice can be shared
+/// (read-only) by any number of clusterings and threads.
+/// seed_for_event() gives each event (and stream within it) its own
+/// generator, so that an event's ghosts depend neither on the events
+/// drawn before it nor on the thread drawing them.
+class GhostLattice {
+public:
+  /// the lattice of "spec" (its number of repetitions is ignored)
+  GhostLattice(const fastjet::GhostedAreaSpec & spec);
+
+  /// number of lattice cells
+  unsigned int n_cells() const { return _rap.size(); }
+
+  /// the area of a cell (i.e. the area carried by each ghost)
+  double ghost_area() const { return _drap*_dphi; }
+
+  /// the maximal ghost rapidity
+  double ghost_maxrap() const { return _maxrap; }
+
+  /// replace the content of "ghosts" with one jittered set of ghosts
+  /// drawn with "random" (the vector's memory is reused)
+  void generate(std::mt19937_64 & random, std::vector<fastjet::PseudoJet> & ghosts) const;
+
+  /// seed "random" from (seed, event_number, stream) alone
+  static void seed_for_event(std::mt19937_64 & random, unsigned long seed,
+                             unsigned long event_number, unsigned int stream = 0);
+
+private:
+  double _maxrap, _drap, _dphi;
+  double _grid_scatter, _pt_scatter, _mean_ghost_pt;
+  bool _small_jitter;              ///< position jitter applied by expansion
+  std::vector<double> _rap, _phi;  ///< cell centres
+  std::vector<double> _exprap, _cosphi, _sinphi;  ///< their exp(y), cos(phi), sin(phi)
+};
+
+/// \class CachedGhostClustering
+/// active-area clustering with ghosts from a cached GhostLattice
+///
+/// Each of the n_repeat repetitions clusters the particles with its
+/// own jittered ghost set (explicit ghosts), and the repetitions run
+/// concurrently: the first on the calling thread, the others on a
+/// small thread pool. Copies share the lattice and the pool, so that
+/// one copy per worker of an event-parallel driver does not start
+/// n_repeat threads per worker. The jets
+/// are those of the first repetition; their areas are averaged over
+/// the repetitions, matching jets by their lowest-index particle, and
+/// area_error() is the spread across repetitions (as in FastJet's
+/// ClusterSequenceActiveArea).
+///
+/// The ghosts of every repetition are drawn from a generator seeded
+/// from (seed, event number, repetition), so that the results depend
+/// neither on the number of threads nor on which copy clusters which
+/// event. Running repetitions concurrently needs a thread-safe
+/// FastJet build.
+class CachedGhostClustering {
+public:
+  /// a clustering with its own lattice, built from "spec"
+  CachedGhostClustering(const fastjet::JetDefinition & jet_def,
+                        const fastjet::GhostedAreaSpec & spec,
+                        unsigned int n_threads = 0, unsigned long seed = 1);
+
+  /// a clustering using a lattice shared with other clusterings
+  CachedGhostClustering(const fastjet::JetDefinition & jet_def,
+                        std::shared_ptr<const GhostLattice> lattice, unsigned int n_repeat,
+                        unsigned int n_threads = 0, unsigned long seed = 1);
+
+  /// a copy with the same seed, sharing the lattice and the thread
+  /// pool of "other" (copies may cluster concurrently, and give the
+  /// same ghosts for the same event number)
+  CachedGhostClustering(const CachedGhostClustering & other);
+
+  /// cluster "particles", event number "event_number" of the input
+  /// (which seeds its ghosts)
+  void cluster(const std::vector<fastjet::PseudoJet> & particles, unsigned long event_number);
+
+  const fastjet::JetDefinition & jet_def() const { return _jet_def; }
+  const GhostLattice & lattice() const { return *_lattice; }
+  unsigned int n_repeat() const { return _repeats.size(); }
+
+  /// the cluster sequence of repetition "irepeat"
+  const fastjet::ClusterSequenceActiveAreaExplicitGhosts & cluster_sequence(unsigned int irepeat = 0) const {
+    return *_repeats[irepeat].clust_seq;
+  }
+
+  /// jets above ptmin from the first repetition, pure-ghost jets
+  /// excluded
+  std::vector<fastjet::PseudoJet> inclusive_jets(double ptmin = 0.0) const;
+
+  /// area of a jet of the first repetition, averaged over the
+  /// repetitions
+  double area(const fastjet::PseudoJet & jet) const;
+
+  /// spread of the area of a jet across the repetitions
+  double area_error(const fastjet::PseudoJet & jet) const;
+
+private:
+  struct Repeat {
+    std::mt19937_64 random;
+    std::vector<fastjet::PseudoJet> ghosts;
+    std::unique_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts> clust_seq;
+    std::vector<double> area_by_key;   ///< jet area indexed by its lowest particle index
+  };
+
+  void _init();
+  void _run_repeat(unsigned int irepeat);
+  int _key(const fastjet::PseudoJet & jet) const;
+
+  fastjet::JetDefinition _jet_def;
+  std::shared_ptr<const GhostLattice> _lattice;
+  unsigned int _n_threads;
+  unsigned long _seed;
+  std::vector<Repeat> _repeats;
+  std::shared_ptr<ThreadPool> _pool;   ///< runs the repetitions after the first
+
+  const std::vector<fastjet::PseudoJet> * _particles;
+  unsigned long _event_number;
+  std::vector<int> _key_of_jet;        ///< first-repetition history index -> key
+  std::vector<double> _area_sum, _area2_sum;
+  std::vector<unsigned int> _area_count;
+
+  CachedGhostClustering & operator=(const CachedGhostClustering &);
+};
+
+} // namespace fcc
+
+#endif // __FCC_GHOSTLATTICE_HH__
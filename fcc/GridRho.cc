@@ -0,0 +1,167 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::GridRhoEstimator
+//----------------------------------------------------------------------
+#include "fcc/GridRho.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+const double twopi = 2*M_PI;
+
+// the percentile of the n values in v (which get reordered), with
+// FastJet's definition (BackgroundEstimatorBase::_percentile, no
+// empty jets): linear interpolation at position n*fraction - 0.5
+double percentile(double * v, unsigned int n, double fraction){
+  if (n == 0) return 0.0;
+  if (n == 1) return v[0];
+  double position = n*fraction - 0.5;
+  if (position < 0){
+    nth_element(v, v, v+n);
+    return v[0];
+  }
+  unsigned int index = int(position);
+  if (index+1 > n-1){
+    index = n-2;
+    position = n-1;
+  }
+  nth_element(v, v+index, v+n);
+  double next = *min_element(v+index+1, v+n);
+  return v[index]*(index+1-position) + next*(position-index);
+}
+
+}
+
+//----------------------------------------------------------------------
+// the grid of fastjet::RectangularGrid(max_rap, cell_size)
+GridRhoEstimator::GridRhoEstimator(double max_rap, double cell_size)
+  : _max_rap(max_rap), _band(0.0), _rho(0.0), _sigma(0.0){
+  if ((max_rap <= 0) || (cell_size <= 0))
+    throw Error("GridRhoEstimator: max_rap and cell_size must be positive");
+  _n_rap = int(max(1.0, 2*max_rap/cell_size + 0.5));
+  _n_phi = int(max(1.0, twopi/cell_size + 0.5));
+  _drap = 2*max_rap/_n_rap;
+  _dphi = twopi/_n_phi;
+  _rho_row.assign(_n_rap, 0.0);
+  _sigma_row.assign(_n_rap, 0.0);
+}
+
+//----------------------------------------------------------------------
+void GridRhoEstimator::set_rapidity_band(double width){
+  if (width < 0) throw Error("GridRhoEstimator: the rapidity band cannot be negative");
+  _band = width;
+}
+
+//----------------------------------------------------------------------
+string GridRhoEstimator::description() const{
+  ostringstream oss;
+  oss << "grid-median rho on " << _n_rap << " x " << _n_phi << " cells of "
+      << _drap << " x " << _dphi << " up to |y| = " << _max_rap;
+  if (_band > 0) oss << ", rho(y) over rapidity bands of width " << _band;
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void GridRhoEstimator::set_particles(const vector<PseudoJet> & particles){
+  if (_rescaling_class && (_band > 0))
+    throw Error("GridRhoEstimator: a rapidity band cannot be combined with a rescaling class");
+  unsigned int n = particles.size();
+  _rap.resize(n);
+  _phi.resize(n);
+  _pt.resize(n);
+  _cell.resize(n);
+  for (unsigned int i = 0; i < n; i++){
+    _rap[i] = particles[i].rap();
+    _phi[i] = particles[i].phi();
+    _pt[i]  = particles[i].pt();
+  }
+
+  // cell of each particle (-1 outside the grid), then the pt sums
+  const double inverse_drap = _n_rap/(2*_max_rap), inverse_dphi = _n_phi/twopi;
+  const int n_rap = _n_rap, n_phi = _n_phi;
+  const double * rap = _rap.data();
+  const double * phi = _phi.data();
+  int * cell = _cell.data();
+  for (unsigned int i = 0; i < n; i++){
+    double y = rap[i] + _max_rap;
+    int row = int(y*inverse_drap);
+    int column = int(phi[i]*inverse_dphi);
+    column = (column == n_phi) ? 0 : column;
+    cell[i] = ((y < 0) || (row >= n_rap)) ? -1 : row*n_phi + column;
+  }
+  unsigned int n_cells = _n_rap*_n_phi;
+  _cell_pt.assign(n_cells, 0.0);
+  for (unsigned int i = 0; i < n; i++){
+    if (cell[i] >= 0) _cell_pt[cell[i]] += _pt[i];
+  }
+
+  // the densities, and their median over the whole grid. As in
+  // GridMedianBackgroundEstimator, with a rescaling class each
+  // density is divided by the rescaling at the centre of its cell,
+  // and rho(jet) multiplies the median back by it.
+  double area = _drap*_dphi;
+  _density.resize(n_cells);
+  const double * cell_pt = _cell_pt.data();
+  double * density = _density.data();
+  for (unsigned int c = 0; c < n_cells; c++) density[c] = cell_pt[c]/area;
+  if (_rescaling_class){
+    PseudoJet centre;
+    for (int r = 0; r < n_rap; r++){
+      for (int p = 0; p < n_phi; p++){
+        centre.reset_PtYPhiM(1.0, -_max_rap + (r+0.5)*_drap, (p+0.5)*_dphi);
+        density[r*n_phi + p] /= (*_rescaling_class)(centre);
+      }
+    }
+  }
+  _scratch = _density;
+  _median_and_sigma(_scratch, _rho, _sigma);
+
+  // the rho(y) profile, one value per row
+  if (_band <= 0){
+    fill(_rho_row.begin(), _rho_row.end(), _rho);
+    fill(_sigma_row.begin(), _sigma_row.end(), _sigma);
+    return;
+  }
+  int half_rows = int(0.5*_band/_drap + 0.5);
+  for (int r = 0; r < n_rap; r++){
+    int first = max(0, r - half_rows), last = min(n_rap-1, r + half_rows);
+    _scratch.assign(_density.begin() + first*n_phi, _density.begin() + (last+1)*n_phi);
+    _median_and_sigma(_scratch, _rho_row[r], _sigma_row[r]);
+  }
+}
+
+//----------------------------------------------------------------------
+// median, and sigma from the 16% quantile, as in FastJet
+void GridRhoEstimator::_median_and_sigma(vector<double> & densities, double & rho, double & sigma) const{
+  unsigned int n = densities.size();
+  rho = percentile(densities.data(), n, 0.5);
+  double lower = percentile(densities.data(), n, (1.0-0.6827)/2.0);
+  sigma = (rho - lower)*sqrt(_drap*_dphi);
+}
+
+//----------------------------------------------------------------------
+unsigned int GridRhoEstimator::_row(double rap) const{
+  int row = int(floor((rap + _max_rap)/_drap));
+  return min(max(row, 0), int(_n_rap)-1);
+}
+
+//----------------------------------------------------------------------
+double GridRhoEstimator::rho(const PseudoJet & jet){
+  if (_band > 0) return _rho_row[_row(jet.rap())];
+  return _rescaling_class ? _rho*(*_rescaling_class)(jet) : _rho;
+}
+
+double GridRhoEstimator::sigma(const PseudoJet & jet){
+  if (_band > 0) return _sigma_row[_row(jet.rap())];
+  return _rescaling_class ? _sigma*(*_rescaling_class)(jet) : _sigma;
+}
+
+} // namespace fcc
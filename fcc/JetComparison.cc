@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of the jet comparisons
+//----------------------------------------------------------------------
+#include "fcc/JetComparison.hh"
+#include <algorithm>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+// the constituents of a jet as sorted history indices (for the
+// particles of a ClusterSequence, their position in the input)
+static vector<int> constituent_indices(const PseudoJet & jet){
+  vector<PseudoJet> constituents = jet.constituents();
+  vector<int> indices(constituents.size());
+  for (unsigned int i = 0; i < constituents.size(); i++)
+    indices[i] = constituents[i].cluster_hist_index();
+  sort(indices.begin(), indices.end());
+  return indices;
+}
+
+//----------------------------------------------------------------------
+bool same_jets(const vector<PseudoJet> & jets1, const vector<PseudoJet> & jets2){
+  if (jets1.size() != jets2.size()) return false;
+  for (unsigned int i = 0; i < jets1.size(); i++){
+    const PseudoJet & a = jets1[i], & b = jets2[i];
+    if ((a.px() != b.px()) || (a.py() != b.py()) || (a.pz() != b.pz()) || (a.E() != b.E())) return false;
+    if (constituent_indices(a) != constituent_indices(b)) return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool same_clustering(const ClusterSequence & cs1, const ClusterSequence & cs2,
+                     bool compare_exclusive){
+  // the d_ij come in the order of the recombinations, so that exact
+  // ties resolved differently still give the same sequence
+  const vector<ClusterSequence::history_element> & history1 = cs1.history();
+  const vector<ClusterSequence::history_element> & history2 = cs2.history();
+  if (history1.size() != history2.size()) return false;
+  for (unsigned int h = 0; h < history1.size(); h++)
+    if (history1[h].dij != history2[h].dij) return false;
+
+  if (!same_jets(sorted_by_pt(cs1.inclusive_jets()), sorted_by_pt(cs2.inclusive_jets()))) return false;
+
+  if (compare_exclusive){
+    for (unsigned int n = 2; (n <= 8) && (n <= cs1.n_particles()); n *= 2){
+      if (!same_jets(sorted_by_pt(cs1.exclusive_jets(int(n))),
+                     sorted_by_pt(cs2.exclusive_jets(int(n))))) return false;
+    }
+  }
+  return true;
+}
+
+} // namespace fcc
@@ -0,0 +1,31 @@
+//----------------------------------------------------------------------
+/// \file
+/// Exact comparison of jets and clusterings, used by the benchmarks
+/// to check that a faster route gives the ClusterSequence result
+//----------------------------------------------------------------------
+#ifndef __FCC_JETCOMPARISON_HH__
+#define __FCC_JETCOMPARISON_HH__
+
+#include "fastjet/ClusterSequence.hh"
+#include <vector>
+
+namespace fcc {
+
+/// true if the two sets of jets are identical: same number of jets,
+/// same four-momenta bit for bit, and the same constituents (compared
+/// as sets of positions among the clustering inputs, since the order
+/// in which they are listed depends on the history)
+bool same_jets(const std::vector<fastjet::PseudoJet> & jets1,
+               const std::vector<fastjet::PseudoJet> & jets2);
+
+/// true if the two clusterings of the same particles are identical:
+/// same sequence of d_ij in their histories, same inclusive jets and,
+/// if compare_exclusive is true, the same exclusive jets for n = 2, 4
+/// and 8 (jets compared in order of pt)
+bool same_clustering(const fastjet::ClusterSequence & cs1,
+                     const fastjet::ClusterSequence & cs2,
+                     bool compare_exclusive);
+
+} // namespace fcc
+
+#endif // __FCC_JETCOMPARISON_HH__
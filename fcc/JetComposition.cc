@@ -0,0 +1,62 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::JetComposition
+//----------------------------------------------------------------------
+#include "fcc/JetComposition.hh"
+#include "fastjet/Error.hh"
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+void JetComposition::process(const ClusterSequence & cs, const ParticleInfo & info,
+                             const vector<PseudoJet> & jets){
+  const vector<ClusterSequence::history_element> & history = cs.history();
+  _n_jets = jets.size();
+  _sums.assign(4*n_groups*_n_jets, 0.0);
+  _jet_pt.resize(_n_jets);
+
+  // the jets' own history elements, then everything below them: the
+  // child of an element always comes later in the history
+  _jet_of.assign(history.size(), -1);
+  for (unsigned int ijet = 0; ijet < _n_jets; ijet++){
+    if (!jets[ijet].has_associated_cluster_sequence() ||
+        (jets[ijet].associated_cluster_sequence() != &cs))
+      throw Error("JetComposition: the jets must come from the ClusterSequence given");
+    _jet_of[jets[ijet].cluster_hist_index()] = ijet;
+    _jet_pt[ijet] = jets[ijet].pt();
+  }
+  for (int h = int(history.size())-1; h >= 0; h--){
+    int child = history[h].child;
+    if ((_jet_of[h] < 0) && (child >= 0)) _jet_of[h] = _jet_of[child];
+  }
+
+  // the input particles are the first n_particles() elements
+  const vector<PseudoJet> & cs_jets = cs.jets();
+  for (unsigned int h = 0; h < cs.n_particles(); h++){
+    int ijet = _jet_of[h];
+    if (ijet < 0) continue;
+    const PseudoJet & particle = cs_jets[history[h].jetp_index];
+    int index = particle.user_index();
+    if (index < 0) continue;
+
+    int pdg_id = info.pdg_id(index);
+    Group groups[3];
+    unsigned int n = 0;
+    groups[n++] = (info.vertex(index) == 0) ? hard : pileup;
+    groups[n++] = (info.charge(index) != 0) ? charged : neutral;
+    if ((pdg_id == 22) || (pdg_id == 111)) groups[n++] = photon_pi0;
+
+    for (unsigned int ig = 0; ig < n; ig++){
+      double * p = &_sums[4*(n_groups*ijet + groups[ig])];
+      p[0] += particle.px();
+      p[1] += particle.py();
+      p[2] += particle.pz();
+      p[3] += particle.E();
+    }
+  }
+}
+
+} // namespace fcc
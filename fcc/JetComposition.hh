@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------
+/// \file
+/// Per-jet momentum sums by origin (hard/pileup vertex) and particle
+/// class, from a single walk over the clustering history
+//----------------------------------------------------------------------
+#ifndef __FCC_JETCOMPOSITION_HH__
+#define __FCC_JETCOMPOSITION_HH__
+
+#include "fcc/ParticleInfo.hh"
+#include "fastjet/ClusterSequence.hh"
+#include <cmath>
+#include <vector>
+
+namespace fcc {
+
+/// \class JetComposition
+/// the composition of all the jets of an event
+///
+/// process() assigns every history element of the ClusterSequence to
+/// the jet it ends up in, walking the history once backwards from
+/// the jets (a child always comes after its parents), and adds the
+/// momentum of each input particle to the sums of its jet. The cost
+/// is O(N) for all the jets together, with no constituents() vector
+/// and no Selector.
+///
+/// The groups are
+///  - hard:       particles from vertex 0 (the hard interaction)
+///  - pileup:     particles from the other vertices
+///  - charged:    particles with a non-zero charge
+///  - neutral:    the other particles
+///  - photon_pi0: photons and neutral pions (a subset of neutral)
+/// taken from an fcc::ParticleInfo through the particles' user
+/// indices. Particles without a user index (e.g. area ghosts) are
+/// not counted.
+class JetComposition {
+public:
+  enum Group { hard, pileup, charged, neutral, photon_pi0, n_groups };
+
+  JetComposition() : _n_jets(0) {}
+
+  /// the composition of "jets", which must all come from "cs", with
+  /// the metadata of "info" (filled with the event clustered)
+  void process(const fastjet::ClusterSequence & cs, const ParticleInfo & info,
+               const std::vector<fastjet::PseudoJet> & jets);
+
+  /// number of jets of the last call
+  unsigned int n_jets() const { return _n_jets; }
+
+  /// sum of the four-momenta of the particles of group g in jet ijet
+  fastjet::PseudoJet sum(unsigned int ijet, Group g) const {
+    const double * p = &_sums[4*(n_groups*ijet + g)];
+    return fastjet::PseudoJet(p[0], p[1], p[2], p[3]);
+  }
+
+  /// transverse momentum of group g in jet ijet
+  double pt(unsigned int ijet, Group g) const {
+    const double * p = &_sums[4*(n_groups*ijet + g)];
+    return std::sqrt(p[0]*p[0] + p[1]*p[1]);
+  }
+
+  /// the pt of group g over the pt of the jet (0 for a jet with no pt)
+  double fraction(unsigned int ijet, Group g) const {
+    return (_jet_pt[ijet] > 0) ? pt(ijet, g)/_jet_pt[ijet] : 0.0;
+  }
+
+  /// shortcuts for the most common quantities
+  double pt_hard(unsigned int ijet)   const { return pt(ijet, hard); }
+  double pt_pileup(unsigned int ijet) const { return pt(ijet, pileup); }
+  double neutral_fraction(unsigned int ijet) const { return fraction(ijet, neutral); }
+
+private:
+  unsigned int _n_jets;
+  std::vector<int> _jet_of;     ///< jet of each history element (-1: none)
+  std::vector<double> _sums;    ///< px,py,pz,E per jet and group
+  std::vector<double> _jet_pt;  ///< pt of each jet
+};
+
+} // namespace fcc
+
+#endif // __FCC_JETCOMPOSITION_HH__
@@ -0,0 +1,127 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::JetDefinitionScan
+//----------------------------------------------------------------------
+#include "fcc/JetDefinitionScan.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+JetDefinitionScan::JetDefinitionScan(const vector<JetDefinition> & jet_defs, const vector<double> & ptmins)
+  : _jet_defs(jet_defs), _ptmins(ptmins), _n_events(0){
+  if (jet_defs.empty() || ptmins.empty())
+    throw Error("JetDefinitionScan: needs at least one jet definition and one ptmin");
+  _ptmin_min = *min_element(ptmins.begin(), ptmins.end());
+  _table.resize(n_configurations());
+}
+
+//----------------------------------------------------------------------
+string JetDefinitionScan::description() const{
+  ostringstream oss;
+  oss << "scan of " << _jet_defs.size() << " jet definitions x " << _ptmins.size()
+      << " ptmin values, one clustering per jet definition and event";
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void JetDefinitionScan::process(const vector<Event> & events, ThreadPool & pool){
+  // the particles of every event, with rapidity and phi evaluated
+  _particles.resize(events.size());
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    pool.submit([this, &events, iev](unsigned int){
+        vector<PseudoJet> & particles = _particles[iev];
+        particles = events[iev].pseudojets();
+        for (unsigned int i = 0; i < particles.size(); i++) particles[i].rap();
+      });
+  }
+  pool.wait();
+
+  // one clustering per event and jet definition, each filling the
+  // rows of its configurations
+  vector<vector<Row> > rows(events.size()*n_configurations());
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    for (unsigned int idef = 0; idef < _jet_defs.size(); idef++){
+      unsigned long event_number = _n_events + iev;
+      pool.submit([this, &rows, iev, idef, event_number](unsigned int){
+          _cluster(iev, idef, event_number, rows);
+        });
+    }
+  }
+  pool.wait();
+
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    for (unsigned int iconfig = 0; iconfig < n_configurations(); iconfig++){
+      const vector<Row> & event_rows = rows[iev*n_configurations() + iconfig];
+      _table[iconfig].insert(_table[iconfig].end(), event_rows.begin(), event_rows.end());
+    }
+  }
+  _n_events += events.size();
+  _particles.clear();
+}
+
+//----------------------------------------------------------------------
+void JetDefinitionScan::_cluster(unsigned int iev, unsigned int idef, unsigned long event_number,
+                                 vector<vector<Row> > & rows) const{
+  ClusterSequence cs(_particles[iev], _jet_defs[idef]);
+  vector<PseudoJet> jets = sorted_by_pt(cs.inclusive_jets(_ptmin_min));
+
+  // the jets above each ptmin lead the list (inclusive_jets() keeps
+  // perp2 >= ptmin^2, and the list is sorted by decreasing perp2)
+  for (unsigned int iptmin = 0; iptmin < _ptmins.size(); iptmin++){
+    vector<Row> & config_rows = rows[iev*n_configurations() + configuration(idef, iptmin)];
+    double ptmin2 = _ptmins[iptmin]*_ptmins[iptmin];
+    for (unsigned int ijet = 0; (ijet < jets.size()) && (jets[ijet].perp2() >= ptmin2); ijet++){
+      Row row;
+      row.event = event_number;
+      row.jet = ijet;
+      row.pt  = jets[ijet].perp();
+      row.rap = jets[ijet].rap();
+      row.phi = jets[ijet].phi();
+      row.m   = jets[ijet].m();
+      config_rows.push_back(row);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+void JetDefinitionScan::write(ostream & ostr) const{
+  write_legend(ostr);
+  write_rows(ostr);
+}
+
+//----------------------------------------------------------------------
+void JetDefinitionScan::write_legend(ostream & ostr) const{
+  for (unsigned int iconfig = 0; iconfig < n_configurations(); iconfig++){
+    ostr << "# configuration " << iconfig << ": " << jet_def(iconfig).description()
+         << ", pt > " << ptmin(iconfig) << " GeV" << endl;
+  }
+  ostr << "#  config    event  jet           pt          rap          phi            m" << endl;
+}
+
+//----------------------------------------------------------------------
+void JetDefinitionScan::write_rows(ostream & ostr) const{
+  char line[128];
+  for (unsigned int iconfig = 0; iconfig < n_configurations(); iconfig++){
+    const vector<Row> & config_rows = _table[iconfig];
+    for (unsigned int i = 0; i < config_rows.size(); i++){
+      const Row & row = config_rows[i];
+      snprintf(line, sizeof(line), "%9u %8lu %4u %12.5f %12.6f %12.6f %12.5f\n",
+               iconfig, row.event, row.jet, row.pt, row.rap, row.phi, row.m);
+      ostr << line;
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+void JetDefinitionScan::clear(){
+  for (unsigned int iconfig = 0; iconfig < _table.size(); iconfig++) _table[iconfig].clear();
+}
+
+} // namespace fcc
@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------
+/// \file
+/// Inclusive jets of the same events for many jet definitions and
+/// ptmin values, with the input prepared once per event
+//----------------------------------------------------------------------
+#ifndef __FCC_JETDEFINITIONSCAN_HH__
+#define __FCC_JETDEFINITIONSCAN_HH__
+
+#include "fcc/Event.hh"
+#include "fcc/ThreadPool.hh"
+#include "fastjet/ClusterSequence.hh"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class JetDefinitionScan
+/// sorted_by_pt(ClusterSequence(particles, jet_def).inclusive_jets(ptmin))
+/// for every event and every (jet_def, ptmin) configuration, collected
+/// into one table per configuration
+///
+/// process() takes a batch of events and a thread pool. The particles
+/// of each event are built once, and their rapidity and phi (which a
+/// PseudoJet only computes when first asked for) are evaluated right
+/// away, so that the copies made by every ClusterSequence start with
+/// them instead of each recomputing them. This also makes the shared
+/// particles safe to read from several threads. Each (event, jet_def)
+/// pair is then one task on the pool: the configurations of a jet
+/// definition that only differ in ptmin share its clustering, and
+/// take the leading jets of the list for the smallest ptmin.
+///
+/// The jets are the same, in the same order, as those of a separate
+/// ClusterSequence per configuration. Recombination schemes other than
+/// the E scheme still preprocess their own copy of the particles.
+///
+/// To keep the memory bounded on long inputs, the rows of each batch
+/// can be streamed out with write_rows() and then dropped with
+/// clear(); the event numbers carry on across the batches.
+class JetDefinitionScan {
+public:
+  /// one jet of the table
+  struct Row {
+    unsigned long event;  ///< number of the event, counted from 0 over all the batches
+    unsigned int jet;     ///< position of the jet in its event (by decreasing pt)
+    double pt, rap, phi, m;
+  };
+
+  /// every jet definition is run with every ptmin
+  JetDefinitionScan(const std::vector<fastjet::JetDefinition> & jet_defs,
+                    const std::vector<double> & ptmins);
+
+  std::string description() const;
+
+  /// add the jets of "events" to the table
+  void process(const std::vector<Event> & events, ThreadPool & pool);
+
+  /// number of configurations, and index of the configuration (idef, iptmin)
+  unsigned int n_configurations() const { return _jet_defs.size()*_ptmins.size(); }
+  unsigned int configuration(unsigned int idef, unsigned int iptmin) const {
+    return idef*_ptmins.size() + iptmin;
+  }
+
+  /// the jet definition and ptmin of configuration iconfig
+  const fastjet::JetDefinition & jet_def(unsigned int iconfig) const { return _jet_defs[iconfig/_ptmins.size()]; }
+  double ptmin(unsigned int iconfig) const { return _ptmins[iconfig%_ptmins.size()]; }
+
+  /// number of events processed so far
+  unsigned long n_events() const { return _n_events; }
+
+  /// the jets of configuration iconfig, by event and then by decreasing pt
+  const std::vector<Row> & jets(unsigned int iconfig) const { return _table[iconfig]; }
+
+  /// write the table: a legend of the configurations, then one line
+  /// per jet keyed by configuration
+  void write(std::ostream & ostr) const;
+
+  /// write the legend of the configurations and the column names
+  void write_legend(std::ostream & ostr) const;
+
+  /// write one line per jet currently in the table, keyed by
+  /// configuration (without the legend)
+  void write_rows(std::ostream & ostr) const;
+
+  /// empty the table; the event count is kept, so that the rows of
+  /// the next batches go on numbering the events from there
+  void clear();
+
+private:
+  void _cluster(unsigned int iev, unsigned int idef, unsigned long event_number,
+                std::vector<std::vector<Row> > & rows) const;
+
+  std::vector<fastjet::JetDefinition> _jet_defs;
+  std::vector<double> _ptmins;
+  double _ptmin_min;
+  unsigned long _n_events;
+  std::vector<std::vector<fastjet::PseudoJet> > _particles;  ///< of the current batch
+  std::vector<std::vector<Row> > _table;
+};
+
+} // namespace fcc
+
+#endif // __FCC_JETDEFINITIONSCAN_HH__
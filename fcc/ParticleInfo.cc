@@ -0,0 +1,48 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::ParticleInfo
+//----------------------------------------------------------------------
+#include "fcc/ParticleInfo.hh"
+#include <cstdlib>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+// the three columns are consecutive slices of one block
+void ParticleInfo::fill(const Event & event){
+  _n = event.size();
+  _has_pdg_id = event.has_pdg_id();
+  if (_arena.size() < 3*_n) _arena.resize(3*_n);
+  _pdg_id = _arena.data();
+  _vertex = _pdg_id + _n;
+  _charge = _vertex + _n;
+
+  const int * pdg_id = event.pdg_id();
+  const int * subevent = event.subevent();
+  for (unsigned int i = 0; i < _n; i++){
+    _pdg_id[i] = pdg_id[i];
+    _vertex[i] = subevent[i];
+    _charge[i] = charge_of(pdg_id[i]);
+  }
+}
+
+//----------------------------------------------------------------------
+// the long-lived charged particles (antiparticles have the opposite
+// charge)
+int ParticleInfo::charge_of(int pdg_id){
+  int charge = 0;
+  switch (abs(pdg_id)){
+  case 11: case 13: case 15:              // e-, mu-, tau-
+  case 3112: case 3312: case 3334:        // Sigma-, Xi-, Omega-
+    charge = -1; break;
+  case 211: case 321: case 411: case 431: // pi+, K+, D+, Ds+
+  case 2212: case 3222:                   // p, Sigma+
+    charge = 1; break;
+  }
+  return (pdg_id < 0) ? -charge : charge;
+}
+
+} // namespace fcc
@@ -0,0 +1,79 @@
+//----------------------------------------------------------------------
+/// \file
+/// Per-event particle metadata (PDG id, vertex, charge) kept in
+/// columns and looked up through the PseudoJet user index
+//----------------------------------------------------------------------
+#ifndef __FCC_PARTICLEINFO_HH__
+#define __FCC_PARTICLEINFO_HH__
+
+#include "fcc/Event.hh"
+#include <vector>
+
+namespace fcc {
+
+/// \class ParticleInfo
+/// the PDG id, vertex number and charge of the particles of one event
+///
+/// This replaces a PseudoJet::UserInfoBase allocated per particle
+/// (as in userInfo09): the three quantities are columns of a single
+/// block, filled once per event, and a particle finds its entries
+/// through its user index (its position in the event, as set by
+/// Event::pseudojet()). The accessors are plain array loads, with no
+/// allocation, reference counting or dynamic_cast.
+///
+/// fill() reuses the block of the previous event, so that after the
+/// first few events nothing is allocated any more; release() drops
+/// the content of the event in one go.
+///
+/// The vertex number is the sub-event (0 for the hard interaction)
+/// and the charge, in units of e, is derived from the PDG id (0 when
+/// the PDG id is unknown).
+class ParticleInfo {
+public:
+  ParticleInfo() : _n(0), _has_pdg_id(false),
+                   _pdg_id(0), _vertex(0), _charge(0) {}
+
+  /// take the metadata of the particles of "event"
+  void fill(const Event & event);
+
+  /// forget the current event (the memory is kept for the next one)
+  void release() {
+    _n = 0;
+    _has_pdg_id = false;
+  }
+
+  /// number of particles
+  unsigned int size() const { return _n; }
+
+  /// true if the event came with PDG ids
+  bool has_pdg_id() const { return _has_pdg_id; }
+
+  /// the information of particle i
+  int pdg_id(unsigned int i) const { return _pdg_id[i]; }
+  int vertex(unsigned int i) const { return _vertex[i]; }
+  int charge(unsigned int i) const { return _charge[i]; }
+
+  /// the information of a particle of the event (user index >= 0)
+  int pdg_id(const fastjet::PseudoJet & p) const { return _pdg_id[p.user_index()]; }
+  int vertex(const fastjet::PseudoJet & p) const { return _vertex[p.user_index()]; }
+  int charge(const fastjet::PseudoJet & p) const { return _charge[p.user_index()]; }
+
+  /// the columns themselves
+  const int * pdg_ids()  const { return _pdg_id; }
+  const int * vertices() const { return _vertex; }
+  const int * charges()  const { return _charge; }
+
+  /// the charge (in units of e) of the final-state particle with this
+  /// PDG id, 0 for neutral or unknown ones
+  static int charge_of(int pdg_id);
+
+protected:
+  unsigned int _n;
+  bool _has_pdg_id;
+  std::vector<int> _arena;          ///< the storage of all three columns
+  int *_pdg_id, *_vertex, *_charge; ///< the columns, inside _arena
+};
+
+} // namespace fcc
+
+#endif // __FCC_PARTICLEINFO_HH__
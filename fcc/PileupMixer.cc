@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::PileupMixer
+//----------------------------------------------------------------------
+#include "fcc/PileupMixer.hh"
+#include "fastjet/Error.hh"
+#include <cmath>
+
+using namespace std;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+void PileupMixer::add_to_pool(const Event & event, unsigned int first_subevent){
+  for (unsigned int isub = first_subevent; isub < event.n_subevents(); isub++){
+    unsigned int begin = event.subevent_begin(isub), end = event.subevent_end(isub);
+    if (begin == end) continue;
+
+    _pool.start_subevent();
+    _pool_starts.push_back(_pool.size());
+    for (unsigned int i = begin; i < end; i++){
+      if (event.has_pdg_id())
+        _pool.add_particle(event.px()[i], event.py()[i], event.pz()[i], event.E()[i], event.pdg_id(i));
+      else
+        _pool.add_particle(event.px()[i], event.py()[i], event.pz()[i], event.E()[i]);
+    }
+    _pool_ends.push_back(_pool.size());
+  }
+}
+
+//----------------------------------------------------------------------
+unsigned int PileupMixer::n_pileup(double mu, bool poisson){
+  if (!poisson) return (unsigned int)(mu+0.5);
+  poisson_distribution<unsigned int> distribution(mu);
+  return distribution(_random);
+}
+
+//----------------------------------------------------------------------
+void PileupMixer::mix(const Event & hard, unsigned int hard_subevent,
+                      unsigned int n_pileup, Event & mixed){
+  if ((n_pileup > 0) && _pool_starts.empty())
+    throw fastjet::Error("PileupMixer: the minimum-bias pool is empty");
+
+  // the hard interaction is always sub-event 0, even when it is empty
+  mixed.clear();
+  mixed.start_subevent(true);
+  bool with_pdg_id = hard.has_pdg_id();
+  for (unsigned int i = hard.subevent_begin(hard_subevent); i < hard.subevent_end(hard_subevent); i++){
+    if (with_pdg_id)
+      mixed.add_particle(hard.px()[i], hard.py()[i], hard.pz()[i], hard.E()[i], hard.pdg_id(i));
+    else
+      mixed.add_particle(hard.px()[i], hard.py()[i], hard.pz()[i], hard.E()[i]);
+  }
+
+  uniform_int_distribution<unsigned int> pick(0, _pool_starts.size()-1);
+  uniform_real_distribution<double> angle(0.0, 2*M_PI);
+  for (unsigned int ipu = 0; ipu < n_pileup; ipu++){
+    mixed.start_subevent(true);
+    unsigned int ipool = pick(_random);
+    _add_rotated(ipool, angle(_random), mixed);
+  }
+}
+
+//----------------------------------------------------------------------
+// rotation by phi around the beam axis
+void PileupMixer::_add_rotated(unsigned int ipool, double phi, Event & mixed) const{
+  double c = cos(phi), s = sin(phi);
+  const double *px = _pool.px(), *py = _pool.py(), *pz = _pool.pz(), *E = _pool.E();
+  bool with_pdg_id = _pool.has_pdg_id();
+  for (unsigned int i = _pool_starts[ipool]; i < _pool_ends[ipool]; i++){
+    double px_rot = c*px[i] - s*py[i];
+    double py_rot = s*px[i] + c*py[i];
+    if (with_pdg_id) mixed.add_particle(px_rot, py_rot, pz[i], E[i], _pool.pdg_id(i));
+    else             mixed.add_particle(px_rot, py_rot, pz[i], E[i]);
+  }
+}
+
+} // namespace fcc
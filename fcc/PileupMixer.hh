@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------
+/// \file
+/// Overlay of minimum-bias sub-events on a hard event, to build
+/// synthetic high-pileup events (e.g. mu=200 for the HL-LHC or
+/// mu=1000 for FCC-hh) from the pileup files in data/
+//----------------------------------------------------------------------
+#ifndef __FCC_PILEUPMIXER_HH__
+#define __FCC_PILEUPMIXER_HH__
+
+#include "fcc/Event.hh"
+#include <random>
+#include <vector>
+
+namespace fcc {
+
+/// \class PileupMixer
+/// resamples minimum-bias sub-events on top of a hard event
+///
+/// The minimum-bias pool is filled from the sub-events 1, 2, ... of
+/// pileup events (sub-event 0 being the hard interaction). Every
+/// overlaid sub-event is drawn at random from the pool (with
+/// replacement) and rotated by a random azimuthal angle, so that
+/// reusing the same few minbias collisions many times does not
+/// introduce artificial correlations in phi.
+class PileupMixer {
+public:
+  /// create a mixer with an empty pool
+  PileupMixer(unsigned long seed = 1) : _random(seed) {}
+
+  /// add sub-events [first_subevent, n_subevents) of "event" to the
+  /// minimum-bias pool
+  void add_to_pool(const Event & event, unsigned int first_subevent = 1);
+
+  /// number of sub-events in the minimum-bias pool
+  unsigned int pool_size() const { return _pool_starts.size(); }
+
+  /// true if every particle in the pool came with a PDG id
+  bool pool_has_pdg_id() const { return _pool.has_pdg_id(); }
+
+  /// number of pileup sub-events to overlay for an average of mu
+  /// (a Poisson draw if "poisson" is true, mu itself otherwise)
+  unsigned int n_pileup(double mu, bool poisson);
+
+  /// build in "mixed" the sub-event "hard_subevent" of "hard", as
+  /// sub-event 0, followed by n_pileup minbias sub-events. Sub-event 0
+  /// is there even when the hard sub-event is empty, so that pileup
+  /// is never mistaken for the hard interaction.
+  void mix(const Event & hard, unsigned int hard_subevent,
+           unsigned int n_pileup, Event & mixed);
+
+protected:
+  void _add_rotated(unsigned int ipool, double phi, Event & mixed) const;
+
+  std::mt19937_64 _random;
+
+  // the pool is stored as one "event" with contiguous sub-events
+  Event _pool;
+  std::vector<unsigned int> _pool_starts, _pool_ends;
+};
+
+} // namespace fcc
+
+#endif // __FCC_PILEUPMIXER_HH__
@@ -0,0 +1,273 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::PuppiWeighter
+//----------------------------------------------------------------------
+#include "fcc/Puppi.hh"
+#include "fcc/ParticleInfo.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+const double pi = M_PI, twopi = 2*M_PI;
+
+/// |rapidity| beyond which particles all go in the edge tiles
+const double max_tiled_rap = 10.0;
+
+/// the contribution (pt_j/DeltaR)^2 of a neighbour j, 0 outside
+/// Rmin <= DeltaR < R0
+inline double alpha_term(double rap_i, double phi_i, double rap_j, double phi_j, double pt2_j,
+                         double R02, double Rmin2){
+  double dphi = std::abs(phi_i - phi_j);
+  if (dphi > pi) dphi = twopi - dphi;
+  double drap = rap_i - rap_j;
+  double dR2 = drap*drap + dphi*dphi;
+  if ((dR2 >= R02) || (dR2 < Rmin2)) return 0.0;
+  return pt2_j/dR2;
+}
+
+}
+
+//----------------------------------------------------------------------
+string PuppiWeighter::description() const{
+  ostringstream oss;
+  oss << "PUPPI weights with R0 = " << _parameters.R0 << ", Rmin = " << _parameters.Rmin
+      << ", tracker up to |y| = " << _parameters.central_maxrap
+      << ", weights below " << _parameters.weight_min << " set to 0"
+      << (_naive ? " (direct neighbour sums)" : " (tiled neighbour sums)");
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+bool PuppiWeighter::is_charged(int pdg_id){
+  return ParticleInfo::charge_of(pdg_id) != 0;
+}
+
+//----------------------------------------------------------------------
+void PuppiWeighter::process(const Event & event){
+  _prepare(event);
+  if (_naive) _alphas_naive();
+  else {
+    _build_tiles();
+    _alphas_tiled();
+  }
+
+  _reference(true,  _median_central, _rms_central);
+  _reference(false, _median_forward, _rms_forward);
+
+  unsigned int n = _rap.size();
+  _weights.assign(n, 0.0);
+  for (unsigned int i = 0; i < n; i++){
+    if (_categories[i] != neutral){
+      _weights[i] = (_categories[i] == charged_lv) ? 1.0 : 0.0;
+      continue;
+    }
+    bool central = std::abs(_rap[i]) < _parameters.central_maxrap;
+    double median = central ? _median_central : _median_forward;
+    double rms    = central ? _rms_central    : _rms_forward;
+    double weight;
+    if (rms <= 0) {
+      // no reference: keep the particle
+      weight = 1.0;
+    } else if (_alphas[i] <= median) {
+      weight = 0.0;
+    } else {
+      // chi2 cumulative distribution for one degree of freedom
+      double chi2 = (_alphas[i]-median)*(_alphas[i]-median)/(rms*rms);
+      weight = erf(sqrt(0.5*chi2));
+    }
+    if (weight < _parameters.weight_min) weight = 0.0;
+    if (weight*sqrt(_pt2[i]) < _parameters.weighted_ptmin) weight = 0.0;
+    _weights[i] = weight;
+  }
+}
+
+//----------------------------------------------------------------------
+// rapidity, phi and pt^2 of the particles (as PseudoJet would compute
+// them) and their category
+void PuppiWeighter::_prepare(const Event & event){
+  _event = &event;
+  unsigned int n = event.size();
+  _rap.resize(n);
+  _phi.resize(n);
+  _pt2.resize(n);
+  _categories.resize(n);
+  const double *px = event.px(), *py = event.py(), *pz = event.pz(), *E = event.E();
+  bool has_pdg_id = event.has_pdg_id();
+  for (unsigned int i = 0; i < n; i++){
+    double kt2 = px[i]*px[i] + py[i]*py[i];
+    _pt2[i] = kt2;
+    _phi[i] = (kt2 == 0.0) ? 0.0 : atan2(py[i], px[i]);
+    if (_phi[i] < 0) _phi[i] += twopi;
+    if (_phi[i] >= twopi) _phi[i] -= twopi;
+    if ((E[i] == std::abs(pz[i])) && (kt2 == 0)){
+      double rap = 1e5 + std::abs(pz[i]);
+      _rap[i] = (pz[i] >= 0) ? rap : -rap;
+    } else {
+      double m2 = max(0.0, (E[i]+pz[i])*(E[i]-pz[i]) - kt2);
+      double E_plus_pz = E[i] + std::abs(pz[i]);
+      _rap[i] = 0.5*log((kt2 + m2)/(E_plus_pz*E_plus_pz));
+      if (pz[i] > 0) _rap[i] = -_rap[i];
+    }
+
+    bool in_tracker = std::abs(_rap[i]) < _parameters.central_maxrap;
+    bool charged = in_tracker && (has_pdg_id ? is_charged(event.pdg_id(i)) : true);
+    if (!charged) _categories[i] = neutral;
+    else _categories[i] = (event.subevent(i) == 0) ? charged_lv : charged_pu;
+  }
+}
+
+//----------------------------------------------------------------------
+// tiles at least R0 wide; the particles are sorted by tile (counting
+// sort) into contiguous arrays
+void PuppiWeighter::_build_tiles(){
+  unsigned int n = _rap.size();
+  double rap_min = max_tiled_rap, rap_max = -max_tiled_rap;
+  for (unsigned int i = 0; i < n; i++){
+    rap_min = min(rap_min, _rap[i]);
+    rap_max = max(rap_max, _rap[i]);
+  }
+  rap_min = max(rap_min, -max_tiled_rap);
+  rap_max = min(rap_max,  max_tiled_rap);
+  if (rap_max < rap_min) rap_max = rap_min;
+
+  double size = _parameters.R0 * (1 + 1e-6);
+  _rap_min = rap_min;
+  _tile_size_rap = size;
+  _n_rap = int((rap_max - rap_min)/size) + 1;
+  _n_phi = max(1, int(twopi/size));
+  _tile_size_phi = twopi/_n_phi;
+  unsigned int n_tiles = _n_rap*_n_phi;
+
+  _tile_of.resize(n);
+  _all_start.assign(n_tiles+1, 0);
+  _lv_start.assign(n_tiles+1, 0);
+  for (unsigned int i = 0; i < n; i++){
+    int iy = int(floor((_rap[i] - _rap_min)/_tile_size_rap));
+    iy = max(0, min(_n_rap-1, iy));
+    int iphi = min(_n_phi-1, int(_phi[i]/_tile_size_phi));
+    _tile_of[i] = iy*_n_phi + iphi;
+    _all_start[_tile_of[i]+1]++;
+    if (_categories[i] == charged_lv) _lv_start[_tile_of[i]+1]++;
+  }
+  for (unsigned int t = 0; t < n_tiles; t++){
+    _all_start[t+1] += _all_start[t];
+    _lv_start[t+1]  += _lv_start[t];
+  }
+
+  _all_index.resize(n);   _all_rap.resize(n);   _all_phi.resize(n);   _all_pt2.resize(n);
+  unsigned int n_lv = _lv_start[n_tiles];
+  _lv_index.resize(n_lv); _lv_rap.resize(n_lv); _lv_phi.resize(n_lv); _lv_pt2.resize(n_lv);
+  vector<unsigned int> all_fill(_all_start.begin(), _all_start.end()-1);
+  vector<unsigned int> lv_fill(_lv_start.begin(), _lv_start.end()-1);
+  for (unsigned int i = 0; i < n; i++){
+    unsigned int pos = all_fill[_tile_of[i]]++;
+    _all_index[pos] = i; _all_rap[pos] = _rap[i]; _all_phi[pos] = _phi[i]; _all_pt2[pos] = _pt2[i];
+    if (_categories[i] != charged_lv) continue;
+    pos = lv_fill[_tile_of[i]]++;
+    _lv_index[pos] = i; _lv_rap[pos] = _rap[i]; _lv_phi[pos] = _phi[i]; _lv_pt2[pos] = _pt2[i];
+  }
+}
+
+//----------------------------------------------------------------------
+void PuppiWeighter::_alphas_tiled(){
+  double R02 = _parameters.R0*_parameters.R0, Rmin2 = _parameters.Rmin*_parameters.Rmin;
+  unsigned int n = _rap.size();
+  _alphas.assign(n, 0.0);
+  int neighbours[9];
+  for (unsigned int i = 0; i < n; i++){
+    bool central = std::abs(_rap[i]) < _parameters.central_maxrap;
+    const vector<unsigned int> & start = central ? _lv_start : _all_start;
+    const vector<unsigned int> & index = central ? _lv_index : _all_index;
+    const double * rap = central ? _lv_rap.data() : _all_rap.data();
+    const double * phi = central ? _lv_phi.data() : _all_phi.data();
+    const double * pt2 = central ? _lv_pt2.data() : _all_pt2.data();
+
+    // the (distinct) tiles around that of particle i
+    int iy = _tile_of[i] / _n_phi, iphi = _tile_of[i] % _n_phi, n_neighbours = 0;
+    for (int jy = max(0, iy-1); jy <= min(_n_rap-1, iy+1); jy++){
+      for (int djphi = -1; djphi <= 1; djphi++){
+        int t = jy*_n_phi + (iphi + djphi + _n_phi) % _n_phi;
+        if (find(neighbours, neighbours + n_neighbours, t) == neighbours + n_neighbours)
+          neighbours[n_neighbours++] = t;
+      }
+    }
+
+    double sum = 0.0;
+    for (int it = 0; it < n_neighbours; it++){
+      int t = neighbours[it];
+      for (unsigned int pos = start[t]; pos < start[t+1]; pos++){
+        if (index[pos] == i) continue;
+        sum += alpha_term(_rap[i], _phi[i], rap[pos], phi[pos], pt2[pos], R02, Rmin2);
+      }
+    }
+    _alphas[i] = (sum > 0) ? log(sum) : 0.0;
+  }
+}
+
+//----------------------------------------------------------------------
+void PuppiWeighter::_alphas_naive(){
+  double R02 = _parameters.R0*_parameters.R0, Rmin2 = _parameters.Rmin*_parameters.Rmin;
+  unsigned int n = _rap.size();
+  _alphas.assign(n, 0.0);
+  for (unsigned int i = 0; i < n; i++){
+    bool central = std::abs(_rap[i]) < _parameters.central_maxrap;
+    double sum = 0.0;
+    for (unsigned int j = 0; j < n; j++){
+      if ((j == i) || (central && (_categories[j] != charged_lv))) continue;
+      sum += alpha_term(_rap[i], _phi[i], _rap[j], _phi[j], _pt2[j], R02, Rmin2);
+    }
+    _alphas[i] = (sum > 0) ? log(sum) : 0.0;
+  }
+}
+
+//----------------------------------------------------------------------
+// median and RMS (from the values below the median) of the alphas of
+// the charged PU particles (central) or of all particles (forward)
+void PuppiWeighter::_reference(bool central, double & median, double & rms) const{
+  vector<double> values;
+  for (unsigned int i = 0; i < _rap.size(); i++){
+    bool in_central = std::abs(_rap[i]) < _parameters.central_maxrap;
+    if (central ? (in_central && (_categories[i] == charged_pu)) : !in_central)
+      values.push_back(_alphas[i]);
+  }
+  median = rms = 0.0;
+  if (values.empty()) return;
+
+  unsigned int half = values.size()/2;
+  nth_element(values.begin(), values.begin() + half, values.end());
+  median = values[half];
+  if (values.size() % 2 == 0)
+    median = 0.5*(median + *max_element(values.begin(), values.begin() + half));
+
+  double sum2 = 0.0;
+  unsigned int n_below = 0;
+  for (unsigned int i = 0; i < values.size(); i++){
+    if (values[i] > median) continue;
+    sum2 += (values[i]-median)*(values[i]-median);
+    n_below++;
+  }
+  rms = sqrt(sum2/n_below);
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> PuppiWeighter::weighted_particles() const{
+  vector<PseudoJet> particles;
+  const double *px = _event->px(), *py = _event->py(), *pz = _event->pz(), *E = _event->E();
+  for (unsigned int i = 0; i < _weights.size(); i++){
+    double w = _weights[i];
+    if (w <= 0) continue;
+    particles.push_back(PseudoJet(w*px[i], w*py[i], w*pz[i], w*E[i]));
+    particles.back().set_user_index(i);
+  }
+  return particles;
+}
+
+} // namespace fcc
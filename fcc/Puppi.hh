@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------
+/// \file
+/// PUPPI (pileup per particle identification) weights, with the
+/// neighbour sums computed on a rapidity-phi tiling
+//----------------------------------------------------------------------
+#ifndef __FCC_PUPPI_HH__
+#define __FCC_PUPPI_HH__
+
+#include "fcc/Event.hh"
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class PuppiWeighter
+/// per-particle PUPPI weights for an fcc::Event
+///
+/// Within the tracker acceptance (|y| < central_maxrap), charged
+/// particles are assigned to the leading vertex (LV) or to pileup
+/// (PU) from their sub-event: sub-event 0 is the hard interaction,
+/// the others are pileup, as in userInfo09. Charged LV particles get
+/// weight 1 and charged PU ones weight 0. Charged particles are
+/// identified from the PDG id; files without PDG ids are treated as
+/// if every particle in the tracker acceptance were charged.
+///
+/// Every other ("neutral") particle i gets
+///
+///   alpha_i = log sum_j (pt_j / DeltaR_ij)^2,  Rmin < DeltaR_ij < R0
+///
+/// summed over the charged LV particles j for |y_i| < central_maxrap
+/// and over all the particles beyond (alpha = 0 for an empty sum).
+/// alpha_i is compared with the median and the RMS (on the side
+/// below the median) of the alphas of the charged PU particles in the
+/// central region, and of all the particles in the forward region:
+/// the weight is the chi2 probability F((alpha-median)^2/RMS^2) for
+/// one degree of freedom when alpha is above the median, 0 below.
+/// Weights below weight_min, or giving a pt below weighted_ptmin,
+/// are set to 0.
+///
+/// The sums only involve particles within R0, found in the 3x3
+/// tiles of a tiling at least R0 wide around each particle, so that
+/// the cost grows about linearly with the multiplicity. set_naive()
+/// switches to the direct O(N^2) sums, for validation.
+class PuppiWeighter {
+public:
+  /// the tunable parameters
+  struct Parameters {
+    Parameters() : R0(0.3), Rmin(0.02), central_maxrap(2.5),
+                   weight_min(0.1), weighted_ptmin(0.0) {}
+    double R0, Rmin;        ///< the cone used for alpha
+    double central_maxrap;  ///< tracker acceptance
+    double weight_min;      ///< smaller weights are set to 0
+    double weighted_ptmin;  ///< smaller weighted pts are set to 0
+  };
+
+  /// how a particle is treated
+  enum Category { charged_lv, charged_pu, neutral };
+
+  PuppiWeighter(const Parameters & parameters = Parameters())
+    : _parameters(parameters), _naive(false) {}
+
+  /// compute the direct O(N^2) neighbour sums instead of the tiled ones
+  void set_naive(bool naive) { _naive = naive; }
+
+  const Parameters & parameters() const { return _parameters; }
+  std::string description() const;
+
+  /// compute the weights of the particles of "event"
+  void process(const Event & event);
+
+  /// the results for the last event, indexed as the event's particles
+  const std::vector<double> & weights() const { return _weights; }
+  const std::vector<double> & alphas()  const { return _alphas; }
+  const std::vector<Category> & categories() const { return _categories; }
+
+  /// the reference median and RMS of alpha in the central and forward
+  /// regions
+  double median(bool central) const { return central ? _median_central : _median_forward; }
+  double rms(bool central)    const { return central ? _rms_central    : _rms_forward; }
+
+  /// the particles with a non-zero weight, with their four-momenta
+  /// rescaled by it (the user index is the position in the event)
+  std::vector<fastjet::PseudoJet> weighted_particles() const;
+
+  /// true for the PDG ids of (long-lived) charged particles
+  static bool is_charged(int pdg_id);
+
+private:
+  void _prepare(const Event & event);
+  void _build_tiles();
+  void _alphas_tiled();
+  void _alphas_naive();
+  double _pair_term(unsigned int i, unsigned int j) const;
+  void _reference(bool central, double & median, double & rms) const;
+
+  Parameters _parameters;
+  bool _naive;
+
+  // the particles, column-wise
+  const Event * _event;
+  std::vector<double> _rap, _phi, _pt2;
+  std::vector<Category> _categories;
+
+  // tiling: the particles of tile t are at positions
+  // [tile_start[t], tile_start[t+1]) of the sorted arrays, for all
+  // particles and for the charged LV ones only
+  double _rap_min, _tile_size_rap, _tile_size_phi;
+  int _n_rap, _n_phi;
+  std::vector<unsigned int> _all_start, _lv_start;
+  std::vector<unsigned int> _all_index, _lv_index;
+  std::vector<double> _all_rap, _all_phi, _all_pt2, _lv_rap, _lv_phi, _lv_pt2;
+  std::vector<int> _tile_of;
+
+  // results
+  std::vector<double> _alphas, _weights;
+  double _median_central, _rms_central, _median_forward, _rms_forward;
+};
+
+} // namespace fcc
+
+#endif // __FCC_PUPPI_HH__
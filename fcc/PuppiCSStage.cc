@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::PuppiCSStage
+//----------------------------------------------------------------------
+#include "fcc/PuppiCSStage.hh"
+#include "fcc/ExerciseAnalyses.hh"
+#include "fcc/Timer.hh"
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+// - rho from a grid of 0.5x0.5 cells up to |y|=5
+// - constituent subtraction with the settings of the
+//   ConstituentSubtractor event-wide example: DeltaR distance,
+//   max distance 0.3, alpha 1, ghost area 0.01
+PuppiCSStage::PuppiCSStage(bool grid_subtraction)
+  : _particle_maxrap(5.0), _ptmin(7.0),
+    _bge_rho(_particle_maxrap, 0.5),
+    _grid_subtraction(grid_subtraction),
+    _grid_subtractor(_particle_maxrap, 0.01, 0.3, 1.0),
+    _jet_def(antikt_algorithm, 0.5),
+    _rho(0.0){
+  _subtractor.set_distance_type(contrib::ConstituentSubtractor::deltaR);
+  _subtractor.set_max_distance(0.3);
+  _subtractor.set_alpha(1);
+  _subtractor.set_ghost_area(0.01);
+  _subtractor.set_max_eta(_particle_maxrap);
+  _subtractor.set_background_estimator(&_bge_rho);
+  _subtractor.set_common_bge_for_rho_and_rhom();
+  _subtractor.initialize();
+  _grid_subtractor.set_background_estimator(&_bge_rho);
+}
+
+//----------------------------------------------------------------------
+string PuppiCSStage::description() const{
+  ostringstream oss;
+  oss << _puppi.description() << "; rho: " << _bge_rho.description()
+      << "; " << (_grid_subtraction ? _grid_subtractor.description() : _subtractor.description())
+      << "; jets: " << _jet_def.description();
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void PuppiCSStage::process(const Event & event, unsigned long){
+  Timer timer;
+
+  // PUPPI weights, keeping the weighted particles in the acceptance
+  _puppi.process(event);
+  vector<PseudoJet> weighted = _puppi.weighted_particles();
+  _weighted_event.clear();
+  for (unsigned int i = 0; i < weighted.size(); i++){
+    if (abs(weighted[i].rap()) <= _particle_maxrap) _weighted_event.push_back(weighted[i]);
+  }
+  _timings.puppi = timer.elapsed();
+
+  // rho, estimated once from the weighted particles
+  timer.start();
+  _bge_rho.set_particles(_weighted_event);
+  _rho = _bge_rho.rho();
+  _timings.rho = timer.elapsed();
+
+  // event-wide constituent subtraction
+  timer.start();
+  if (_grid_subtraction) _corrected_event = _grid_subtractor.subtract_event(_weighted_event);
+  else                   _corrected_event = _subtractor.subtract_event(_weighted_event);
+  _timings.subtraction = timer.elapsed();
+
+  // jets of the corrected and of the hard event
+  timer.start();
+  _hard_event.clear();
+  for (unsigned int i = 0; i < event.size(); i++){
+    if (event.subevent(i) != 0) continue;
+    PseudoJet particle = event.pseudojet(i);
+    if (abs(particle.rap()) <= _particle_maxrap) _hard_event.push_back(particle);
+  }
+  _clust_seq_corrected.reset(new ClusterSequence(_corrected_event, _jet_def));
+  _clust_seq_hard.reset(new ClusterSequence(_hard_event, _jet_def));
+  _corrected_jets = sorted_by_pt(_clust_seq_corrected->inclusive_jets(_ptmin));
+  _hard_jets      = sorted_by_pt(_clust_seq_hard->inclusive_jets(_ptmin));
+  _timings.clustering = timer.elapsed();
+}
+
+//----------------------------------------------------------------------
+// rho, the step timings, and the jets of the hard and corrected events
+void PuppiCSStage::print(ostream & ostr) const{
+  ostr << "  rho (PUPPI-weighted) = " << _rho << endl;
+  print_formatted(ostr, "  time [ms]: puppi %.3f, rho %.3f, subtraction %.3f, clustering %.3f, total %.3f\n",
+                  1000*_timings.puppi, 1000*_timings.rho, 1000*_timings.subtraction,
+                  1000*_timings.clustering, 1000*_timings.total());
+  ostr << endl;
+
+  ostr << "Jets above " << _ptmin << " GeV in the hard event (" << _hard_event.size() << " particles)" << endl;
+  ostr << "---------------------------------------\n";
+  print_formatted(ostr, "%5s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt");
+  for (unsigned int i = 0; i < _hard_jets.size(); i++) {
+    print_formatted(ostr, "%5u %15.8f %15.8f %15.8f\n", i,
+                    _hard_jets[i].rap(), _hard_jets[i].phi(), _hard_jets[i].perp());
+  }
+  ostr << endl;
+
+  ostr << "Jets above " << _ptmin << " GeV after PUPPI+CS (" << _weighted_event.size()
+       << " weighted particles, " << _corrected_event.size() << " after subtraction)" << endl;
+  ostr << "---------------------------------------\n";
+  print_formatted(ostr, "%5s %15s %15s %15s\n","jet #", "rapidity", "phi", "pt");
+  for (unsigned int i = 0; i < _corrected_jets.size(); i++) {
+    print_formatted(ostr, "%5u %15.8f %15.8f %15.8f\n", i,
+                    _corrected_jets[i].rap(), _corrected_jets[i].phi(), _corrected_jets[i].perp());
+  }
+}
+
+//----------------------------------------------------------------------
+void PuppiCSStage::write_jets(BinaryJetWriter & writer, unsigned long iev) const{
+  for (unsigned int i = 0; i < _corrected_jets.size(); i++) writer.write(iev, i, _corrected_jets[i]);
+}
+
+} // namespace fcc
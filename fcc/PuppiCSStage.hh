@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------
+/// \file
+/// PUPPI weighting followed by event-wide constituent subtraction and
+/// jet clustering, as one pipeline stage with per-step timings
+//----------------------------------------------------------------------
+#ifndef __FCC_PUPPICSSTAGE_HH__
+#define __FCC_PUPPICSSTAGE_HH__
+
+#include "fcc/ConstituentSubtraction.hh"
+#include "fcc/EventAnalysis.hh"
+#include "fcc/Puppi.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
+#include "fastjet/contrib/ConstituentSubtractor.hh"
+#include <memory>
+
+namespace fcc {
+
+/// \class PuppiCSStage
+/// PUPPI + event-wide Constituent Subtraction + anti-kt clustering
+///
+/// For each event:
+///  - the particles are PUPPI-weighted (fcc::PuppiWeighter), using
+///    the sub-event labels as charged LV/PU truth
+///  - rho is estimated once, on a rapidity-phi grid, from the
+///    weighted particles up to |y| = particle_maxrap
+///  - the weighted particles are corrected by event-wide constituent
+///    subtraction with that rho (fjcontrib's ConstituentSubtractor,
+///    with rho_m from the same estimator; or, with grid_subtraction,
+///    fcc::ConstituentSubtraction, which gives the same particles
+///    with less time and memory)
+///  - the corrected event is clustered with anti-kt R=0.5 (jets above
+///    7 GeV, as in subtraction07), and so is the hard event alone for
+///    reference
+///
+/// The wall-clock time of each step is kept, so that the drivers can
+/// check it against a per-event latency budget.
+///
+/// NB: the code needs to be linked against the ConstituentSubtractor
+/// library from fjcontrib (-lConstituentSubtractor).
+class PuppiCSStage : public EventAnalysis {
+public:
+  /// time spent in each step of the last event [s]
+  struct Timings {
+    Timings() : puppi(0), rho(0), subtraction(0), clustering(0) {}
+    double puppi, rho, subtraction, clustering;
+    double total() const { return puppi + rho + subtraction + clustering; }
+  };
+
+  PuppiCSStage(bool grid_subtraction = false);
+
+  virtual EventAnalysis * clone() const { return new PuppiCSStage(_grid_subtraction); }
+  virtual std::string description() const;
+  virtual void process(const Event & event, unsigned long iev);
+  virtual void print(std::ostream & ostr) const;
+  virtual void write_jets(BinaryJetWriter & writer, unsigned long iev) const;
+
+  const PuppiWeighter & puppi() const { return _puppi; }
+  const fastjet::JetDefinition & jet_def() const { return _jet_def; }
+  double rho() const { return _rho; }
+  const Timings & timings() const { return _timings; }
+
+  const std::vector<fastjet::PseudoJet> & weighted_event()  const { return _weighted_event; }
+  const std::vector<fastjet::PseudoJet> & corrected_event() const { return _corrected_event; }
+  const std::vector<fastjet::PseudoJet> & hard_jets()      const { return _hard_jets; }
+  const std::vector<fastjet::PseudoJet> & corrected_jets() const { return _corrected_jets; }
+
+protected:
+  double _particle_maxrap, _ptmin;
+  PuppiWeighter _puppi;
+  fastjet::GridMedianBackgroundEstimator _bge_rho;
+  bool _grid_subtraction;
+  fastjet::contrib::ConstituentSubtractor _subtractor;
+  ConstituentSubtraction _grid_subtractor;
+  fastjet::JetDefinition _jet_def;
+
+  std::vector<fastjet::PseudoJet> _hard_event, _weighted_event, _corrected_event;
+  std::unique_ptr<fastjet::ClusterSequence> _clust_seq_hard, _clust_seq_corrected;
+  std::vector<fastjet::PseudoJet> _hard_jets, _corrected_jets;
+  double _rho;
+  Timings _timings;
+};
+
+} // namespace fcc
+
+#endif // __FCC_PUPPICSSTAGE_HH__
@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------
+/// \file
+/// The rapidity-phi tiling and pair distance shared by the tiled
+/// clusterings (fcc::SoATiledPlugin, fcc::RapiditySlabPlugin)
+//----------------------------------------------------------------------
+#ifndef __FCC_RAPPHITILING_HH__
+#define __FCC_RAPPHITILING_HH__
+
+#include <algorithm>
+#include <cmath>
+
+namespace fcc {
+
+/// |rapidity| beyond which objects all go in the edge tiles (zero-pt
+/// particles have rapidities of order 1e5)
+const double tiling_max_rap = 20.0;
+
+// the distance must be rounded exactly as in ClusterSequence, which
+// forbids fusing its multiplications and additions
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+/// the squared rapidity-phi distance as computed by
+/// ClusterSequence::_bj_dist: with both phi in [0,2pi),
+/// min(dphi, twopi-dphi) is exactly its "if (dphi > pi) dphi = twopi - dphi"
+inline double tiled_distance2(double y1, double phi1, double y2, double phi2){
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+  double dphi = std::abs(phi1 - phi2);
+  dphi = std::min(dphi, 2*M_PI - dphi);
+  double drap = y1 - y2;
+  return dphi*dphi + drap*drap;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+/// \class RapPhiTiling
+/// tiles at least a given size wide in rapidity and phi, so that all
+/// the objects within that distance of one lie in its tile or in the
+/// tiles around it. Tile (iy, iphi) has number iy*n_phi() + iphi, and
+/// the objects beyond the rapidity range go in the edge tiles.
+class RapPhiTiling {
+public:
+  RapPhiTiling() : _rap_min(0), _tile_size_rap(1), _tile_size_phi(2*M_PI), _n_rap(1), _n_phi(1) {}
+
+  /// tiles at least "size" wide (with a small safety margin against
+  /// rounding) over [rap_min, rap_max], limited to |y| < tiling_max_rap
+  void set(double rap_min, double rap_max, double size){
+    rap_min = std::max(rap_min, -tiling_max_rap);
+    rap_max = std::min(rap_max,  tiling_max_rap);
+    if (rap_max < rap_min) rap_max = rap_min;
+    size *= 1 + 1e-6;
+    _rap_min = rap_min;
+    _tile_size_rap = size;
+    _n_rap = int((rap_max - rap_min) / size) + 1;
+    _n_phi = std::max(1, int(2*M_PI / size));
+    _tile_size_phi = 2*M_PI / _n_phi;
+  }
+
+  int n_rap() const { return _n_rap; }
+  int n_phi() const { return _n_phi; }
+  int n_tiles() const { return _n_rap * _n_phi; }
+
+  /// the tile of an object (phi in [0,2pi))
+  int index(double rap, double phi) const {
+    int iy = int(std::floor((rap - _rap_min) / _tile_size_rap));
+    iy = std::max(0, std::min(_n_rap-1, iy));
+    int iphi = std::min(_n_phi-1, int(phi / _tile_size_phi));
+    return iy*_n_phi + iphi;
+  }
+
+  /// fills "tiles" with tile itile followed by the distinct tiles
+  /// around it, and returns how many there are (at most 9)
+  unsigned int neighbourhood(int itile, int tiles[9]) const {
+    int iy = itile / _n_phi, iphi = itile % _n_phi;
+    unsigned int n = 0;
+    tiles[n++] = itile;
+    for (int jy = std::max(0, iy-1); jy <= std::min(_n_rap-1, iy+1); jy++){
+      for (int djphi = -1; djphi <= 1; djphi++){
+        int jtile = jy*_n_phi + (iphi + djphi + _n_phi) % _n_phi;
+        if (std::find(tiles, tiles + n, jtile) == tiles + n) tiles[n++] = jtile;
+      }
+    }
+    return n;
+  }
+
+private:
+  double _rap_min, _tile_size_rap, _tile_size_phi;
+  int _n_rap, _n_phi;
+};
+
+} // namespace fcc
+
+#endif // __FCC_RAPPHITILING_HH__
@@ -0,0 +1,420 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::RapiditySlabPlugin
+//----------------------------------------------------------------------
+#include "fcc/RapiditySlabPlugin.hh"
+#include "fcc/RapPhiTiling.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+// the d_ij of the pairs across parts must be rounded exactly as in
+// ClusterSequence, which forbids fusing the multiplications and
+// additions
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+/// same as ClusterSequence::jet_scale_for_algorithm
+double weight(JetAlgorithm algorithm, const PseudoJet & jet){
+  if (algorithm == kt_algorithm) return jet.kt2();
+  if (algorithm == cambridge_algorithm) return 1.0;
+  double kt2 = jet.kt2();
+  return kt2 > 1e-300 ? 1.0/kt2 : 1e300;
+}
+
+//----------------------------------------------------------------------
+/// an independent part of the event: the jets of a slab that lie
+/// within it, or a group of boundary particles
+struct Part {
+  Part() : rap_min(0), rap_max(0), base(0) {}
+  unique_ptr<ClusterSequence> cs;
+  vector<int> particles;   ///< event index of the particles given to cs
+  vector<int> ops;         ///< history indices of the steps kept, in order
+  double rap_min, rap_max; ///< rapidity range of the particles kept
+  unsigned int base;       ///< id of the first history element in the merge
+};
+
+/// a pair of objects from two different parts, with its d_ij
+struct CrossPair {
+  double dij;
+  int a, b;
+  bool operator>(const CrossPair & other) const { return dij > other.dij; }
+};
+
+//----------------------------------------------------------------------
+/// the interleaving of the steps of the parts in the serial order,
+/// checking on the way that no pair across parts would have been
+/// recombined
+class Merge {
+public:
+  Merge(vector<Part> & parts, JetAlgorithm algorithm, double R);
+
+  /// fills "order" with (part, history index) and returns true if the
+  /// check passes
+  bool run(vector<pair<unsigned int,int> > & order);
+
+private:
+  bool _create(unsigned int ipart, int h);
+  void _kill(int id);
+  bool _is_border(unsigned int ipart, double rap) const;
+
+  vector<Part> & _parts;
+  JetAlgorithm _algorithm;
+  double _R, _R2, _invR2;
+
+  // per object (base of its part + history index)
+  vector<double> _rap, _phi, _w;
+  vector<unsigned char> _alive;
+  vector<int> _tile, _tile_pos;
+  vector<unsigned int> _part;
+
+  // tiles at least R wide holding the objects near other parts
+  RapPhiTiling _tiling;
+  vector<vector<int> > _tiles;
+
+  priority_queue<CrossPair, vector<CrossPair>, greater<CrossPair> > _cross;
+};
+
+//----------------------------------------------------------------------
+Merge::Merge(vector<Part> & parts, JetAlgorithm algorithm, double R)
+  : _parts(parts), _algorithm(algorithm), _R(R), _R2(R*R), _invR2(1.0/(R*R)){
+  unsigned int n_objects = 0;
+  double rap_min = tiling_max_rap, rap_max = -tiling_max_rap;
+  for (unsigned int i = 0; i < parts.size(); i++){
+    parts[i].base = n_objects;
+    n_objects += parts[i].cs->history().size();
+    rap_min = min(rap_min, parts[i].rap_min);
+    rap_max = max(rap_max, parts[i].rap_max);
+  }
+  _rap.resize(n_objects);
+  _phi.resize(n_objects);
+  _w.resize(n_objects);
+  _alive.assign(n_objects, 0);
+  _tile.assign(n_objects, -1);
+  _tile_pos.resize(n_objects);
+  _part.resize(n_objects);
+
+  _tiling.set(rap_min, rap_max, R);
+  _tiles.assign(_tiling.n_tiles(), vector<int>());
+}
+
+//----------------------------------------------------------------------
+// true if an object of part ipart at this rapidity can be within R of
+// an object of another part (every object lies within the rapidity
+// range of its particles)
+bool Merge::_is_border(unsigned int ipart, double rap) const{
+  for (unsigned int i = 0; i < _parts.size(); i++){
+    if ((i == ipart) || _parts[i].ops.empty()) continue;
+    if ((rap >= _parts[i].rap_min - _R) && (rap <= _parts[i].rap_max + _R)) return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------
+// history element h of part ipart comes into existence; returns false
+// if it falls outside the rapidity range of its part
+bool Merge::_create(unsigned int ipart, int h){
+  const Part & part = _parts[ipart];
+  const ClusterSequence & cs = *part.cs;
+  const PseudoJet & jet = cs.jets()[cs.history()[h].jetp_index];
+  int id = part.base + h;
+  double rap = jet.rap();
+  if ((rap < part.rap_min) || (rap > part.rap_max)) return false;
+  _rap[id] = rap;
+  _phi[id] = jet.phi_02pi();
+  _w[id] = weight(_algorithm, jet);
+  _part[id] = ipart;
+  _alive[id] = 1;
+  if (!_is_border(ipart, rap)) return true;
+
+  // the pairs with the objects of the other parts in the 3x3 tiles
+  // around it
+  int itile = _tiling.index(rap, _phi[id]);
+  int neighbours[9];
+  unsigned int n_neighbours = _tiling.neighbourhood(itile, neighbours);
+  for (unsigned int it = 0; it < n_neighbours; it++){
+    const vector<int> & members = _tiles[neighbours[it]];
+    for (unsigned int k = 0; k < members.size(); k++){
+      int other = members[k];
+      if (_part[other] == ipart) continue;
+      double dist = tiled_distance2(rap, _phi[id], _rap[other], _phi[other]);
+      if (dist >= _R2) continue;
+      CrossPair pair;
+      pair.dij = dist * min(_w[id], _w[other]) * _invR2;
+      pair.a = id;
+      pair.b = other;
+      _cross.push(pair);
+    }
+  }
+  _tile[id] = itile;
+  _tile_pos[id] = _tiles[itile].size();
+  _tiles[itile].push_back(id);
+  return true;
+}
+
+//----------------------------------------------------------------------
+void Merge::_kill(int id){
+  _alive[id] = 0;
+  int itile = _tile[id];
+  if (itile < 0) return;
+  vector<int> & members = _tiles[itile];
+  int last = members.back();
+  members[_tile_pos[id]] = last;
+  _tile_pos[last] = _tile_pos[id];
+  members.pop_back();
+  _tile[id] = -1;
+}
+
+//----------------------------------------------------------------------
+bool Merge::run(vector<pair<unsigned int,int> > & order){
+  typedef pair<double, unsigned int> Head;
+  priority_queue<Head, vector<Head>, greater<Head> > heads;
+  vector<unsigned int> next(_parts.size(), 0);
+
+  // the particles of every part that take part in its steps
+  for (unsigned int ipart = 0; ipart < _parts.size(); ipart++){
+    Part & part = _parts[ipart];
+    if (part.ops.empty()) continue;
+    const vector<ClusterSequence::history_element> & history = part.cs->history();
+    for (unsigned int i = 0; i < part.ops.size(); i++){
+      const ClusterSequence::history_element & step = history[part.ops[i]];
+      if ((step.parent1 < int(part.particles.size())) && !_create(ipart, step.parent1)) return false;
+      if ((step.parent2 >= 0) && (step.parent2 < int(part.particles.size())) &&
+          !_create(ipart, step.parent2)) return false;
+    }
+    heads.push(Head(history[part.ops[0]].dij, ipart));
+  }
+
+  // the steps in the order of the serial clustering: the smallest d_ij
+  // among the next steps of the parts, which must be smaller than that
+  // of every pair across parts
+  order.clear();
+  while (!heads.empty()){
+    double dij = heads.top().first;
+    unsigned int ipart = heads.top().second;
+    heads.pop();
+    while (!_cross.empty() && !(_alive[_cross.top().a] && _alive[_cross.top().b])) _cross.pop();
+    if (!_cross.empty() && (_cross.top().dij <= dij)) return false;
+
+    Part & part = _parts[ipart];
+    int h = part.ops[next[ipart]++];
+    const ClusterSequence::history_element & step = part.cs->history()[h];
+    _kill(part.base + step.parent1);
+    if (step.parent2 >= 0){
+      _kill(part.base + step.parent2);
+      if (!_create(ipart, h)) return false;
+    }
+    order.push_back(make_pair(ipart, h));
+    if (next[ipart] < part.ops.size())
+      heads.push(Head(part.cs->history()[part.ops[next[ipart]]].dij, ipart));
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+/// record the steps of "inner" (a clustering of all the particles of
+/// cs, in the same order) in cs
+void replay(ClusterSequence & cs, const ClusterSequence & inner){
+  const vector<ClusterSequence::history_element> & history = inner.history();
+  unsigned int n = inner.n_particles();
+  vector<int> index(history.size());
+  for (unsigned int i = 0; i < n; i++) index[i] = i;
+  for (unsigned int h = n; h < history.size(); h++){
+    const ClusterSequence::history_element & step = history[h];
+    if (step.parent2 == ClusterSequence::BeamJet){
+      cs.plugin_record_iB_recombination(index[step.parent1], step.dij);
+    } else {
+      int k;
+      cs.plugin_record_ij_recombination(index[step.parent1], index[step.parent2], step.dij, k);
+      index[h] = k;
+    }
+  }
+}
+
+} // anonymous namespace
+
+//----------------------------------------------------------------------
+RapiditySlabPlugin::RapiditySlabPlugin(JetAlgorithm algorithm, double R, unsigned int n_slabs,
+                                       unsigned int n_threads, double halo, Strategy strategy)
+  : _algorithm(algorithm), _R(R), _halo(halo < 0 ? 2*R : halo), _n_slabs(n_slabs),
+    _strategy(strategy), _min_particles(2000){
+  if ((algorithm != kt_algorithm) && (algorithm != cambridge_algorithm) && (algorithm != antikt_algorithm))
+    throw Error("RapiditySlabPlugin: only kt, cambridge and antikt are supported");
+  if (n_slabs == 0) throw Error("RapiditySlabPlugin: at least one slab is needed");
+  if (_halo < R) throw Error("RapiditySlabPlugin: the halo must be at least R wide");
+  _pool.reset(new ThreadPool(n_threads ? n_threads : n_slabs));
+}
+
+//----------------------------------------------------------------------
+string RapiditySlabPlugin::description() const{
+  ostringstream desc;
+  desc << JetDefinition(_algorithm, _R).description() << ", in " << _n_slabs
+       << " rapidity slabs with halos of " << _halo << " on " << _pool->n_threads() << " threads";
+  return desc.str();
+}
+
+//----------------------------------------------------------------------
+void RapiditySlabPlugin::run_clustering(ClusterSequence & cs) const{
+  Timer timer;
+  _stats = Stats();
+  unsigned int n = cs.n_particles();
+  _stats.n_particles = n;
+  JetDefinition inner_def(_algorithm, _R, _strategy);
+  inner_def.set_recombiner(cs.jet_def());
+
+  vector<PseudoJet> particles(cs.jets().begin(), cs.jets().begin() + n);
+  if ((n < _min_particles) || (_n_slabs < 2)){
+    _stats.serial = true;
+    replay(cs, ClusterSequence(particles, inner_def));
+    _stats.time_merge = timer.elapsed();
+    return;
+  }
+
+  // slab boundaries at the quantiles of the rapidity distribution,
+  // dropping those closer than R to the previous one
+  vector<double> rap(n);
+  for (unsigned int i = 0; i < n; i++) rap[i] = particles[i].rap();
+  vector<double> sorted(rap);
+  vector<double> edges;
+  unsigned int first = 0;
+  for (unsigned int k = 1; k < _n_slabs; k++){
+    unsigned int position = (unsigned long)(n) * k / _n_slabs;
+    nth_element(sorted.begin() + first, sorted.begin() + position, sorted.end());
+    first = position;
+    if (edges.empty() || (sorted[position] > edges.back() + _R)) edges.push_back(sorted[position]);
+  }
+  unsigned int n_slabs = edges.size() + 1;
+  _stats.n_slabs = n_slabs;
+
+  // the particles of each slab and its halo, in event order (which the
+  // serial clustering uses to resolve ties)
+  vector<Part> parts(n_slabs);
+  vector<int> slab_of(n);
+  for (unsigned int i = 0; i < n; i++){
+    int s = upper_bound(edges.begin(), edges.end(), rap[i]) - edges.begin();
+    slab_of[i] = s;
+    for (int t = s; (t >= 0) && ((t == s) || (rap[i] < edges[t] + _halo)); t--) parts[t].particles.push_back(i);
+    for (int t = s+1; (t < int(n_slabs)) && (rap[i] >= edges[t-1] - _halo); t++) parts[t].particles.push_back(i);
+  }
+
+  // cluster the slabs, and keep the jets entirely within their slab
+  vector<unsigned char> kept(n, 0);
+  for (unsigned int s = 0; s < n_slabs; s++){
+    _pool->submit([s, &parts, &particles, &inner_def, &rap, &slab_of, &kept](unsigned int){
+        Part & part = parts[s];
+        vector<PseudoJet> input;
+        input.reserve(part.particles.size());
+        for (unsigned int i = 0; i < part.particles.size(); i++) input.push_back(particles[part.particles[i]]);
+        part.cs.reset(new ClusterSequence(input, inner_def));
+
+        // the inclusive jet of every history element, found backwards
+        const vector<ClusterSequence::history_element> & history = part.cs->history();
+        unsigned int n_part = part.particles.size();
+        vector<int> root(history.size());
+        for (int h = history.size()-1; h >= int(n_part); h--){
+          const ClusterSequence::history_element & step = history[h];
+          if (step.parent2 == ClusterSequence::BeamJet){
+            root[h] = root[step.parent1] = step.parent1;
+          } else {
+            root[step.parent1] = root[step.parent2] = root[h];
+          }
+        }
+        vector<unsigned char> outside(history.size(), 0);
+        for (unsigned int i = 0; i < n_part; i++){
+          if (slab_of[part.particles[i]] != int(s)) outside[root[i]] = 1;
+        }
+        part.rap_min = tiling_max_rap;
+        part.rap_max = -tiling_max_rap;
+        for (unsigned int i = 0; i < n_part; i++){
+          if (outside[root[i]]) continue;
+          int particle = part.particles[i];
+          kept[particle] = 1;
+          part.rap_min = min(part.rap_min, rap[particle]);
+          part.rap_max = max(part.rap_max, rap[particle]);
+        }
+        for (unsigned int h = n_part; h < history.size(); h++){
+          if (!outside[root[h]]) part.ops.push_back(h);
+        }
+      });
+  }
+  _pool->wait();
+  _stats.time_slabs = timer.elapsed();
+
+  // the other particles, in groups more than R apart in rapidity
+  timer.start();
+  vector<pair<double,int> > boundary;
+  for (unsigned int i = 0; i < n; i++){
+    if (!kept[i]) boundary.push_back(make_pair(rap[i], int(i)));
+  }
+  sort(boundary.begin(), boundary.end());
+  _stats.n_boundary = boundary.size();
+  for (unsigned int i = 0; i < boundary.size(); i++){
+    if ((i == 0) || (boundary[i].first - boundary[i-1].first > _R)){
+      parts.push_back(Part());
+      parts.back().rap_min = boundary[i].first;
+    }
+    parts.back().particles.push_back(boundary[i].second);
+    parts.back().rap_max = boundary[i].first;
+  }
+  _stats.n_groups = parts.size() - n_slabs;
+  for (unsigned int g = n_slabs; g < parts.size(); g++){
+    _pool->submit([g, &parts, &particles, &inner_def](unsigned int){
+        Part & part = parts[g];
+        sort(part.particles.begin(), part.particles.end());
+        vector<PseudoJet> input;
+        input.reserve(part.particles.size());
+        for (unsigned int i = 0; i < part.particles.size(); i++) input.push_back(particles[part.particles[i]]);
+        part.cs.reset(new ClusterSequence(input, inner_def));
+        for (unsigned int h = part.particles.size(); h < part.cs->history().size(); h++) part.ops.push_back(h);
+      });
+  }
+  _pool->wait();
+  _stats.time_groups = timer.elapsed();
+
+  // interleave and check the parts, and record their steps (or fall
+  // back on the serial clustering)
+  timer.start();
+  vector<pair<unsigned int,int> > order;
+  if (!Merge(parts, _algorithm, _R).run(order)){
+    _stats.serial = true;
+    parts.clear();
+    replay(cs, ClusterSequence(particles, inner_def));
+    _stats.time_merge = timer.elapsed();
+    return;
+  }
+  vector<vector<int> > index(parts.size());
+  for (unsigned int ipart = 0; ipart < parts.size(); ipart++){
+    index[ipart].resize(parts[ipart].cs->history().size());
+    for (unsigned int i = 0; i < parts[ipart].particles.size(); i++) index[ipart][i] = parts[ipart].particles[i];
+  }
+  for (unsigned int i = 0; i < order.size(); i++){
+    vector<int> & part_index = index[order[i].first];
+    int h = order[i].second;
+    const ClusterSequence::history_element & step = parts[order[i].first].cs->history()[h];
+    if (step.parent2 == ClusterSequence::BeamJet){
+      cs.plugin_record_iB_recombination(part_index[step.parent1], step.dij);
+    } else {
+      int k;
+      cs.plugin_record_ij_recombination(part_index[step.parent1], part_index[step.parent2], step.dij, k);
+      part_index[h] = k;
+    }
+  }
+  _stats.time_merge = timer.elapsed();
+}
+
+} // namespace fcc
@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------
+/// \file
+/// Intra-event parallel kt / Cambridge-Aachen / anti-kt clustering:
+/// rapidity slabs clustered concurrently, with the jets across the
+/// slab boundaries resolved so that the result is that of the serial
+/// clustering
+//----------------------------------------------------------------------
+#ifndef __FCC_RAPIDITYSLABPLUGIN_HH__
+#define __FCC_RAPIDITYSLABPLUGIN_HH__
+
+#include "fcc/ThreadPool.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/JetDefinition.hh"
+#include <memory>
+#include <string>
+
+namespace fcc {
+
+/// \class RapiditySlabPlugin
+/// kt, C/A or anti-kt clustering of one event on several threads
+///
+/// The rapidity range is cut into n_slabs slabs holding about the same
+/// number of particles. Each slab is clustered on its own thread
+/// together with a halo of the particles within "halo" (default 2R)
+/// of it, and the jets that lie entirely within the slab itself are
+/// kept. The remaining particles, around the slab boundaries, are
+/// split into groups separated by more than R in rapidity, which are
+/// clustered concurrently as well.
+///
+/// The slabs and groups are then checked against each other before
+/// anything is recorded. Their recombination sequences are
+/// interleaved in order of d_ij, which is the order in which the
+/// serial clustering would take them. At every step, no pair of
+/// objects from two different slabs or groups may have a d_ij smaller
+/// than the step's. Only pairs closer than R can take part, so only
+/// the objects near the edges of the slabs and groups are examined.
+/// When this holds, the sub-clusterings are exactly the serial one,
+/// split into independent parts, and their recombinations are
+/// recorded in the ClusterSequence in the serial order. When it does
+/// not hold (a jet of a slab would have been modified by particles
+/// beyond its halo), the event is clustered serially instead. Either
+/// way, the jets and the d_ij are those of a ClusterSequence with the
+/// same jet definition and strategy; only exact ties may be resolved
+/// in a different order.
+///
+/// The recombination scheme is that of the JetDefinition using the
+/// plugin. Ghosts (e.g. in a ClusterSequenceArea) are clustered like
+/// any other particle.
+///
+/// NB: the sub-clusterings run on threads, which needs a FastJet
+/// configured with --enable-thread-safety (FastJet >= 3.4). A plugin
+/// object must not be used by several threads at once (it owns its
+/// thread pool and keeps statistics on the last event).
+///
+/// Usage:
+///   fcc::RapiditySlabPlugin plugin(fastjet::antikt_algorithm, 0.4, 8);
+///   fastjet::JetDefinition jet_def(&plugin);
+class RapiditySlabPlugin : public fastjet::JetDefinition::Plugin {
+public:
+  /// what happened in the last event
+  struct Stats {
+    Stats() : n_particles(0), n_slabs(0), n_groups(0), n_boundary(0), serial(false),
+              time_slabs(0), time_groups(0), time_merge(0) {}
+    unsigned long n_particles;
+    unsigned int n_slabs, n_groups;  ///< slabs and boundary groups used
+    unsigned long n_boundary;        ///< particles in the boundary groups
+    bool serial;                     ///< clustered serially (small event or failed check)
+    double time_slabs, time_groups, time_merge;  ///< wall-clock time of each step [s]
+  };
+
+  /// algorithm is kt_algorithm, cambridge_algorithm or
+  /// antikt_algorithm; n_threads = 0 means one per slab; halo < 0
+  /// means 2R; the sub-clusterings use "strategy"
+  RapiditySlabPlugin(fastjet::JetAlgorithm algorithm, double R, unsigned int n_slabs,
+                     unsigned int n_threads = 0, double halo = -1,
+                     fastjet::Strategy strategy = fastjet::Best);
+
+  virtual std::string description() const;
+  virtual void run_clustering(fastjet::ClusterSequence & cs) const;
+  virtual double R() const { return _R; }
+  virtual bool exclusive_sequence_meaningful() const { return _algorithm != fastjet::antikt_algorithm; }
+
+  /// events with fewer particles (default 2000) are clustered serially
+  void set_min_particles(unsigned long n) { _min_particles = n; }
+
+  const Stats & last_stats() const { return _stats; }
+
+private:
+  fastjet::JetAlgorithm _algorithm;
+  double _R, _halo;
+  unsigned int _n_slabs;
+  fastjet::Strategy _strategy;
+  unsigned long _min_particles;
+  std::shared_ptr<ThreadPool> _pool;
+  mutable Stats _stats;
+};
+
+} // namespace fcc
+
+#endif // __FCC_RAPIDITYSLABPLUGIN_HH__
@@ -0,0 +1,578 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::SoATiledPlugin
+//----------------------------------------------------------------------
+#include "fcc/SoATiledPlugin.hh"
+#include "fcc/RapPhiTiling.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define FCC_SOA_X86
+#include <immintrin.h>
+#endif
+
+// the distances must be rounded exactly as in ClusterSequence, which
+// forbids fusing the multiplications and additions
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+const double twopi = 2*M_PI;
+
+//----------------------------------------------------------------------
+// kernels
+//----------------------------------------------------------------------
+
+/// among the n points (rap[i],phi[i]), find the first one whose
+/// squared distance to (y,phi0) is strictly smaller than best; returns
+/// its position (and updates best), or -1 if there is none
+typedef int (*NearestKernel)(const double * rap, const double * phi, unsigned int n,
+                             double y, double phi0, double & best);
+
+/// squared distances of the n points (rap[i],phi[i]) to (y,phi0)
+typedef void (*DistancesKernel)(const double * rap, const double * phi, unsigned int n,
+                                double y, double phi0, double * distances);
+
+/// position of the first entry of values strictly smaller than best
+/// and smaller than all others (updates best), or -1
+typedef int (*MinimumKernel)(const double * values, unsigned int n, double & best);
+
+int nearest_scalar(const double * rap, const double * phi, unsigned int n,
+                   double y, double phi0, double & best){
+  int ibest = -1;
+  for (unsigned int i = 0; i < n; i++){
+    double d = tiled_distance2(y, phi0, rap[i], phi[i]);
+    if (d < best){ best = d; ibest = i; }
+  }
+  return ibest;
+}
+
+void distances_scalar(const double * rap, const double * phi, unsigned int n,
+                      double y, double phi0, double * distances){
+  for (unsigned int i = 0; i < n; i++) distances[i] = tiled_distance2(y, phi0, rap[i], phi[i]);
+}
+
+int minimum_scalar(const double * values, unsigned int n, double & best){
+  int ibest = -1;
+  for (unsigned int i = 0; i < n; i++){
+    if (values[i] < best){ best = values[i]; ibest = i; }
+  }
+  return ibest;
+}
+
+/// combine the per-lane minima of a vector kernel (each lane holding
+/// its first minimum) into the first overall minimum
+inline int reduce_lanes(const double * lane_best, const long long * lane_index,
+                        unsigned int n_lanes, double & best){
+  int ibest = -1;
+  for (unsigned int l = 0; l < n_lanes; l++){
+    if (lane_index[l] < 0) continue;
+    if (ibest < 0 || lane_best[l] < best || (lane_best[l] == best && lane_index[l] < ibest)){
+      best = lane_best[l];
+      ibest = lane_index[l];
+    }
+  }
+  return ibest;
+}
+
+#ifdef FCC_SOA_X86
+
+//----------------------------------------------------------------------
+// AVX2: 4 doubles per vector (the distances are those of
+// tiled_distance2, lane by lane)
+__attribute__((target("avx2")))
+inline __m256d distance2_avx2(__m256d y, __m256d phi0, __m256d rap, __m256d phi){
+  const __m256d sign = _mm256_set1_pd(-0.0), vtwopi = _mm256_set1_pd(twopi);
+  __m256d dphi = _mm256_andnot_pd(sign, _mm256_sub_pd(phi0, phi));
+  dphi = _mm256_min_pd(dphi, _mm256_sub_pd(vtwopi, dphi));
+  __m256d drap = _mm256_sub_pd(y, rap);
+  return _mm256_add_pd(_mm256_mul_pd(dphi, dphi), _mm256_mul_pd(drap, drap));
+}
+
+__attribute__((target("avx2")))
+int nearest_avx2(const double * rap, const double * phi, unsigned int n,
+                 double y, double phi0, double & best){
+  int ibest = -1;
+  unsigned int i = 0;
+  if (n >= 4){
+    const __m256d vy = _mm256_set1_pd(y), vphi0 = _mm256_set1_pd(phi0);
+    const __m256i four = _mm256_set1_epi64x(4);
+    __m256d vbest = _mm256_set1_pd(best);
+    __m256d vibest = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    __m256i vi = _mm256_setr_epi64x(0, 1, 2, 3);
+    for (; i + 4 <= n; i += 4){
+      __m256d d = distance2_avx2(vy, vphi0, _mm256_loadu_pd(rap+i), _mm256_loadu_pd(phi+i));
+      __m256d closer = _mm256_cmp_pd(d, vbest, _CMP_LT_OQ);
+      vbest  = _mm256_blendv_pd(vbest, d, closer);
+      vibest = _mm256_blendv_pd(vibest, _mm256_castsi256_pd(vi), closer);
+      vi = _mm256_add_epi64(vi, four);
+    }
+    double lane_best[4];
+    long long lane_index[4];
+    _mm256_storeu_pd(lane_best, vbest);
+    _mm256_storeu_si256((__m256i *) lane_index, _mm256_castpd_si256(vibest));
+    ibest = reduce_lanes(lane_best, lane_index, 4, best);
+  }
+  for (; i < n; i++){
+    double d = tiled_distance2(y, phi0, rap[i], phi[i]);
+    if (d < best){ best = d; ibest = i; }
+  }
+  return ibest;
+}
+
+__attribute__((target("avx2")))
+void distances_avx2(const double * rap, const double * phi, unsigned int n,
+                    double y, double phi0, double * distances){
+  const __m256d vy = _mm256_set1_pd(y), vphi0 = _mm256_set1_pd(phi0);
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(distances+i, distance2_avx2(vy, vphi0, _mm256_loadu_pd(rap+i), _mm256_loadu_pd(phi+i)));
+  for (; i < n; i++) distances[i] = tiled_distance2(y, phi0, rap[i], phi[i]);
+}
+
+__attribute__((target("avx2")))
+int minimum_avx2(const double * values, unsigned int n, double & best){
+  int ibest = -1;
+  unsigned int i = 0;
+  if (n >= 4){
+    const __m256i four = _mm256_set1_epi64x(4);
+    __m256d vbest = _mm256_set1_pd(best);
+    __m256d vibest = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    __m256i vi = _mm256_setr_epi64x(0, 1, 2, 3);
+    for (; i + 4 <= n; i += 4){
+      __m256d v = _mm256_loadu_pd(values+i);
+      __m256d smaller = _mm256_cmp_pd(v, vbest, _CMP_LT_OQ);
+      vbest  = _mm256_blendv_pd(vbest, v, smaller);
+      vibest = _mm256_blendv_pd(vibest, _mm256_castsi256_pd(vi), smaller);
+      vi = _mm256_add_epi64(vi, four);
+    }
+    double lane_best[4];
+    long long lane_index[4];
+    _mm256_storeu_pd(lane_best, vbest);
+    _mm256_storeu_si256((__m256i *) lane_index, _mm256_castpd_si256(vibest));
+    ibest = reduce_lanes(lane_best, lane_index, 4, best);
+  }
+  for (; i < n; i++){
+    if (values[i] < best){ best = values[i]; ibest = i; }
+  }
+  return ibest;
+}
+
+//----------------------------------------------------------------------
+// AVX-512: 8 doubles per vector
+__attribute__((target("avx512f")))
+inline __m512d distance2_avx512(__m512d y, __m512d phi0, __m512d rap, __m512d phi){
+  const __m512d vtwopi = _mm512_set1_pd(twopi);
+  __m512d dphi = _mm512_abs_pd(_mm512_sub_pd(phi0, phi));
+  dphi = _mm512_min_pd(dphi, _mm512_sub_pd(vtwopi, dphi));
+  __m512d drap = _mm512_sub_pd(y, rap);
+  return _mm512_add_pd(_mm512_mul_pd(dphi, dphi), _mm512_mul_pd(drap, drap));
+}
+
+__attribute__((target("avx512f")))
+int nearest_avx512(const double * rap, const double * phi, unsigned int n,
+                   double y, double phi0, double & best){
+  int ibest = -1;
+  unsigned int i = 0;
+  if (n >= 8){
+    const __m512d vy = _mm512_set1_pd(y), vphi0 = _mm512_set1_pd(phi0);
+    const __m512i eight = _mm512_set1_epi64(8);
+    __m512d vbest = _mm512_set1_pd(best);
+    __m512i vibest = _mm512_set1_epi64(-1);
+    __m512i vi = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    for (; i + 8 <= n; i += 8){
+      __m512d d = distance2_avx512(vy, vphi0, _mm512_loadu_pd(rap+i), _mm512_loadu_pd(phi+i));
+      __mmask8 closer = _mm512_cmp_pd_mask(d, vbest, _CMP_LT_OQ);
+      vbest  = _mm512_mask_blend_pd(closer, vbest, d);
+      vibest = _mm512_mask_blend_epi64(closer, vibest, vi);
+      vi = _mm512_add_epi64(vi, eight);
+    }
+    double lane_best[8];
+    long long lane_index[8];
+    _mm512_storeu_pd(lane_best, vbest);
+    _mm512_storeu_si512(lane_index, vibest);
+    ibest = reduce_lanes(lane_best, lane_index, 8, best);
+  }
+  for (; i < n; i++){
+    double d = tiled_distance2(y, phi0, rap[i], phi[i]);
+    if (d < best){ best = d; ibest = i; }
+  }
+  return ibest;
+}
+
+__attribute__((target("avx512f")))
+void distances_avx512(const double * rap, const double * phi, unsigned int n,
+                      double y, double phi0, double * distances){
+  const __m512d vy = _mm512_set1_pd(y), vphi0 = _mm512_set1_pd(phi0);
+  unsigned int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(distances+i, distance2_avx512(vy, vphi0, _mm512_loadu_pd(rap+i), _mm512_loadu_pd(phi+i)));
+  for (; i < n; i++) distances[i] = tiled_distance2(y, phi0, rap[i], phi[i]);
+}
+
+__attribute__((target("avx512f")))
+int minimum_avx512(const double * values, unsigned int n, double & best){
+  int ibest = -1;
+  unsigned int i = 0;
+  if (n >= 8){
+    const __m512i eight = _mm512_set1_epi64(8);
+    __m512d vbest = _mm512_set1_pd(best);
+    __m512i vibest = _mm512_set1_epi64(-1);
+    __m512i vi = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    for (; i + 8 <= n; i += 8){
+      __m512d v = _mm512_loadu_pd(values+i);
+      __mmask8 smaller = _mm512_cmp_pd_mask(v, vbest, _CMP_LT_OQ);
+      vbest  = _mm512_mask_blend_pd(smaller, vbest, v);
+      vibest = _mm512_mask_blend_epi64(smaller, vibest, vi);
+      vi = _mm512_add_epi64(vi, eight);
+    }
+    double lane_best[8];
+    long long lane_index[8];
+    _mm512_storeu_pd(lane_best, vbest);
+    _mm512_storeu_si512(lane_index, vibest);
+    ibest = reduce_lanes(lane_best, lane_index, 8, best);
+  }
+  for (; i < n; i++){
+    if (values[i] < best){ best = values[i]; ibest = i; }
+  }
+  return ibest;
+}
+
+#endif // FCC_SOA_X86
+
+//----------------------------------------------------------------------
+/// the state of one clustering
+class TiledClustering {
+public:
+  TiledClustering(ClusterSequence & cs, JetAlgorithm algorithm, double R, double p,
+                  SoATiledPlugin::Kernel kernel);
+  void run();
+
+private:
+  struct Tile {
+    vector<double> rap, phi;  ///< coordinates of the members
+    vector<int> jet;          ///< ClusterSequence index of the members
+    vector<int> neighbours;   ///< this tile and the tiles around it
+  };
+
+  double _weight(const PseudoJet & jet) const;
+  void _setup_tiles(unsigned int n);
+  void _insert(int ijet);
+  void _remove(int ijet);
+  void _find_nn(int ijet);
+  void _set_diJ(int ijet);
+  void _mark_neighbourhood(int itile);
+
+  ClusterSequence & _cs;
+  JetAlgorithm _algorithm;
+  double _R2, _invR2, _p;
+  NearestKernel _nearest;
+  DistancesKernel _distances;
+  MinimumKernel _minimum;
+
+  // the tiling
+  RapPhiTiling _tiling;
+  vector<Tile> _tiles;
+  vector<unsigned int> _tile_mark;
+  vector<int> _marked_tiles;
+  unsigned int _mark;
+
+  // per-jet information, indexed by the ClusterSequence jet index
+  vector<double> _rap, _phi, _w, _nn_dist;
+  vector<int> _nn, _tile, _tile_pos, _active_pos;
+
+  // the jets still active and their d_iJ (times R^2), kept contiguous
+  // for the minimum search
+  vector<int> _active;
+  vector<double> _diJ;
+
+  vector<double> _scratch;
+};
+
+//----------------------------------------------------------------------
+TiledClustering::TiledClustering(ClusterSequence & cs, JetAlgorithm algorithm, double R, double p,
+                                 SoATiledPlugin::Kernel kernel)
+  : _cs(cs), _algorithm(algorithm), _R2(R*R), _invR2(1.0/(R*R)), _p(p), _mark(0){
+  _nearest = nearest_scalar;
+  _distances = distances_scalar;
+  _minimum = minimum_scalar;
+#ifdef FCC_SOA_X86
+  if (kernel == SoATiledPlugin::avx2){
+    _nearest = nearest_avx2;
+    _distances = distances_avx2;
+    _minimum = minimum_avx2;
+  } else if (kernel == SoATiledPlugin::avx512){
+    _nearest = nearest_avx512;
+    _distances = distances_avx512;
+    _minimum = minimum_avx512;
+  }
+#endif
+}
+
+//----------------------------------------------------------------------
+// same as ClusterSequence::jet_scale_for_algorithm
+double TiledClustering::_weight(const PseudoJet & jet) const{
+  if (_algorithm == kt_algorithm) return jet.kt2();
+  if (_algorithm == cambridge_algorithm) return 1.0;
+  double kt2 = jet.kt2();
+  if (_algorithm == antikt_algorithm) return kt2 > 1e-300 ? 1.0/kt2 : 1e300;
+  if (_p <= 0 && kt2 < 1e-300) kt2 = 1e-300;
+  return pow(kt2, _p);
+}
+
+//----------------------------------------------------------------------
+// tiles at least R wide (with a small safety margin against rounding)
+// over the rapidity range of the particles
+void TiledClustering::_setup_tiles(unsigned int n){
+  const vector<PseudoJet> & jets = _cs.jets();
+  double rap_min = tiling_max_rap, rap_max = -tiling_max_rap;
+  for (unsigned int i = 0; i < n; i++){
+    double rap = jets[i].rap();
+    if (rap < rap_min) rap_min = rap;
+    if (rap > rap_max) rap_max = rap;
+  }
+  _tiling.set(rap_min, rap_max, sqrt(_R2));
+
+  _tiles.assign(_tiling.n_tiles(), Tile());
+  _tile_mark.assign(_tiles.size(), 0);
+  int neighbours[9];
+  for (int itile = 0; itile < _tiling.n_tiles(); itile++){
+    unsigned int n_neighbours = _tiling.neighbourhood(itile, neighbours);
+    _tiles[itile].neighbours.assign(neighbours, neighbours + n_neighbours);
+  }
+}
+
+//----------------------------------------------------------------------
+// registers jet ijet of the ClusterSequence in its tile and in the
+// list of active jets (its d_iJ is set later)
+void TiledClustering::_insert(int ijet){
+  const PseudoJet & jet = _cs.jets()[ijet];
+  double rap = jet.rap(), phi = jet.phi_02pi();
+  _rap[ijet] = rap;
+  _phi[ijet] = phi;
+  _w[ijet] = _weight(jet);
+
+  int itile = _tiling.index(rap, phi);
+  Tile & tile = _tiles[itile];
+  _tile[ijet] = itile;
+  _tile_pos[ijet] = tile.jet.size();
+  tile.rap.push_back(rap);
+  tile.phi.push_back(phi);
+  tile.jet.push_back(ijet);
+
+  _active_pos[ijet] = _active.size();
+  _active.push_back(ijet);
+  _diJ.push_back(0.0);
+}
+
+//----------------------------------------------------------------------
+// removes ijet from its tile and from the active list, moving the last
+// entry of each into its slot
+void TiledClustering::_remove(int ijet){
+  Tile & tile = _tiles[_tile[ijet]];
+  unsigned int pos = _tile_pos[ijet];
+  int moved = tile.jet.back();
+  tile.rap[pos] = tile.rap.back(); tile.rap.pop_back();
+  tile.phi[pos] = tile.phi.back(); tile.phi.pop_back();
+  tile.jet[pos] = moved;           tile.jet.pop_back();
+  _tile_pos[moved] = pos;
+
+  pos = _active_pos[ijet];
+  moved = _active.back();
+  _active[pos] = moved; _active.pop_back();
+  _diJ[pos] = _diJ.back(); _diJ.pop_back();
+  _active_pos[moved] = pos;
+}
+
+//----------------------------------------------------------------------
+// nearest neighbour of ijet among the jets closer than R
+void TiledClustering::_find_nn(int ijet){
+  double best = _R2;
+  int nn = -1;
+
+  // move ijet out of reach while scanning its own tile
+  Tile & own = _tiles[_tile[ijet]];
+  double & own_rap = own.rap[_tile_pos[ijet]];
+  own_rap = numeric_limits<double>::infinity();
+
+  const vector<int> & neighbours = own.neighbours;
+  for (unsigned int it = 0; it < neighbours.size(); it++){
+    const Tile & tile = _tiles[neighbours[it]];
+    int pos = _nearest(tile.rap.data(), tile.phi.data(), tile.rap.size(),
+                       _rap[ijet], _phi[ijet], best);
+    if (pos >= 0) nn = tile.jet[pos];
+  }
+  own_rap = _rap[ijet];
+
+  _nn[ijet] = nn;
+  _nn_dist[ijet] = best;
+}
+
+//----------------------------------------------------------------------
+// same as ClusterSequence::_bj_diJ
+void TiledClustering::_set_diJ(int ijet){
+  double w = _w[ijet];
+  int nn = _nn[ijet];
+  if (nn >= 0 && _w[nn] < w) w = _w[nn];
+  _diJ[_active_pos[ijet]] = _nn_dist[ijet] * w;
+}
+
+//----------------------------------------------------------------------
+void TiledClustering::_mark_neighbourhood(int itile){
+  const vector<int> & neighbours = _tiles[itile].neighbours;
+  for (unsigned int it = 0; it < neighbours.size(); it++){
+    if (_tile_mark[neighbours[it]] == _mark) continue;
+    _tile_mark[neighbours[it]] = _mark;
+    _marked_tiles.push_back(neighbours[it]);
+  }
+}
+
+//----------------------------------------------------------------------
+void TiledClustering::run(){
+  unsigned int n = _cs.jets().size();
+  if (n == 0) return;
+
+  _setup_tiles(n);
+  _rap.resize(2*n); _phi.resize(2*n); _w.resize(2*n); _nn_dist.resize(2*n);
+  _nn.resize(2*n); _tile.resize(2*n); _tile_pos.resize(2*n); _active_pos.resize(2*n);
+  _active.reserve(n);
+  _diJ.reserve(n);
+
+  for (unsigned int i = 0; i < n; i++) _insert(i);
+  for (unsigned int i = 0; i < n; i++) _find_nn(i);
+  for (unsigned int i = 0; i < n; i++) _set_diJ(i);
+
+  while (!_active.empty()){
+    double diJ_min = numeric_limits<double>::infinity();
+    int pos = _minimum(_diJ.data(), _diJ.size(), diJ_min);
+    if (pos < 0){ pos = 0; diJ_min = _diJ[0]; }
+    int ia = _active[pos], ib = _nn[ia];
+
+    _mark++;
+    _marked_tiles.clear();
+    _mark_neighbourhood(_tile[ia]);
+
+    if (ib >= 0){
+      int inew;
+      _mark_neighbourhood(_tile[ib]);
+      _cs.plugin_record_ij_recombination(ia, ib, diJ_min*_invR2, inew);
+      _remove(ia);
+      _remove(ib);
+      _insert(inew);
+      _find_nn(inew);
+      _mark_neighbourhood(_tile[inew]);
+
+      // jets that had ia or ib as their neighbour need a new search;
+      // the others may now be closest to the new jet
+      for (unsigned int it = 0; it < _marked_tiles.size(); it++){
+        const Tile & tile = _tiles[_marked_tiles[it]];
+        unsigned int n_members = tile.jet.size();
+        if (_scratch.size() < n_members) _scratch.resize(n_members);
+        _distances(tile.rap.data(), tile.phi.data(), n_members, _rap[inew], _phi[inew], _scratch.data());
+        for (unsigned int j = 0; j < n_members; j++){
+          int ijet = tile.jet[j];
+          if (ijet == inew) continue;
+          if (_nn[ijet] == ia || _nn[ijet] == ib){
+            _find_nn(ijet);
+          } else if (_scratch[j] < _nn_dist[ijet]){
+            _nn[ijet] = inew;
+            _nn_dist[ijet] = _scratch[j];
+          } else {
+            continue;
+          }
+          _set_diJ(ijet);
+        }
+      }
+      _set_diJ(inew);
+    } else {
+      _cs.plugin_record_iB_recombination(ia, diJ_min*_invR2);
+      _remove(ia);
+      for (unsigned int it = 0; it < _marked_tiles.size(); it++){
+        const Tile & tile = _tiles[_marked_tiles[it]];
+        for (unsigned int j = 0; j < tile.jet.size(); j++){
+          int ijet = tile.jet[j];
+          if (_nn[ijet] != ia) continue;
+          _find_nn(ijet);
+          _set_diJ(ijet);
+        }
+      }
+    }
+  }
+}
+
+} // anonymous namespace
+
+//----------------------------------------------------------------------
+SoATiledPlugin::SoATiledPlugin(JetAlgorithm algorithm, double R, Kernel kernel)
+  : _algorithm(algorithm), _R(R), _kernel(kernel){
+  if (algorithm == kt_algorithm) _p = 1;
+  else if (algorithm == cambridge_algorithm) _p = 0;
+  else if (algorithm == antikt_algorithm) _p = -1;
+  else throw Error("SoATiledPlugin: only kt, cambridge and antikt are supported (use the genkt constructor)");
+  if (_kernel == automatic) _kernel = best_kernel();
+  else if (_kernel > best_kernel())
+    throw Error("SoATiledPlugin: the "+kernel_name(_kernel)+" kernel is not supported on this CPU");
+}
+
+//----------------------------------------------------------------------
+SoATiledPlugin::SoATiledPlugin(double R, double p, Kernel kernel)
+  : _algorithm(genkt_algorithm), _R(R), _p(p), _kernel(kernel){
+  if (_kernel == automatic) _kernel = best_kernel();
+  else if (_kernel > best_kernel())
+    throw Error("SoATiledPlugin: the "+kernel_name(_kernel)+" kernel is not supported on this CPU");
+}
+
+//----------------------------------------------------------------------
+string SoATiledPlugin::description() const{
+  ostringstream desc;
+  desc << "SoA tiled ";
+  if      (_algorithm == kt_algorithm)        desc << "kt";
+  else if (_algorithm == cambridge_algorithm) desc << "Cambridge/Aachen";
+  else if (_algorithm == antikt_algorithm)    desc << "anti-kt";
+  else desc << "generalised kt (p = " << _p << ")";
+  desc << " plugin with R = " << _R << " (" << kernel_name(_kernel) << " kernels)";
+  return desc.str();
+}
+
+//----------------------------------------------------------------------
+void SoATiledPlugin::run_clustering(ClusterSequence & cs) const{
+  TiledClustering clustering(cs, _algorithm, _R, _p, _kernel);
+  clustering.run();
+}
+
+//----------------------------------------------------------------------
+string SoATiledPlugin::kernel_name(Kernel kernel){
+  switch (kernel){
+  case automatic: return "automatic";
+  case scalar:    return "scalar";
+  case avx2:      return "avx2";
+  case avx512:    return "avx512";
+  }
+  return "unknown";
+}
+
+//----------------------------------------------------------------------
+SoATiledPlugin::Kernel SoATiledPlugin::best_kernel(){
+#ifdef FCC_SOA_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return avx512;
+  if (__builtin_cpu_supports("avx2")) return avx2;
+#endif
+  return scalar;
+}
+
+} // namespace fcc
@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------
+/// \file
+/// A kt / Cambridge-Aachen / anti-kt clustering plugin working on
+/// tiles stored as structure-of-arrays, with SIMD nearest-neighbour
+/// kernels
+//----------------------------------------------------------------------
+#ifndef __FCC_SOATILEDPLUGIN_HH__
+#define __FCC_SOATILEDPLUGIN_HH__
+
+#include "fastjet/JetDefinition.hh"
+#include "fastjet/ClusterSequence.hh"
+#include <string>
+
+namespace fcc {
+
+/// \class SoATiledPlugin
+/// generalised-kt clustering (kt, C/A, anti-kt) on SoA tiles
+///
+/// The rapidity-phi plane is divided into tiles at least R wide, so
+/// that the nearest neighbour of a jet is always within the 3x3 tiles
+/// around it. Each tile keeps the rapidity, phi and jet index of its
+/// members in contiguous arrays, and the geometric distances from a
+/// jet to all the members of a tile are computed in one go by an
+/// AVX-512, AVX2 or scalar kernel (chosen at run time from what the
+/// CPU supports). The search for the smallest d_iJ also runs on a
+/// contiguous array.
+///
+/// Distances and momentum-dependent factors are evaluated exactly as
+/// in ClusterSequence's own strategies (floating-point contraction is
+/// disabled in the implementation for that purpose), so that the
+/// sequence of d_ij and the jets are identical to those obtained with
+/// the native algorithms. Only the order of the two parents of a
+/// recombination may differ, and exact ties between distances may be
+/// resolved differently.
+///
+/// Usage:
+///   fcc::SoATiledPlugin plugin(fastjet::antikt_algorithm, 0.4);
+///   fastjet::JetDefinition jet_def(&plugin);
+class SoATiledPlugin : public fastjet::JetDefinition::Plugin {
+public:
+  /// the kernels that can be used
+  enum Kernel { automatic, scalar, avx2, avx512 };
+
+  /// ctor for kt_algorithm, cambridge_algorithm or antikt_algorithm
+  SoATiledPlugin(fastjet::JetAlgorithm algorithm, double R, Kernel kernel = automatic);
+
+  /// ctor for the generalised kt algorithm with exponent p
+  SoATiledPlugin(double R, double p, Kernel kernel = automatic);
+
+  virtual std::string description() const;
+  virtual void run_clustering(fastjet::ClusterSequence & cs) const;
+  virtual double R() const { return _R; }
+
+  /// the exclusive sequence is meaningful for p >= 0 (kt, C/A)
+  virtual bool exclusive_sequence_meaningful() const { return _p >= 0; }
+
+  /// the kernel actually used (after resolving "automatic")
+  Kernel kernel() const { return _kernel; }
+
+  /// name of a kernel
+  static std::string kernel_name(Kernel kernel);
+
+  /// the best kernel supported by this CPU
+  static Kernel best_kernel();
+
+private:
+  fastjet::JetAlgorithm _algorithm;
+  double _R, _p;
+  Kernel _kernel;
+};
+
+} // namespace fcc
+
+#endif // __FCC_SOATILEDPLUGIN_HH__
@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::SoftKiller
+//----------------------------------------------------------------------
+#include "fcc/SoftKiller.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+const double twopi = 2*M_PI;
+}
+
+//----------------------------------------------------------------------
+SoftKiller::SoftKiller(double max_rap, double cell_size)
+  : _max_rap(max_rap), _pt_threshold(0.0), _n_in(0), _n_out(0){
+  if ((max_rap <= 0) || (cell_size <= 0))
+    throw Error("SoftKiller: max_rap and cell_size must be positive");
+  _n_rap = int(max(1.0, 2*max_rap/cell_size + 0.5));
+  _n_phi = int(max(1.0, twopi/cell_size + 0.5));
+  _drap = 2*max_rap/_n_rap;
+  _dphi = twopi/_n_phi;
+}
+
+//----------------------------------------------------------------------
+string SoftKiller::description() const{
+  ostringstream oss;
+  oss << "SoftKiller with " << _n_rap << " x " << _n_phi << " cells of "
+      << _drap << " x " << _dphi << " up to |y| = " << _max_rap;
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void SoftKiller::apply(const vector<PseudoJet> & event, vector<PseudoJet> & reduced){
+  unsigned int n = event.size();
+  _pt2.resize(n);
+  _cell.resize(n);
+
+  // cell (-1 outside the grid) and pt^2 of every particle
+  const double inverse_drap = _n_rap/(2*_max_rap), inverse_dphi = _n_phi/twopi;
+  const int n_rap = _n_rap, n_phi = _n_phi;
+  for (unsigned int i = 0; i < n; i++){
+    const PseudoJet & p = event[i];
+    _pt2[i] = p.pt2();
+    double y = p.rap() + _max_rap;
+    int row = int(y*inverse_drap);
+    int column = int(p.phi()*inverse_dphi);
+    column = (column == n_phi) ? 0 : column;
+    _cell[i] = ((y < 0) || (row >= n_rap)) ? -1 : row*n_phi + column;
+  }
+
+  // the largest pt^2 in each cell, and its median over the cells
+  unsigned int n_cells = _n_rap*_n_phi;
+  _max_pt2.assign(n_cells, 0.0);
+  const int * cell = _cell.data();
+  const double * pt2 = _pt2.data();
+  double * max_pt2 = _max_pt2.data();
+  for (unsigned int i = 0; i < n; i++){
+    if ((cell[i] >= 0) && (pt2[i] > max_pt2[cell[i]])) max_pt2[cell[i]] = pt2[i];
+  }
+  unsigned int median = n_cells/2;
+  nth_element(_max_pt2.begin(), _max_pt2.begin() + median, _max_pt2.end());
+  // slightly above the median, so that the particle setting it goes
+  double pt2_cut = (1+1e-12)*_max_pt2[median];
+  _pt_threshold = sqrt(pt2_cut);
+
+  reduced.clear();
+  for (unsigned int i = 0; i < n; i++){
+    if (pt2[i] >= pt2_cut) reduced.push_back(event[i]);
+  }
+  _n_in  = n;
+  _n_out = reduced.size();
+}
+
+} // namespace fcc
@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------
+/// \file
+/// A SoftKiller pileup pre-filter: a per-event pt threshold from a
+/// rapidity-phi grid, applied before any clustering
+//----------------------------------------------------------------------
+#ifndef __FCC_SOFTKILLER_HH__
+#define __FCC_SOFTKILLER_HH__
+
+#include "fastjet/PseudoJet.hh"
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// \class SoftKiller
+/// removes the particles below a pt threshold chosen, event by event,
+/// so that half of the cells of a rapidity-phi grid are left empty
+/// (Cacciari, Salam and Soyez, arXiv:1407.0408)
+///
+/// The grid covers |y| < max_rap with cells of about cell_size x
+/// cell_size, placed as in fastjet::RectangularGrid. The threshold is
+/// the median over the cells of the largest particle pt in each cell
+/// (0 for empty cells), so that after the cut the median cell is
+/// empty. Every particle, inside the grid or not, is then kept if its
+/// pt is above the threshold, as for the SoftKiller contrib.
+///
+/// The whole filter is linear in the number of particles: one pass
+/// computes the cells and pt^2 of the particles into flat arrays,
+/// one pass takes the maximum per cell, the median is found with
+/// nth_element over the cells, and one pass copies the particles
+/// that are kept. The buffers are reused from one event to the next.
+class SoftKiller {
+public:
+  SoftKiller(double max_rap = 5.0, double cell_size = 0.4);
+
+  std::string description() const;
+
+  /// put in "reduced" (which must not be "event") the particles of
+  /// "event" above the threshold
+  void apply(const std::vector<fastjet::PseudoJet> & event,
+             std::vector<fastjet::PseudoJet> & reduced);
+  std::vector<fastjet::PseudoJet> operator()(const std::vector<fastjet::PseudoJet> & event){
+    std::vector<fastjet::PseudoJet> reduced;
+    apply(event, reduced);
+    return reduced;
+  }
+
+  /// the threshold of the last event, and the number of particles
+  /// before and after the cut
+  double pt_threshold() const { return _pt_threshold; }
+  unsigned int n_in()  const { return _n_in; }
+  unsigned int n_out() const { return _n_out; }
+
+  unsigned int n_rap() const { return _n_rap; }
+  unsigned int n_phi() const { return _n_phi; }
+
+private:
+  double _max_rap, _drap, _dphi;
+  unsigned int _n_rap, _n_phi;
+  double _pt_threshold;
+  unsigned int _n_in, _n_out;
+  std::vector<double> _pt2, _max_pt2;
+  std::vector<int> _cell;
+};
+
+} // namespace fcc
+
+#endif // __FCC_SOFTKILLER_HH__
@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::StrategyCalibration
+//----------------------------------------------------------------------
+#include "fcc/StrategyCalibration.hh"
+#include "fastjet/Error.hh"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+  struct StrategyEntry { Strategy strategy; const char * name; };
+  const StrategyEntry strategy_names[] = {
+    {N2MHTLazy9,     "N2MHTLazy9"},
+    {N2MHTLazy25,    "N2MHTLazy25"},
+    {N2MinHeapTiled, "N2MinHeapTiled"},
+    {N2Tiled,        "N2Tiled"},
+    {N2PoorTiled,    "N2PoorTiled"},
+    {N2Plain,        "N2Plain"},
+    {N3Dumb,         "N3Dumb"},
+    {Best,           "Best"},
+    {NlnN,           "NlnN"},
+    {NlnN3pi,        "NlnN3pi"},
+    {NlnN4pi,        "NlnN4pi"},
+    {NlnNCam4pi,     "NlnNCam4pi"},
+    {NlnNCam2pi2R,   "NlnNCam2pi2R"},
+    {NlnNCam,        "NlnNCam"}};
+  const unsigned int n_strategy_names = sizeof(strategy_names)/sizeof(strategy_names[0]);
+
+  struct AlgorithmEntry { JetAlgorithm algorithm; const char * name; };
+  const AlgorithmEntry algorithm_names[] = {
+    {kt_algorithm,        "kt"},
+    {cambridge_algorithm, "cambridge"},
+    {antikt_algorithm,    "antikt"},
+    {genkt_algorithm,     "genkt"}};
+  const unsigned int n_algorithm_names = sizeof(algorithm_names)/sizeof(algorithm_names[0]);
+}
+
+//----------------------------------------------------------------------
+string strategy_name(Strategy strategy){
+  for (unsigned int i = 0; i < n_strategy_names; i++)
+    if (strategy_names[i].strategy == strategy) return strategy_names[i].name;
+  ostringstream oss;
+  oss << "strategy" << int(strategy);
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+Strategy strategy_from_name(const string & name){
+  for (unsigned int i = 0; i < n_strategy_names; i++)
+    if (name == strategy_names[i].name) return strategy_names[i].strategy;
+  throw Error("strategy_from_name: unknown strategy "+name);
+}
+
+//----------------------------------------------------------------------
+string algorithm_name(JetAlgorithm algorithm){
+  for (unsigned int i = 0; i < n_algorithm_names; i++)
+    if (algorithm_names[i].algorithm == algorithm) return algorithm_names[i].name;
+  ostringstream oss;
+  oss << "algorithm" << int(algorithm);
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+JetAlgorithm algorithm_from_name(const string & name){
+  for (unsigned int i = 0; i < n_algorithm_names; i++)
+    if (name == algorithm_names[i].name) return algorithm_names[i].algorithm;
+  throw Error("algorithm_from_name: unknown algorithm "+name);
+}
+
+//----------------------------------------------------------------------
+vector<Strategy> candidate_strategies(JetAlgorithm algorithm){
+  vector<Strategy> strategies;
+  strategies.push_back(N2MHTLazy9);
+  strategies.push_back(N2MHTLazy25);
+  strategies.push_back(N2MinHeapTiled);
+  strategies.push_back(N2Tiled);
+  strategies.push_back(N2PoorTiled);
+  strategies.push_back(N2Plain);
+  strategies.push_back(NlnN);
+  strategies.push_back(NlnN3pi);
+  strategies.push_back(NlnN4pi);
+  if (algorithm == cambridge_algorithm){
+    strategies.push_back(NlnNCam4pi);
+    strategies.push_back(NlnNCam2pi2R);
+    strategies.push_back(NlnNCam);
+  }
+  return strategies;
+}
+
+//----------------------------------------------------------------------
+JetDefinition with_strategy(const JetDefinition & jet_def, Strategy strategy){
+  // only the native pp algorithms have a choice of strategies
+  JetAlgorithm algorithm = jet_def.jet_algorithm();
+  if ((algorithm != kt_algorithm) && (algorithm != cambridge_algorithm) &&
+      (algorithm != antikt_algorithm) && (algorithm != genkt_algorithm)) return jet_def;
+  if (jet_def.strategy() == strategy) return jet_def;
+
+  JetDefinition tuned = (jet_def.jet_algorithm() == genkt_algorithm)
+    ? JetDefinition(jet_def.jet_algorithm(), jet_def.R(), jet_def.extra_param(),
+                    jet_def.recombination_scheme(), strategy)
+    : JetDefinition(jet_def.jet_algorithm(), jet_def.R(),
+                    jet_def.recombination_scheme(), strategy);
+  tuned.set_recombiner(jet_def);
+  return tuned;
+}
+
+//----------------------------------------------------------------------
+// StrategyCalibration
+//----------------------------------------------------------------------
+StrategyCalibration::StrategyCalibration(const string & filename){
+  ifstream istr(filename.c_str());
+  if (!istr) throw Error("StrategyCalibration: could not open "+filename);
+  read(istr);
+}
+
+//----------------------------------------------------------------------
+void StrategyCalibration::set(JetAlgorithm algorithm, unsigned int n_min, Strategy strategy){
+  _table[algorithm][n_min] = strategy;
+}
+
+//----------------------------------------------------------------------
+Strategy StrategyCalibration::strategy(JetAlgorithm algorithm, unsigned int n) const{
+  map<JetAlgorithm, Thresholds>::const_iterator it = _table.find(algorithm);
+  if (it == _table.end()) return Best;
+
+  // the last entry with n_min <= n
+  Thresholds::const_iterator entry = it->second.upper_bound(n);
+  if (entry == it->second.begin()) return Best;
+  --entry;
+  return entry->second;
+}
+
+//----------------------------------------------------------------------
+void StrategyCalibration::set_from_timings(JetAlgorithm algorithm,
+                                           const vector<unsigned int> & multiplicities,
+                                           const vector<Strategy> & strategies,
+                                           const vector<vector<double> > & timings){
+  Thresholds & thresholds = _table[algorithm];
+  thresholds.clear();
+
+  for (unsigned int i = 0; i < multiplicities.size(); i++){
+    int best = -1;
+    for (unsigned int j = 0; j < strategies.size(); j++){
+      if (timings[i][j] < 0) continue;
+      if ((best < 0) || (timings[i][j] < timings[i][best])) best = j;
+    }
+    if (best < 0) continue;
+
+    unsigned int n_min = (i == 0) ? 0
+      : (unsigned int)(sqrt(double(multiplicities[i-1])*multiplicities[i]));
+    // only record the points where the winner changes
+    if ((!thresholds.empty()) && (thresholds.rbegin()->second == strategies[best])) continue;
+    thresholds[n_min] = strategies[best];
+  }
+}
+
+//----------------------------------------------------------------------
+void StrategyCalibration::write(ostream & ostr) const{
+  ostr << "# clustering strategy calibration" << endl;
+  ostr << "# algorithm n_min strategy" << endl;
+  for (map<JetAlgorithm, Thresholds>::const_iterator it = _table.begin(); it != _table.end(); ++it){
+    for (Thresholds::const_iterator entry = it->second.begin(); entry != it->second.end(); ++entry){
+      ostr << algorithm_name(it->first) << " " << entry->first << " "
+           << strategy_name(entry->second) << endl;
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+void StrategyCalibration::read(istream & istr){
+  string line;
+  while (getline(istr, line)){
+    if (line.empty() || (line[0] == '#')) continue;
+    istringstream iss(line);
+    string algorithm, strategy;
+    unsigned int n_min;
+    if (!(iss >> algorithm >> n_min >> strategy))
+      throw Error("StrategyCalibration: wrong format in line '"+line+"'");
+    set(algorithm_from_name(algorithm), n_min, strategy_from_name(strategy));
+  }
+}
+
+} // namespace fcc
@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------
+/// \file
+/// Per-event choice of the clustering strategy from a measured
+/// calibration table
+///
+/// FastJet's "Best" strategy picks between its N^2 and N ln N
+/// strategies using multiplicity thresholds tuned once, on the CPUs
+/// available at the time. A StrategyCalibration holds thresholds
+/// measured on the machine at hand instead (see
+/// tools/strategy_benchmark.cc), and applies them event by event.
+//----------------------------------------------------------------------
+#ifndef __FCC_STRATEGYCALIBRATION_HH__
+#define __FCC_STRATEGYCALIBRATION_HH__
+
+#include "fastjet/JetDefinition.hh"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fcc {
+
+/// the name of a FastJet strategy (e.g. "N2Tiled")
+std::string strategy_name(fastjet::Strategy strategy);
+
+/// the strategy with the given name; throws fastjet::Error if unknown
+fastjet::Strategy strategy_from_name(const std::string & name);
+
+/// short name of a jet algorithm ("kt", "cambridge", "antikt", ...)
+std::string algorithm_name(fastjet::JetAlgorithm algorithm);
+
+/// the jet algorithm with the given short name; throws fastjet::Error if unknown
+fastjet::JetAlgorithm algorithm_from_name(const std::string & name);
+
+/// all the strategies that can be benchmarked for an algorithm (the
+/// NlnNCam* ones only apply to Cambridge/Aachen)
+std::vector<fastjet::Strategy> candidate_strategies(fastjet::JetAlgorithm algorithm);
+
+/// a copy of jet_def using another strategy
+fastjet::JetDefinition with_strategy(const fastjet::JetDefinition & jet_def,
+                                     fastjet::Strategy strategy);
+
+/// \class StrategyCalibration
+/// table of the fastest strategy per algorithm and multiplicity
+///
+/// For each algorithm, the table is a list of (n_min, strategy)
+/// entries: "strategy" is used for events with at least n_min
+/// particles (and fewer than the next n_min).
+///
+/// The text format, one entry per line, is
+///    algorithm n_min strategy
+/// with '#' starting a comment.
+class StrategyCalibration {
+public:
+  StrategyCalibration() {}
+
+  /// read a calibration from a file; throws fastjet::Error on failure
+  StrategyCalibration(const std::string & filename);
+
+  /// true if there is no entry at all
+  bool empty() const { return _table.empty(); }
+
+  /// use "strategy" for "algorithm" from n_min particles upwards
+  void set(fastjet::JetAlgorithm algorithm, unsigned int n_min,
+           fastjet::Strategy strategy);
+
+  /// the strategy to use for n particles (fastjet::Best when the
+  /// algorithm has not been calibrated)
+  fastjet::Strategy strategy(fastjet::JetAlgorithm algorithm, unsigned int n) const;
+
+  /// jet_def with the strategy for n particles
+  fastjet::JetDefinition tuned(const fastjet::JetDefinition & jet_def, unsigned int n) const {
+    return with_strategy(jet_def, strategy(jet_def.jet_algorithm(), n));
+  }
+
+  /// build the table for one algorithm from measured timings:
+  /// timings[i][j] is the time for multiplicities[i] with
+  /// strategies[j] (negative if not measured). Switch-over points are
+  /// put half-way (geometrically) between the measured multiplicities.
+  void set_from_timings(fastjet::JetAlgorithm algorithm,
+                        const std::vector<unsigned int> & multiplicities,
+                        const std::vector<fastjet::Strategy> & strategies,
+                        const std::vector<std::vector<double> > & timings);
+
+  void write(std::ostream & ostr) const;
+  void read(std::istream & istr);
+
+private:
+  typedef std::map<unsigned int, fastjet::Strategy> Thresholds;
+  std::map<fastjet::JetAlgorithm, Thresholds> _table;
+};
+
+} // namespace fcc
+
+#endif // __FCC_STRATEGYCALIBRATION_HH__
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::SubjetScan
+//----------------------------------------------------------------------
+#include "fcc/SubjetScan.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+SubjetScan::SubjetScan(const vector<double> & dcuts)
+  : _dcuts(dcuts), _cs(0), _n_jets(0){
+  sort(_dcuts.begin(), _dcuts.end());
+}
+
+//----------------------------------------------------------------------
+vector<double> SubjetScan::cambridge_dcuts(double R, const vector<double> & rsubs){
+  vector<double> dcuts(rsubs.size());
+  for (unsigned int i = 0; i < rsubs.size(); i++) dcuts[i] = (rsubs[i]/R)*(rsubs[i]/R);
+  return dcuts;
+}
+
+//----------------------------------------------------------------------
+void SubjetScan::process(const ClusterSequence & cs, const vector<PseudoJet> & jets){
+  const vector<ClusterSequence::history_element> & history = cs.history();
+  unsigned int n_history = history.size(), n_dcuts = _dcuts.size();
+  _cs = &cs;
+  _n_jets = jets.size();
+
+  // the jets' own elements, then (backwards) the elements below them,
+  // each with the range of dcut values it is a subjet for
+  _jet_of.assign(n_history, -1);
+  _k_begin.resize(n_history);
+  _k_end.resize(n_history);
+  for (unsigned int ijet = 0; ijet < _n_jets; ijet++){
+    if (jets[ijet].associated_cluster_sequence() != &cs)
+      throw Error("SubjetScan: the jets must come from the ClusterSequence given");
+    int h = jets[ijet].cluster_hist_index();
+    _jet_of[h] = ijet;
+    _k_end[h] = n_dcuts;
+  }
+  for (int h = n_history-1; h >= 0; h--){
+    const ClusterSequence::history_element & element = history[h];
+    if (_jet_of[h] < 0){
+      if ((element.child < 0) || (_jet_of[element.child] < 0)) continue;
+      _jet_of[h] = _jet_of[element.child];
+      _k_end[h] = lower_bound(_dcuts.begin(), _dcuts.end(),
+                              history[element.child].max_dij_so_far) - _dcuts.begin();
+    }
+    _k_begin[h] = (element.parent1 < 0) ? 0 :
+      lower_bound(_dcuts.begin(), _dcuts.end(), element.max_dij_so_far) - _dcuts.begin();
+  }
+
+  // count the subjets of each (jet, dcut), then file the elements in
+  // increasing history order (the order of exclusive_subjets)
+  _offsets.assign(_n_jets*n_dcuts + 1, 0);
+  for (unsigned int h = 0; h < n_history; h++){
+    if (_jet_of[h] < 0) continue;
+    unsigned int base = _jet_of[h]*n_dcuts;
+    for (unsigned int k = _k_begin[h]; k < _k_end[h]; k++) _offsets[base+k+1]++;
+  }
+  for (unsigned int i = 0; i < _n_jets*n_dcuts; i++) _offsets[i+1] += _offsets[i];
+
+  _hist_indices.resize(_offsets.back());
+  vector<unsigned int> next(_offsets.begin(), _offsets.end()-1);
+  for (unsigned int h = 0; h < n_history; h++){
+    if (_jet_of[h] < 0) continue;
+    unsigned int base = _jet_of[h]*n_dcuts;
+    for (unsigned int k = _k_begin[h]; k < _k_end[h]; k++) _hist_indices[next[base+k]++] = h;
+  }
+}
+
+//----------------------------------------------------------------------
+vector<PseudoJet> SubjetScan::subjets(unsigned int ijet, unsigned int k) const{
+  const vector<ClusterSequence::history_element> & history = _cs->history();
+  const vector<PseudoJet> & cs_jets = _cs->jets();
+  unsigned int i = ijet*_dcuts.size() + k;
+  vector<PseudoJet> result;
+  result.reserve(_offsets[i+1] - _offsets[i]);
+  for (unsigned int j = _offsets[i]; j < _offsets[i+1]; j++)
+    result.push_back(cs_jets[history[_hist_indices[j]].jetp_index]);
+  return result;
+}
+
+} // namespace fcc
@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------
+/// \file
+/// Exclusive subjets of all the jets of an event at several dcut
+/// values, from one pass over the clustering history
+//----------------------------------------------------------------------
+#ifndef __FCC_SUBJETSCAN_HH__
+#define __FCC_SUBJETSCAN_HH__
+
+#include "fastjet/ClusterSequence.hh"
+#include <vector>
+
+namespace fcc {
+
+/// \class SubjetScan
+/// jet.exclusive_subjets(dcut) for every jet and every dcut at once
+///
+/// ClusterSequence::exclusive_subjets(dcut) undoes the merging steps
+/// of a jet whose max_dij_so_far is above dcut. Since max_dij_so_far
+/// never decreases along the history, a history element h below a
+/// jet is a subjet exactly for
+///
+///   max_dij_so_far(h) <= dcut < max_dij_so_far(child of h)
+///
+/// (any dcut above max_dij_so_far for the jet itself, any dcut below
+/// the child's for an input particle). process() therefore assigns
+/// each element to its jet in one backward pass over the history,
+/// finds the range of dcut values it is a subjet for by binary search,
+/// and files it under each of them. The cost grows with the number of
+/// history steps (times log of the number of dcut values) plus the
+/// size of the output, rather than with jets x dcut values.
+///
+/// The subjets of a (jet, dcut) pair are the same PseudoJets, in the
+/// same order, as jet.exclusive_subjets(dcut).
+class SubjetScan {
+public:
+  /// the dcut values to scan (kept in increasing order)
+  SubjetScan(const std::vector<double> & dcuts);
+
+  /// the dcut values such that, for C/A with radius R, the subjets
+  /// are those of C/A with radius Rsub, i.e. dcut = (Rsub/R)^2
+  static std::vector<double> cambridge_dcuts(double R, const std::vector<double> & rsubs);
+
+  /// the subjets of "jets", which must all come from "cs"
+  void process(const fastjet::ClusterSequence & cs, const std::vector<fastjet::PseudoJet> & jets);
+
+  /// number of dcut values, and dcut value k
+  unsigned int n_dcuts() const { return _dcuts.size(); }
+  double dcut(unsigned int k) const { return _dcuts[k]; }
+
+  /// number of jets of the last call
+  unsigned int n_jets() const { return _n_jets; }
+
+  /// number of subjets of jet ijet for dcut(k)
+  unsigned int n_subjets(unsigned int ijet, unsigned int k) const {
+    unsigned int i = ijet*_dcuts.size() + k;
+    return _offsets[i+1] - _offsets[i];
+  }
+
+  /// the subjets of jet ijet for dcut(k)
+  std::vector<fastjet::PseudoJet> subjets(unsigned int ijet, unsigned int k) const;
+
+private:
+  std::vector<double> _dcuts;
+  const fastjet::ClusterSequence * _cs;
+  unsigned int _n_jets;
+  std::vector<int> _jet_of;                  ///< jet of each history element (-1: none)
+  std::vector<unsigned int> _k_begin, _k_end; ///< dcut range of each element
+  std::vector<unsigned int> _offsets;        ///< per (jet, dcut), into _hist_indices
+  std::vector<int> _hist_indices;            ///< the subjets' history elements
+};
+
+} // namespace fcc
+
+#endif // __FCC_SUBJETSCAN_HH__
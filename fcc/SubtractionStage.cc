@@ -0,0 +1,88 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::SubtractionStage
+//----------------------------------------------------------------------
+#include "fcc/SubtractionStage.hh"
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+// the lattice is that of the main clustering's GhostedAreaSpec (up
+// to |y|=6), which the background estimation uses as well
+SubtractionStage::SubtractionStage(unsigned int n_threads, unsigned long seed)
+  : _n_threads(n_threads), _seed(seed), _lattice(_area_def.ghost_spec()){
+  _ghosts.reserve(_lattice.n_cells());
+  if (_n_threads > 1) _pool.reset(new ThreadPool(_n_threads < 3 ? _n_threads : 3));
+}
+
+//----------------------------------------------------------------------
+EventAnalysis * SubtractionStage::clone() const{
+  SubtractionStage * stage = new SubtractionStage(_n_threads, _seed);
+  if (_soft_killer) stage->set_soft_killer(*_soft_killer);
+  return stage;
+}
+
+//----------------------------------------------------------------------
+string SubtractionStage::description() const{
+  ostringstream oss;
+  oss << SubtractionAnalysis::description() << " (shared inputs and ghosts, "
+      << (_pool ? _pool->n_threads() : 1) << " clustering threads)";
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void SubtractionStage::process(const Event & event, unsigned long iev){
+  // build the full event once and take the hard event from it
+  _full_event.clear();
+  _hard_event.clear();
+  event.append_pseudojets(_full_event, 0, event.size());
+  unsigned int n_kept = 0;
+  for (unsigned int i = 0; i < _full_event.size(); i++) {
+    if (abs(_full_event[i].rap()) > _particle_maxrap) continue;
+    if (event.subevent(i) == 0) _hard_event.push_back(_full_event[i]);
+    _full_event[n_kept++] = _full_event[i];
+  }
+  _full_event.resize(n_kept);
+  _filter_full_event();
+
+  // one ghost set for the event, then the three clusterings
+  GhostLattice::seed_for_event(_random, _seed, iev);
+  _lattice.generate(_random, _ghosts);
+  if (_pool){
+    for (unsigned int i = 0; i < 3; i++)
+      _pool->submit([this, i](unsigned int){ _cluster(i); });
+    _pool->wait();
+  } else {
+    for (unsigned int i = 0; i < 3; i++) _cluster(i);
+  }
+
+  _hard_jets = sorted_by_pt(_cs_hard->inclusive_jets(_ptmin));
+  _full_jets = sorted_by_pt(_cs_full->inclusive_jets(_ptmin));
+
+  _bkgd_estimator.set_cluster_sequence(*_cs_bkgd);
+  _rho   = _bkgd_estimator.rho();
+  _sigma = _bkgd_estimator.sigma();
+  _subtracted_jets = _subtractor(_full_jets);
+}
+
+//----------------------------------------------------------------------
+// clustering 0: hard event, 1: full event, 2: background estimation
+void SubtractionStage::_cluster(unsigned int iclustering){
+  double ghost_area = _lattice.ghost_area();
+  switch (iclustering){
+  case 0:
+    _cs_hard.reset(new ClusterSequenceActiveAreaExplicitGhosts(_hard_event, _jet_def, _ghosts, ghost_area));
+    break;
+  case 1:
+    _cs_full.reset(new ClusterSequenceActiveAreaExplicitGhosts(_full_event, _jet_def, _ghosts, ghost_area));
+    break;
+  default:
+    _cs_bkgd.reset(new ClusterSequenceActiveAreaExplicitGhosts(_full_event, _jet_def_bkgd, _ghosts, ghost_area));
+  }
+}
+
+} // namespace fcc
@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::ThreadPool and fcc::OrderedOutput
+//----------------------------------------------------------------------
+#include "fcc/ThreadPool.hh"
+
+using namespace std;
+
+namespace fcc {
+
+//----------------------------------------------------------------------
+// ThreadPool
+//----------------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned int n_threads)
+  : _n_queued(0), _n_pending(0), _next_queue(0), _stop(false){
+  if (n_threads == 0) n_threads = hardware_threads();
+  for (unsigned int i = 0; i < n_threads; i++)
+    _queues.push_back(unique_ptr<WorkerQueue>(new WorkerQueue()));
+  for (unsigned int i = 0; i < n_threads; i++)
+    _threads.push_back(thread(&ThreadPool::_run, this, i));
+}
+
+//----------------------------------------------------------------------
+ThreadPool::~ThreadPool(){
+  {
+    unique_lock<mutex> lock(_mutex);
+    _all_done.wait(lock, [this]{ return _n_pending == 0; });
+    _stop = true;
+  }
+  _work_available.notify_all();
+  for (unsigned int i = 0; i < _threads.size(); i++) _threads[i].join();
+}
+
+//----------------------------------------------------------------------
+unsigned int ThreadPool::hardware_threads(){
+  unsigned int n = thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+//----------------------------------------------------------------------
+void ThreadPool::submit(const Task & task){
+  // both counts go up before the task becomes visible to the workers:
+  // otherwise a fast worker could run it and decrement them first,
+  // letting wait() return early (or _n_queued wrap around)
+  unsigned int iqueue;
+  {
+    lock_guard<mutex> lock(_mutex);
+    iqueue = _next_queue;
+    _next_queue = (_next_queue+1) % _queues.size();
+    _n_pending++;
+    _n_queued++;
+  }
+  {
+    lock_guard<mutex> lock(_queues[iqueue]->mutex);
+    _queues[iqueue]->tasks.push_back(task);
+  }
+  _work_available.notify_one();
+}
+
+//----------------------------------------------------------------------
+void ThreadPool::wait(){
+  unique_lock<mutex> lock(_mutex);
+  _all_done.wait(lock, [this]{ return _n_pending == 0; });
+  if (_exception){
+    exception_ptr exception = _exception;
+    _exception = exception_ptr();
+    rethrow_exception(exception);
+  }
+}
+
+//----------------------------------------------------------------------
+// take a task from our own queue, or steal one from the others
+bool ThreadPool::_take(unsigned int iworker, Task & task){
+  {
+    WorkerQueue & own = *_queues[iworker];
+    lock_guard<mutex> lock(own.mutex);
+    if (!own.tasks.empty()){
+      task = own.tasks.front();
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  for (unsigned int i = 1; i < _queues.size(); i++){
+    WorkerQueue & victim = *_queues[(iworker+i) % _queues.size()];
+    lock_guard<mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()){
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------
+void ThreadPool::_run(unsigned int iworker){
+  Task task;
+  while (true){
+    if (_take(iworker, task)){
+      {
+        lock_guard<mutex> lock(_mutex);
+        _n_queued--;
+      }
+      try {
+        task(iworker);
+      } catch (...) {
+        lock_guard<mutex> lock(_mutex);
+        if (!_exception) _exception = current_exception();
+      }
+      task = Task();
+
+      bool done;
+      {
+        lock_guard<mutex> lock(_mutex);
+        done = (--_n_pending == 0);
+      }
+      if (done) _all_done.notify_all();
+      continue;
+    }
+
+    // nothing to do: sleep until a task is queued (a task counted in
+    // _n_queued but not yet taken means we should look again)
+    unique_lock<mutex> lock(_mutex);
+    _work_available.wait(lock, [this]{ return _stop || _n_queued > 0; });
+    if (_stop && _n_queued == 0) return;
+  }
+}
+
+//----------------------------------------------------------------------
+// OrderedOutput
+//----------------------------------------------------------------------
+void OrderedOutput::set(unsigned long index, const string & output){
+  {
+    lock_guard<mutex> lock(_mutex);
+    if (index != _next){
+      _waiting[index] = output;
+      return;
+    }
+    _ostr << output;
+    _next++;
+    map<unsigned long, string>::iterator it;
+    while ((it = _waiting.find(_next)) != _waiting.end()){
+      _ostr << it->second;
+      _waiting.erase(it);
+      _next++;
+    }
+  }
+  _written.notify_all();
+}
+
+//----------------------------------------------------------------------
+unsigned long OrderedOutput::n_written() const{
+  lock_guard<mutex> lock(_mutex);
+  return _next;
+}
+
+//----------------------------------------------------------------------
+void OrderedOutput::wait_for_room(unsigned long n_submitted, unsigned long n_max){
+  unique_lock<mutex> lock(_mutex);
+  _written.wait(lock, [&]{ return n_submitted - _next < n_max; });
+}
+
+} // namespace fcc
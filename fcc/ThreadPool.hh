@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------
+/// \file
+/// A small work-stealing thread pool, and a helper to write results
+/// produced out of order back in their input order
+//----------------------------------------------------------------------
+#ifndef __FCC_THREADPOOL_HH__
+#define __FCC_THREADPOOL_HH__
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fcc {
+
+/// \class ThreadPool
+/// fixed-size pool of worker threads with one task queue per worker
+///
+/// Tasks are dealt round-robin to the workers' queues. A worker takes
+/// tasks from the front of its own queue and, when that is empty,
+/// steals from the back of the other queues, so that events of very
+/// different sizes still keep all the threads busy.
+///
+/// Each task receives the index of the worker running it, which lets
+/// it use per-worker state (e.g. one analysis object per thread)
+/// without any locking.
+class ThreadPool {
+public:
+  typedef std::function<void(unsigned int)> Task;
+
+  /// start n_threads workers (0 means one per hardware thread)
+  ThreadPool(unsigned int n_threads = 0);
+
+  /// waits for the pending tasks and stops the workers
+  ~ThreadPool();
+
+  /// number of worker threads
+  unsigned int n_threads() const { return _threads.size(); }
+
+  /// queue a task
+  void submit(const Task & task);
+
+  /// wait until all the tasks submitted so far have completed. If a
+  /// task threw an exception, the first one is rethrown here.
+  void wait();
+
+  /// the number of hardware threads (at least 1)
+  static unsigned int hardware_threads();
+
+private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void _run(unsigned int iworker);
+  bool _take(unsigned int iworker, Task & task);
+
+  std::vector<std::unique_ptr<WorkerQueue> > _queues;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mutex;                        ///< protects the members below
+  std::condition_variable _work_available, _all_done;
+  unsigned long _n_queued;                  ///< tasks waiting in a queue
+  unsigned long _n_pending;                 ///< tasks submitted but not finished
+  unsigned int _next_queue;                 ///< round-robin position
+  bool _stop;
+  std::exception_ptr _exception;
+
+  ThreadPool(const ThreadPool &);
+  ThreadPool & operator=(const ThreadPool &);
+};
+
+/// \class OrderedOutput
+/// collects the outputs of tasks numbered 0, 1, 2, ... that complete
+/// in any order, and writes them to a stream in that order as soon
+/// as possible
+class OrderedOutput {
+public:
+  OrderedOutput(std::ostream & ostr) : _ostr(ostr), _next(0) {}
+
+  /// hand over the output of task "index" (thread-safe)
+  void set(unsigned long index, const std::string & output);
+
+  /// number of outputs written out so far
+  unsigned long n_written() const;
+
+  /// block until fewer than n_max outputs have been submitted
+  /// (n_submitted in total) without having been written yet. This
+  /// bounds the memory used by the tasks in flight.
+  void wait_for_room(unsigned long n_submitted, unsigned long n_max);
+
+private:
+  std::ostream & _ostr;
+  mutable std::mutex _mutex;
+  std::condition_variable _written;
+  std::map<unsigned long, std::string> _waiting;
+  unsigned long _next;
+};
+
+} // namespace fcc
+
+#endif // __FCC_THREADPOOL_HH__
@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------
+/// \file
+/// Minimal wall-clock timing helpers used by the drivers and
+/// benchmarks
+//----------------------------------------------------------------------
+#ifndef __FCC_TIMER_HH__
+#define __FCC_TIMER_HH__
+
+#include <chrono>
+
+namespace fcc {
+
+/// \class Timer
+/// wall-clock stopwatch, started on construction
+class Timer {
+public:
+  Timer() { start(); }
+
+  /// (re)start the timer
+  void start(){ _start = std::chrono::steady_clock::now(); }
+
+  /// seconds elapsed since the last start()
+  double elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point _start;
+};
+
+/// \class Throughput
+/// accumulates event and particle counts against the time spent on
+/// them
+class Throughput {
+public:
+  Throughput() : _n_events(0), _n_particles(0), _time(0.0) {}
+
+  /// record one event with n_particles particles that took "seconds"
+  void add(unsigned long n_particles, double seconds){
+    _n_events++;
+    _n_particles += n_particles;
+    _time += seconds;
+  }
+
+  unsigned long n_events()    const { return _n_events; }
+  unsigned long n_particles() const { return _n_particles; }
+  double time() const { return _time; }
+
+  double events_per_second()    const { return _time > 0 ? _n_events   /_time : 0.0; }
+  double particles_per_second() const { return _time > 0 ? _n_particles/_time : 0.0; }
+
+private:
+  unsigned long _n_events, _n_particles;
+  double _time;
+};
+
+} // namespace fcc
+
+#endif // __FCC_TIMER_HH__
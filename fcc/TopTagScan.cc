@@ -0,0 +1,242 @@
+//----------------------------------------------------------------------
+/// \file
+/// implementation of fcc::TopTagScan
+//----------------------------------------------------------------------
+#include "fcc/TopTagScan.hh"
+#include "fastjet/Error.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+namespace fcc {
+
+namespace {
+
+const double pi = M_PI, twopi = 2*M_PI;
+
+// the signed mass of a four-momentum, as PseudoJet::m()
+inline double mass2(double px, double py, double pz, double E){
+  return (E+pz)*(E-pz) - (px*px + py*py);
+}
+inline double signed_mass(double m2){
+  return (m2 < 0.0) ? -sqrt(-m2) : sqrt(m2);
+}
+
+// p boosted to the rest frame of "rest", as PseudoJet::unboost()
+void unboost(double p[4], const double rest[4]){
+  if ((rest[0] == 0.0) && (rest[1] == 0.0) && (rest[2] == 0.0)) return;
+  double m = signed_mass(mass2(rest[0], rest[1], rest[2], rest[3]));
+  double pf4 = (-p[0]*rest[0] - p[1]*rest[1] - p[2]*rest[2] + p[3]*rest[3])/m;
+  double fn  = (pf4 + p[3])/(rest[3] + m);
+  p[0] -= fn*rest[0];
+  p[1] -= fn*rest[1];
+  p[2] -= fn*rest[2];
+  p[3] = pf4;
+}
+
+}
+
+//----------------------------------------------------------------------
+TopTagScan::TopTagScan(const Grid & grid) : _grid(grid), _n_jets(0){
+  if (grid.delta_p.empty() || grid.delta_r.empty() || grid.top_mass.empty() || grid.W_mass.empty())
+    throw Error("TopTagScan: the grid needs at least one value of each parameter");
+  _delta_p_min = *min_element(grid.delta_p.begin(), grid.delta_p.end());
+}
+
+//----------------------------------------------------------------------
+string TopTagScan::description() const{
+  ostringstream oss;
+  oss << "JH top tagger scan over " << _grid.delta_p.size() << " delta_p x "
+      << _grid.delta_r.size() << " delta_r values, " << _grid.top_mass.size()
+      << " top and " << _grid.W_mass.size() << " W mass windows, cos(theta_W) < "
+      << _grid.cos_theta_W_max << ", mW = " << _grid.mW;
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+void TopTagScan::process(const vector<PseudoJet> & jets){
+  unsigned int n_points = this->n_points();
+  unsigned int n_windows = _grid.top_mass.size()*_grid.W_mass.size();
+  _n_jets = jets.size();
+  _candidates.resize(_n_jets*n_points);
+  _tagged.assign(_n_jets*n_points*n_windows, 0);
+
+  for (unsigned int ijet = 0; ijet < _n_jets; ijet++){
+    _build_tree(jets[ijet]);
+    double pt_jet = jets[ijet].perp();
+    for (unsigned int idp = 0; idp < _grid.delta_p.size(); idp++){
+      for (unsigned int idr = 0; idr < _grid.delta_r.size(); idr++){
+        unsigned int ipoint = ijet*n_points + point(idp, idr);
+        double top_m2, W_m2;
+        _tag(_candidates[ipoint], pt_jet, _grid.delta_p[idp], _grid.delta_r[idr], top_m2, W_m2);
+
+        // the windows are cuts on m^2, as in SelectorMassRange
+        const Candidate & candidate = _candidates[ipoint];
+        if ((!candidate.found) || (candidate.cos_theta_W > _grid.cos_theta_W_max)) continue;
+        unsigned char * tagged = &_tagged[ipoint*n_windows];
+        for (unsigned int itop = 0; itop < _grid.top_mass.size(); itop++){
+          const pair<double,double> & top_window = _grid.top_mass[itop];
+          if ((top_m2 < top_window.first*top_window.first) ||
+              (top_m2 > top_window.second*top_window.second)) continue;
+          for (unsigned int iW = 0; iW < _grid.W_mass.size(); iW++){
+            const pair<double,double> & W_window = _grid.W_mass[iW];
+            tagged[itop*_grid.W_mass.size() + iW] =
+              (W_m2 >= W_window.first*W_window.first) && (W_m2 <= W_window.second*W_window.second);
+          }
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// copy the tree below the jet, expanding only the nodes that can be
+// declustered for delta_p_min (and the jet itself). The parents of a
+// node are stored harder (in pt) first, as in JHTopTagger.
+void TopTagScan::_build_tree(const PseudoJet & jet){
+  if (!jet.has_associated_cluster_sequence())
+    throw Error("TopTagScan: the jets must have an associated ClusterSequence");
+  const ClusterSequence & cs = *jet.associated_cluster_sequence();
+  if (cs.jet_def().recombination_scheme() != E_scheme)
+    throw Error("TopTagScan: the jets must be clustered with the E-scheme");
+  const vector<ClusterSequence::history_element> & history = cs.history();
+  const vector<PseudoJet> & cs_jets = cs.jets();
+  double pt_cut = _delta_p_min*jet.perp();
+
+  _tree.clear();
+  _stack.clear();
+  int h = jet.cluster_hist_index();
+  _stack.push_back(make_pair(h, 0));
+  _tree.resize(1);
+  while (!_stack.empty()){
+    int inode = _stack.back().second;
+    h = _stack.back().first;
+    _stack.pop_back();
+
+    const PseudoJet & p = cs_jets[history[h].jetp_index];
+    Node & node = _tree[inode];
+    node.px = p.px();  node.py = p.py();  node.pz = p.pz();  node.E = p.E();
+    node.pt2 = p.perp2();
+    node.pt  = p.perp();
+    node.rap = p.rap();
+    node.phi = p.phi();
+    node.harder = node.softer = -1;
+    if ((history[h].parent1 < 0) || ((inode > 0) && (node.pt < pt_cut))) continue;
+
+    int h1 = history[h].parent1, h2 = history[h].parent2;
+    if (cs_jets[history[h2].jetp_index].perp2() > cs_jets[history[h1].jetp_index].perp2()) swap(h1, h2);
+    int n = _tree.size();
+    node.harder = n;
+    node.softer = n+1;
+    _tree.resize(n+2);
+    _stack.push_back(make_pair(h1, n));
+    _stack.push_back(make_pair(h2, n+1));
+  }
+}
+
+//----------------------------------------------------------------------
+// JHTopTagger's _split_once on the cached tree: the harder of the two
+// pieces is returned (-1 if there is no split) and the softer one
+// is put in "softer"
+int TopTagScan::_split_once(int inode, double pt_cut, double delta_r, int & softer) const{
+  while (_tree[inode].harder >= 0){
+    const Node & p1 = _tree[_tree[inode].harder];
+    const Node & p2 = _tree[_tree[inode].softer];
+    if (p1.pt < pt_cut) break;
+    double dphi = p1.phi - p2.phi;
+    if (dphi >  pi) dphi -= twopi;
+    if (dphi < -pi) dphi += twopi;
+    if (std::abs(p2.rap - p1.rap) + std::abs(dphi) < delta_r) break;
+    if (p2.pt < pt_cut){
+      inode = _tree[inode].harder;
+      continue;
+    }
+    softer = _tree[inode].softer;
+    return _tree[inode].harder;
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------
+// the steps of JHTopTagger::result for one (delta_p, delta_r)
+void TopTagScan::_tag(Candidate & candidate, double pt_jet, double delta_p, double delta_r,
+                      double & top_m2, double & W_m2) const{
+  candidate.found = false;
+  candidate.top_m = candidate.top_pt = candidate.W_m = candidate.cos_theta_W = 0.0;
+  top_m2 = W_m2 = 0.0;
+
+  double pt_cut = delta_p*pt_jet;
+  int softer1;
+  int harder1 = _split_once(0, pt_cut, delta_r, softer1);
+  if (harder1 < 0) return;
+
+  int subjets[4], n = 0;
+  int first[2] = {harder1, softer1};
+  for (unsigned int i = 0; i < 2; i++){
+    int softer2;
+    int harder2 = _split_once(first[i], pt_cut, delta_r, softer2);
+    if (harder2 >= 0){
+      subjets[n++] = harder2;
+      subjets[n++] = softer2;
+    } else {
+      subjets[n++] = first[i];
+    }
+  }
+  if (n < 3) return;
+
+  // the pair closest to the W mass
+  double dmW_min = numeric_limits<double>::max();
+  int ii = -1, jj = -1;
+  for (int i = 0; i < n-1; i++){
+    const Node & a = _tree[subjets[i]];
+    for (int j = i+1; j < n; j++){
+      const Node & b = _tree[subjets[j]];
+      double dmW = std::abs(_grid.mW - signed_mass(mass2(a.px+b.px, a.py+b.py, a.pz+b.pz, a.E+b.E)));
+      if (dmW < dmW_min){
+        dmW_min = dmW;
+        ii = i;
+        jj = j;
+      }
+    }
+  }
+
+  // W subjets (harder first), then the others (harder first)
+  if (ii > 0) swap(subjets[ii], subjets[0]);
+  if (jj > 1) swap(subjets[jj], subjets[1]);
+  if (_tree[subjets[0]].pt2 < _tree[subjets[1]].pt2) swap(subjets[0], subjets[1]);
+  if ((n > 3) && (_tree[subjets[2]].pt2 < _tree[subjets[3]].pt2)) swap(subjets[2], subjets[3]);
+
+  const Node & W1 = _tree[subjets[0]];
+  const Node & W2 = _tree[subjets[1]];
+  double W[4] = {W1.px+W2.px, W1.py+W2.py, W1.pz+W2.pz, W1.E+W2.E};
+  double non_W[4] = {_tree[subjets[2]].px, _tree[subjets[2]].py, _tree[subjets[2]].pz, _tree[subjets[2]].E};
+  if (n > 3){
+    const Node & extra = _tree[subjets[3]];
+    non_W[0] += extra.px;  non_W[1] += extra.py;  non_W[2] += extra.pz;  non_W[3] += extra.E;
+  }
+  double top[4] = {W[0]+non_W[0], W[1]+non_W[1], W[2]+non_W[2], W[3]+non_W[3]};
+
+  // cos(theta_W): angle between the softer W subjet and the top in
+  // the W rest frame
+  double W2_W[4] = {W2.px, W2.py, W2.pz, W2.E};
+  double top_W[4] = {top[0], top[1], top[2], top[3]};
+  unboost(W2_W, W);
+  unboost(top_W, W);
+  double modp2_W2  = W2_W[0]*W2_W[0] + W2_W[1]*W2_W[1] + W2_W[2]*W2_W[2];
+  double modp2_top = top_W[0]*top_W[0] + top_W[1]*top_W[1] + top_W[2]*top_W[2];
+
+  top_m2 = mass2(top[0], top[1], top[2], top[3]);
+  W_m2   = mass2(W[0], W[1], W[2], W[3]);
+  candidate.found = true;
+  candidate.top_m  = signed_mass(top_m2);
+  candidate.top_pt = sqrt(top[0]*top[0] + top[1]*top[1]);
+  candidate.W_m    = signed_mass(W_m2);
+  candidate.cos_theta_W = (W2_W[0]*top_W[0] + W2_W[1]*top_W[1] + W2_W[2]*top_W[2])/
+                          sqrt(modp2_W2*modp2_top);
+}
+
+} // namespace fcc
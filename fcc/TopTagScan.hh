@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------
+/// \file
+/// The Johns Hopkins top tagger evaluated over a grid of parameters
+/// on a cached declustering of each jet
+//----------------------------------------------------------------------
+#ifndef __FCC_TOPTAGSCAN_HH__
+#define __FCC_TOPTAGSCAN_HH__
+
+#include "fastjet/ClusterSequence.hh"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fcc {
+
+/// \class TopTagScan
+/// JH top tagging of many jets for a grid of (delta_p, delta_r) and
+/// of top and W mass windows
+///
+/// For every jet, process() copies once the part of its clustering
+/// tree that the tagger can reach for the smallest delta_p (the
+/// branches carrying at least delta_p_min times the jet pt), with the
+/// pt, rapidity and phi of every node. Each (delta_p, delta_r) point
+/// then only walks that cached tree: the two declustering levels, the
+/// choice of the pair closest to mW, cos(theta_W) and the top and W
+/// candidates are computed once per point, and the mass windows are
+/// simple cuts on the candidate masses.
+///
+/// The steps and the cuts are those of fastjet::JHTopTagger (with
+/// SelectorMassRange top and W selectors), for jets from a
+/// ClusterSequence with E-scheme recombination, so that the decisions
+/// are the same as running JHTopTagger for each point.
+class TopTagScan {
+public:
+  /// the parameters scanned
+  struct Grid {
+    Grid() : cos_theta_W_max(0.7), mW(80.4) {}
+    std::vector<double> delta_p, delta_r;
+    std::vector<std::pair<double,double> > top_mass, W_mass; ///< (min, max) windows
+    double cos_theta_W_max, mW;
+  };
+
+  /// the outcome of the declustering for one jet and (delta_p, delta_r)
+  struct Candidate {
+    bool found;         ///< 3 or 4 subjets were found
+    double top_m, top_pt, W_m, cos_theta_W;
+  };
+
+  TopTagScan(const Grid & grid);
+
+  std::string description() const;
+
+  /// tag "jets", which must come from a ClusterSequence with E-scheme
+  /// recombination (e.g. C/A as in boostedTop13)
+  void process(const std::vector<fastjet::PseudoJet> & jets);
+
+  const Grid & grid() const { return _grid; }
+
+  /// number of jets, of (delta_p, delta_r) points, and index of the
+  /// point (idp, idr)
+  unsigned int n_jets() const { return _n_jets; }
+  unsigned int n_points() const { return _grid.delta_p.size()*_grid.delta_r.size(); }
+  unsigned int point(unsigned int idp, unsigned int idr) const { return idp*_grid.delta_r.size() + idr; }
+
+  /// the candidate of jet ijet for point ipoint
+  const Candidate & candidate(unsigned int ijet, unsigned int ipoint) const {
+    return _candidates[ijet*n_points() + ipoint];
+  }
+
+  /// true if jet ijet is tagged at point ipoint with the top mass
+  /// window itop and the W mass window iW
+  bool tagged(unsigned int ijet, unsigned int ipoint, unsigned int itop, unsigned int iW) const {
+    return _tagged[((ijet*n_points() + ipoint)*_grid.top_mass.size() + itop)*_grid.W_mass.size() + iW];
+  }
+
+private:
+  /// a node of the cached tree; harder/softer are -1 for the nodes
+  /// that are not expanded
+  struct Node {
+    double px, py, pz, E, pt2, pt, rap, phi;
+    int harder, softer;
+  };
+
+  void _build_tree(const fastjet::PseudoJet & jet);
+  int _split_once(int node, double pt_cut, double delta_r, int & softer) const;
+  void _tag(Candidate & candidate, double pt_jet, double delta_p, double delta_r,
+            double & top_m2, double & W_m2) const;
+
+  Grid _grid;
+  double _delta_p_min;
+  unsigned int _n_jets;
+  std::vector<Node> _tree;
+  std::vector<std::pair<int,int> > _stack;  ///< (history index, node) to expand
+  std::vector<Candidate> _candidates;
+  std::vector<unsigned char> _tagged;
+};
+
+} // namespace fcc
+
+#endif // __FCC_TOPTAGSCAN_HH__
@@ -0,0 +1,141 @@
+//----------------------------------------------------------------------
+/// \file
+/// cache_benchmark: time the clusterings of fcc::ClusteringCache
+/// (first pass, storing them, and later passes, rebuilding them)
+/// against plain ClusterSequence runs, and check the jets
+///
+/// run it with    : ./cache_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --cache DIR         cache directory (default clustering-cache; its
+///                       entries are removed first)
+///   --max-mb M          size bound of the cache (default 1024 MB)
+///   --minbias FILE      pileup file used to build events at the mu
+///                       values below (overlaid on the events of the
+///                       first file); may be repeated
+///   --mu L              comma-separated list of mu (default 200,1000)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// Every event is clustered with kt, C/A and anti-kt for R = 0.4 and
+/// 0.6, as a scan of analysis cuts over the same events would. The
+/// table gives the time per clustering of ClusterSequence, of the
+/// first pass through the cache (clustering and storing) and of the
+/// later ones (rebuilding from the cache), the gain of the latter and
+/// the size of the entries. The rebuilt sequences are compared with
+/// the ClusterSequence ones (fcc::same_clustering: d_ij history,
+/// inclusive jets with their constituents, and exclusive jets for kt
+/// and C/A); the program exits with status 1 if any differ.
+//----------------------------------------------------------------------
+
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/ClusteringCache.hh"
+#include "fcc/JetComparison.hh"
+#include "fcc/Timer.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+bool benchmark(const string & label, const vector<fcc::Event> & input_events,
+               fcc::ClusteringCache & cache, double min_time){
+  vector<vector<PseudoJet> > events;
+  unsigned long n_particles = 0;
+  for (unsigned int iev = 0; iev < input_events.size(); iev++){
+    events.push_back(input_events[iev].pseudojets());
+    n_particles += events.back().size();
+  }
+  vector<JetDefinition> jet_defs;
+  const JetAlgorithm algorithms[] = {kt_algorithm, cambridge_algorithm, antikt_algorithm};
+  for (unsigned int ialg = 0; ialg < 3; ialg++){
+    jet_defs.push_back(JetDefinition(algorithms[ialg], 0.4));
+    jet_defs.push_back(JetDefinition(algorithms[ialg], 0.6));
+  }
+  unsigned long n_clusterings = events.size()*jet_defs.size();
+
+  // plain clustering
+  unsigned long n_runs = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      for (unsigned int idef = 0; idef < jet_defs.size(); idef++){
+        ClusterSequence clust_seq(events[iev], jet_defs[idef]);
+      }
+    }
+    n_runs += n_clusterings;
+  } while (timer.elapsed() < min_time);
+  double t_plain = timer.elapsed()/n_runs;
+
+  // first pass, storing the clusterings
+  cache.clear();
+  timer.start();
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    for (unsigned int idef = 0; idef < jet_defs.size(); idef++) cache.cluster(events[iev], jet_defs[idef]);
+  }
+  double t_store = timer.elapsed()/n_clusterings;
+  unsigned long size_bytes = cache.size_bytes();
+
+  // the rebuilt clusterings against the original ones
+  bool same = true;
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    for (unsigned int idef = 0; idef < jet_defs.size(); idef++){
+      ClusterSequence clust_seq(events[iev], jet_defs[idef]);
+      unique_ptr<ClusterSequence> cached = cache.cluster(events[iev], jet_defs[idef]);
+      if (!fcc::same_clustering(clust_seq, *cached, jet_defs[idef].jet_algorithm() != antikt_algorithm))
+        same = false;
+    }
+  }
+
+  // later passes
+  n_runs = 0;
+  timer.start();
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      for (unsigned int idef = 0; idef < jet_defs.size(); idef++) cache.cluster(events[iev], jet_defs[idef]);
+    }
+    n_runs += n_clusterings;
+  } while (timer.elapsed() < min_time);
+  double t_hit = timer.elapsed()/n_runs;
+
+  printf("%-40s %8lu %12.4f %12.4f %12.4f %7.2f %12.1f %10s\n", label.c_str(), n_particles/events.size(),
+         1000*t_plain, 1000*t_store, 1000*t_hit, t_plain/t_hit, double(size_bytes)/n_clusterings/1024,
+         same ? "identical" : "DIFFERENT");
+  fflush(stdout);
+  return same;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  fcc::BenchmarkInputs inputs;
+  double max_mb = 1024;
+  string directory = "clustering-cache";
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    if (inputs.parse_option(argc, argv, iarg)) continue;
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--max-mb") && has_value) max_mb    = atof(argv[++iarg]);
+    else if ((arg == "--cache")  && has_value) directory = argv[++iarg];
+    else args.push_back(arg);
+  }
+  if (args.empty()){
+    cerr << "usage: " << argv[0] << " [--cache DIR] [--max-mb M] " << fcc::BenchmarkInputs::usage() << endl
+         << "       file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+
+  fcc::ClusteringCache cache(directory, (unsigned long)(max_mb*1048576));
+  cache.clear();
+  cout << cache.description() << endl << endl;
+  printf("%-40s %8s %12s %12s %12s %7s %12s %10s\n", "input", "n", "plain [ms]", "store [ms]",
+         "rebuild [ms]", "gain", "entry [kB]", "jets");
+
+  bool all_same = inputs.run(args, [&](const string & label, const vector<fcc::Event> & events){
+    return benchmark(label, events, cache, inputs.min_time());
+  });
+
+  cout << endl << cache.description() << ", " << cache.n_evictions() << " evictions" << endl;
+  return all_same ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------
+/// \file
+/// cs_benchmark: compare fcc::ConstituentSubtraction with fjcontrib's
+/// ConstituentSubtractor, in time, memory and output, as the
+/// multiplicity grows
+///
+/// run it with    : ./cs_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --minbias FILE      pileup file used to build events at the mu
+///                       values below (overlaid on the events of the
+///                       first file); may be repeated
+///   --mu L              comma-separated list of mu (default 200,1000)
+///   --contrib-max N     skip the contrib above N particles
+///                       (default 30000)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// The settings are those of the event-wide example of the
+/// ConstituentSubtractor contrib: ghosts of area 0.01 up to |eta|=6,
+/// DeltaR_max = 0.3, alpha = 1, and rho (and rho_m) from a 0.5 x 0.5
+/// grid median. Every input is run with massless output and with
+/// rho_m subtraction. The subtracted particles must be identical; the
+/// program exits with status 1 if they differ.
+///
+/// NB: the code needs to be linked against the ConstituentSubtractor
+/// library from fjcontrib (-lConstituentSubtractor).
+//----------------------------------------------------------------------
+
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/ConstituentSubtraction.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
+#include "fastjet/contrib/ConstituentSubtractor.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+using namespace fastjet;
+
+const double max_eta = 6.0;
+
+//----------------------------------------------------------------------
+// time per event of the subtraction of the events, each with its own
+// background estimator
+template<class Subtractor>
+double time_subtraction(Subtractor & subtractor, const vector<vector<PseudoJet> > & events,
+                        const vector<unique_ptr<GridMedianBackgroundEstimator> > & bges,
+                        double min_time){
+  unsigned long n_runs = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      subtractor.set_background_estimator(bges[iev].get());
+      subtractor.subtract_event(events[iev]);
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  return timer.elapsed()/n_runs;
+}
+
+//----------------------------------------------------------------------
+// true if the two sets of subtracted particles are identical
+bool identical(const vector<PseudoJet> & a, const vector<PseudoJet> & b){
+  if (a.size() != b.size()) return false;
+  for (unsigned int i = 0; i < a.size(); i++){
+    if ((a[i].px() != b[i].px()) || (a[i].py() != b[i].py()) ||
+        (a[i].pz() != b[i].pz()) || (a[i].E()  != b[i].E())) return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool benchmark(const string & label, const vector<fcc::Event> & input_events,
+               unsigned int contrib_max, double min_time){
+  vector<vector<PseudoJet> > events;
+  vector<unique_ptr<GridMedianBackgroundEstimator> > bges;
+  unsigned long n_particles = 0;
+  for (unsigned int iev = 0; iev < input_events.size(); iev++){
+    events.push_back(input_events[iev].pseudojets());
+    bges.push_back(unique_ptr<GridMedianBackgroundEstimator>(new GridMedianBackgroundEstimator(max_eta, 0.5)));
+    bges.back()->set_particles(events.back());
+    n_particles += events.back().size();
+  }
+  unsigned long n_mean = n_particles/events.size();
+  bool run_contrib = (n_mean <= contrib_max), all_same = true;
+
+  for (unsigned int mass_subtraction = 0; mass_subtraction < 2; mass_subtraction++){
+    fcc::ConstituentSubtraction grid(max_eta, 0.01, 0.3, 1.0);
+    grid.set_do_mass_subtraction(mass_subtraction);
+    contrib::ConstituentSubtractor reference;
+    reference.set_distance_type(contrib::ConstituentSubtractor::deltaR);
+    reference.set_max_distance(0.3);
+    reference.set_alpha(1);
+    reference.set_ghost_area(0.01);
+    reference.set_max_eta(max_eta);
+    reference.set_background_estimator(bges[0].get());
+    reference.set_common_bge_for_rho_and_rhom();
+    if (mass_subtraction) reference.set_do_mass_subtraction();
+    reference.initialize();
+
+    bool same = true;
+    unsigned long n_pairs = 0, max_bytes = 0;
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      grid.set_background_estimator(bges[iev].get());
+      vector<PseudoJet> grid_result = grid.subtract_event(events[iev]);
+      n_pairs += grid.n_pairs();
+      max_bytes = max(max_bytes, grid.state_bytes());
+      if (!run_contrib) continue;
+      reference.set_background_estimator(bges[iev].get());
+      if (!identical(grid_result, reference.subtract_event(events[iev]))) same = false;
+    }
+
+    double t_grid = time_subtraction(grid, events, bges, min_time);
+    printf("%-45s %4s %8lu %10lu %10.2f %8.0f %12.4f", label.c_str(), mass_subtraction ? "m" : "-",
+           n_mean, n_pairs/events.size(), max_bytes/1048576.0,
+           n_mean ? double(max_bytes)/n_mean : 0.0, 1000*t_grid);
+    if (run_contrib){
+      double t_contrib = time_subtraction(reference, events, bges, min_time);
+      printf(" %12.4f %8.1f %10s\n", 1000*t_contrib, t_contrib/t_grid, same ? "identical" : "DIFFERENT");
+    } else {
+      printf(" %12s %8s %10s\n", "-", "-", "-");
+    }
+    fflush(stdout);
+    all_same &= same;
+  }
+  return all_same;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  fcc::BenchmarkInputs inputs;
+  unsigned int contrib_max = 30000;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    if (inputs.parse_option(argc, argv, iarg)) continue;
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if ((arg == "--contrib-max") && has_value) contrib_max = atoi(argv[++iarg]);
+    else args.push_back(arg);
+  }
+  if (args.empty()){
+    cerr << "usage: " << argv[0] << " [--contrib-max N] " << fcc::BenchmarkInputs::usage() << endl
+         << "       file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+
+  cout << fcc::ConstituentSubtraction(max_eta).description() << endl << endl;
+  printf("%-45s %4s %8s %10s %10s %8s %12s %12s %8s %10s\n", "input", "rhom", "n", "pairs",
+         "mem [MB]", "B/part.", "grid [ms]", "contrib [ms]", "gain", "output");
+
+  bool all_same = inputs.run(args, [&](const string & label, const vector<fcc::Event> & events){
+    return benchmark(label, events, contrib_max, inputs.min_time());
+  });
+
+  return all_same ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------
+/// \file
+/// dat2bin: convert a text .dat event file to the binary column-wise
+/// format of fcc/BinaryEventFile.hh
+///
+/// run it with    : ./dat2bin [--no-pdg-id] [--no-subevent] input.dat output.bin
+///
+/// "-" can be used for either file to read from the standard input or
+/// write to the standard output. By default the PDG id column is kept
+/// if the first event has PDG ids, and the sub-event column is always
+/// kept.
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/BinaryEventFile.hh"
+#include "fastjet/Error.hh"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char ** argv){
+  bool keep_pdg_id = true, keep_subevent = true;
+  vector<string> files;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    if      (arg == "--no-pdg-id")   keep_pdg_id   = false;
+    else if (arg == "--no-subevent") keep_subevent = false;
+    else files.push_back(arg);
+  }
+  if (files.size() != 2){
+    cerr << "usage: " << argv[0] << " [--no-pdg-id] [--no-subevent] input.dat output.bin" << endl;
+    return 1;
+  }
+
+  try {
+    fcc::EventReader reader(files[0]);
+    fcc::Event event;
+
+    // the columns to store are decided from the first event
+    if (!reader.next_event(event)){
+      cerr << "Error: no event found in " << files[0] << endl;
+      return 1;
+    }
+    fcc::BinaryEventWriter writer(files[1], keep_pdg_id && event.has_pdg_id(), keep_subevent);
+
+    unsigned long n_particles = 0;
+    do {
+      writer.write(event);
+      n_particles += event.size();
+    } while (reader.next_event(event));
+    writer.close();
+
+    cerr << "Converted " << writer.n_events() << " events ("
+         << n_particles << " particles) from " << files[0]
+         << " to " << files[1] << endl;
+  } catch (const fastjet::Error & error){
+    // the message has already been printed by fastjet::Error
+    return 1;
+  }
+
+  return 0;
+}
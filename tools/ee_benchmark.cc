@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------
+/// \file
+/// ee_benchmark: check fcc::EEKtEngine against ClusterSequence with
+/// ee_kt_algorithm, and time the full exclusive-jet scan of both
+///
+/// run it with    : ./ee_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --n-max N           largest exclusive-jet multiplicity (default 6)
+///   --ycut L            comma-separated list of ycut values
+///                       (default 0.001,0.005,0.01,0.05,0.1)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// For every event, both compute the exclusive jets for n = 2..N, the
+/// transition values y_{n,n+1} for n = 2..N and the number of jets at
+/// each ycut. The table gives the time per event of each (clustering
+/// and queries), the gain, the largest relative difference of the
+/// y_{n,n+1} and whether the jets and jet counts agree. The engine
+/// sums the jet momenta in its own order, so the jets only agree up to
+/// rounding: within 1e-10 of the jet energy on each component, and
+/// within 1e-6 relative on y_{n,n+1}; the column is labelled
+/// "agree (tol)" accordingly. The jet counts must be equal. The
+/// program exits with status 1 if anything disagrees.
+//----------------------------------------------------------------------
+
+#include "fcc/EEKtEngine.hh"
+#include "fcc/EventReader.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/ClusterSequence.hh"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// true if the two sets of jets have the same four-momenta up to
+// rounding (1e-10 of the energy), in any order
+bool same_jets(const vector<PseudoJet> & jets1, const vector<PseudoJet> & jets2){
+  if (jets1.size() != jets2.size()) return false;
+  vector<PseudoJet> a = sorted_by_E(jets1), b = sorted_by_E(jets2);
+  for (unsigned int i = 0; i < a.size(); i++){
+    double tolerance = 1e-10 * (a[i].E() + b[i].E());
+    if ((std::abs(a[i].px()-b[i].px()) > tolerance) || (std::abs(a[i].py()-b[i].py()) > tolerance) ||
+        (std::abs(a[i].pz()-b[i].pz()) > tolerance) || (std::abs(a[i].E() -b[i].E())  > tolerance)) return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------
+// the queries made on every event (the sum of the answers keeps them
+// from being optimised away)
+double scan_fastjet(const vector<PseudoJet> & particles, const JetDefinition & jet_def,
+                    int n_max, const vector<double> & ycuts){
+  ClusterSequence clust_seq(particles, jet_def);
+  double sum = 0.0;
+  int n_particles = particles.size();
+  for (int n = 2; n <= min(n_max, n_particles); n++){
+    sum += clust_seq.exclusive_jets(n).size();
+    if (n < n_particles) sum += clust_seq.exclusive_ymerge(n);
+  }
+  for (unsigned int i = 0; i < ycuts.size(); i++) sum += clust_seq.n_exclusive_jets_ycut(ycuts[i]);
+  return sum;
+}
+
+double scan_engine(const vector<PseudoJet> & particles, fcc::EEKtEngine & engine,
+                   int n_max, const vector<double> & ycuts){
+  engine.cluster(particles);
+  double sum = 0.0;
+  int n_particles = particles.size();
+  for (int n = 2; n <= min(n_max, n_particles); n++){
+    sum += engine.exclusive_jets(n).size();
+    if (n < n_particles) sum += engine.exclusive_ymerge(n);
+  }
+  for (unsigned int i = 0; i < ycuts.size(); i++) sum += engine.n_exclusive_jets_ycut(ycuts[i]);
+  return sum;
+}
+
+//----------------------------------------------------------------------
+bool benchmark(const string & label, const vector<fcc::Event> & input_events,
+               int n_max, const vector<double> & ycuts, double min_time){
+  vector<vector<PseudoJet> > events;
+  unsigned long n_particles = 0;
+  for (unsigned int iev = 0; iev < input_events.size(); iev++){
+    events.push_back(input_events[iev].pseudojets());
+    n_particles += events.back().size();
+  }
+
+  // the comparison
+  JetDefinition jet_def(ee_kt_algorithm);
+  fcc::EEKtEngine engine(n_max);
+  bool same = true;
+  double max_dy = 0.0;
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    ClusterSequence clust_seq(events[iev], jet_def);
+    engine.cluster(events[iev]);
+    int n_event = events[iev].size();
+    for (int n = 2; n <= min(n_max, n_event); n++){
+      if (!same_jets(clust_seq.exclusive_jets(n), engine.exclusive_jets(n))) same = false;
+      if (n == n_event) continue;
+      double y_fj = clust_seq.exclusive_ymerge(n), y = engine.exclusive_ymerge(n);
+      if (y_fj > 0) max_dy = max(max_dy, std::abs(y - y_fj)/y_fj);
+    }
+    for (unsigned int i = 0; i < ycuts.size(); i++){
+      if (clust_seq.n_exclusive_jets_ycut(ycuts[i]) != engine.n_exclusive_jets_ycut(ycuts[i])) same = false;
+    }
+  }
+  const double y_tolerance = 1e-6;
+  if (max_dy > y_tolerance) same = false;
+
+  // the timings
+  double sum = 0.0;
+  unsigned long n_runs = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      sum += scan_fastjet(events[iev], jet_def, n_max, ycuts);
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  double t_fastjet = timer.elapsed()/n_runs;
+  n_runs = 0;
+  timer.start();
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      sum += scan_engine(events[iev], engine, n_max, ycuts);
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  double t_engine = timer.elapsed()/n_runs;
+
+  printf("%-40s %7lu %7lu %12.2f %12.2f %7.2f %10.2e %12s\n", label.c_str(), events.size(),
+         n_particles/events.size(), 1e6*t_fastjet, 1e6*t_engine, t_fastjet/t_engine, max_dy,
+         same ? "yes" : "NO");
+  if (sum < 0) cout << sum << endl;
+  fflush(stdout);
+  return same;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  double min_time = 0.2;
+  int n_max = 6;
+  vector<double> ycuts;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--min-time") && has_value) min_time = atof(argv[++iarg]);
+    else if ((arg == "--n-max")    && has_value) n_max    = atoi(argv[++iarg]);
+    else if ((arg == "--ycut") && has_value){
+      istringstream iss(argv[++iarg]);
+      string item;
+      while (getline(iss, item, ',')) ycuts.push_back(atof(item.c_str()));
+    }
+    else args.push_back(arg);
+  }
+  if (args.empty() || (n_max < 2)){
+    cerr << "usage: " << argv[0] << " [--n-max N] [--ycut y1,y2,...] [--min-time T] file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+  if (ycuts.empty()){
+    ycuts.push_back(0.001);
+    ycuts.push_back(0.005);
+    ycuts.push_back(0.01);
+    ycuts.push_back(0.05);
+    ycuts.push_back(0.1);
+  }
+
+  cout << fcc::EEKtEngine(n_max).description() << endl;
+  cout << "Queries per event: exclusive jets and y_{n,n+1} for n = 2.." << n_max
+       << ", number of jets at " << ycuts.size() << " ycut values" << endl << endl;
+  printf("%-40s %7s %7s %12s %12s %7s %10s %12s\n", "input", "events", "n",
+         "FastJet [us]", "engine [us]", "gain", "max dy/y", "agree (tol)");
+
+  bool all_same = true;
+  fcc::Event event;
+  for (unsigned int ifile = 0; ifile < args.size(); ifile++){
+    vector<fcc::Event> events;
+    fcc::EventReader reader(args[ifile]);
+    while (reader.next_event(event)) events.push_back(event);
+    if (events.empty()) continue;
+    all_same &= benchmark(args[ifile], events, n_max, ycuts, min_time);
+  }
+
+  return all_same ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------
+/// \file
+/// jetdef_scan: cluster every event of a file for a grid of jet
+/// algorithms, radii, recombination schemes and ptmin values, and
+/// write one table of jets keyed by configuration
+///
+/// run it with    : ./jetdef_scan [options] input
+///
+/// options:
+///   --algorithms L      comma-separated algorithms among kt, cam, antikt
+///                       (default kt,cam,antikt)
+///   --R L               comma-separated radii (default 0.2,0.4,0.6,0.8,1.0,1.2)
+///   --schemes L         comma-separated recombination schemes among E, pt,
+///                       pt2, Et, Et2, WTA_pt (default E)
+///   --ptmin L           comma-separated ptmin values (default 5,20)
+///   --threads N         number of worker threads (default: all hardware threads)
+///   --batch N           events read and processed together (default 64)
+///   --output FILE       the table of jets (default jetdef-scan.txt)
+///   --check             also run every configuration on its own on each
+///                       batch, and compare the jets
+///
+/// The input is read once and each event is prepared once for all the
+/// configurations (fcc::JetDefinitionScan). The jets of each batch are
+/// written out, by configuration, as soon as it is processed, so that
+/// the memory does not grow with the input. The summary gives the
+/// number of jets per event of each configuration, and with --check
+/// the time of the separate runs. The program exits with status 1 if
+/// --check finds a difference.
+///
+/// NB: FastJet must have been configured with --enable-thread-safety
+/// (available from FastJet 3.4) for more than one thread.
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/JetDefinitionScan.hh"
+#include "fcc/ThreadPool.hh"
+#include "fcc/Timer.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// comma-separated lists
+vector<string> parse_names(const string & list){
+  vector<string> names;
+  istringstream iss(list);
+  string item;
+  while (getline(iss, item, ',')) names.push_back(item);
+  return names;
+}
+
+vector<double> parse_values(const string & list){
+  vector<string> names = parse_names(list);
+  vector<double> values;
+  for (unsigned int i = 0; i < names.size(); i++) values.push_back(atof(names[i].c_str()));
+  return values;
+}
+
+//----------------------------------------------------------------------
+// the algorithm and scheme names of the command line
+bool algorithm_from_name(const string & name, JetAlgorithm & algorithm){
+  if      (name == "kt")     algorithm = kt_algorithm;
+  else if (name == "cam")    algorithm = cambridge_algorithm;
+  else if (name == "antikt") algorithm = antikt_algorithm;
+  else return false;
+  return true;
+}
+
+bool scheme_from_name(const string & name, RecombinationScheme & scheme){
+  if      (name == "E")      scheme = E_scheme;
+  else if (name == "pt")     scheme = pt_scheme;
+  else if (name == "pt2")    scheme = pt2_scheme;
+  else if (name == "Et")     scheme = Et_scheme;
+  else if (name == "Et2")    scheme = Et2_scheme;
+  else if (name == "WTA_pt") scheme = WTA_pt_scheme;
+  else return false;
+  return true;
+}
+
+//----------------------------------------------------------------------
+// the jets of one configuration run on its own over the current batch
+// (whose first event is "first_event"), as the scan lists them; the
+// number of rows that differ is returned
+unsigned long check_configuration(const fcc::JetDefinitionScan & scan, unsigned int iconfig,
+                                  const vector<fcc::Event> & batch, unsigned long first_event){
+  const vector<fcc::JetDefinitionScan::Row> & rows = scan.jets(iconfig);
+  unsigned long irow = 0, n_differences = 0;
+  for (unsigned int ibatch = 0; ibatch < batch.size(); ibatch++){
+    unsigned long iev = first_event + ibatch;
+    ClusterSequence cs(batch[ibatch].pseudojets(), scan.jet_def(iconfig));
+    vector<PseudoJet> jets = sorted_by_pt(cs.inclusive_jets(scan.ptmin(iconfig)));
+    for (unsigned int ijet = 0; ijet < jets.size(); ijet++, irow++){
+      if ((irow >= rows.size()) || (rows[irow].event != iev) || (rows[irow].jet != ijet) ||
+          (rows[irow].pt != jets[ijet].perp()) || (rows[irow].rap != jets[ijet].rap()) ||
+          (rows[irow].phi != jets[ijet].phi()) || (rows[irow].m != jets[ijet].m())) n_differences++;
+    }
+  }
+  if (irow < rows.size()) n_differences += rows.size() - irow;
+  return n_differences;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  unsigned int n_threads = fcc::ThreadPool::hardware_threads(), batch_size = 64;
+  bool check = false;
+  string output_file = "jetdef-scan.txt";
+  vector<string> algorithm_names = parse_names("kt,cam,antikt"), scheme_names = parse_names("E");
+  vector<double> radii = parse_values("0.2,0.4,0.6,0.8,1.0,1.2"), ptmins = parse_values("5,20");
+
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--algorithms") && has_value) algorithm_names = parse_names(argv[++iarg]);
+    else if ((arg == "--R")          && has_value) radii = parse_values(argv[++iarg]);
+    else if ((arg == "--schemes")    && has_value) scheme_names = parse_names(argv[++iarg]);
+    else if ((arg == "--ptmin")      && has_value) ptmins = parse_values(argv[++iarg]);
+    else if ((arg == "--threads")    && has_value) n_threads = atoi(argv[++iarg]);
+    else if ((arg == "--batch")      && has_value) batch_size = atoi(argv[++iarg]);
+    else if ((arg == "--output")     && has_value) output_file = argv[++iarg];
+    else if (arg == "--check") check = true;
+    else args.push_back(arg);
+  }
+
+  // the grid of jet definitions, with the names used in the summary
+  vector<JetDefinition> jet_defs;
+  vector<string> labels;
+  bool valid = true;
+  for (unsigned int ialg = 0; ialg < algorithm_names.size(); ialg++){
+    JetAlgorithm algorithm;
+    valid &= algorithm_from_name(algorithm_names[ialg], algorithm);
+    for (unsigned int iR = 0; valid && (iR < radii.size()); iR++){
+      for (unsigned int isch = 0; isch < scheme_names.size(); isch++){
+        RecombinationScheme scheme;
+        valid &= scheme_from_name(scheme_names[isch], scheme);
+        if (!valid) break;
+        jet_defs.push_back(JetDefinition(algorithm, radii[iR], scheme));
+        char label[64];
+        snprintf(label, sizeof(label), "%-7s %5.2f %-7s", algorithm_names[ialg].c_str(), radii[iR],
+                 scheme_names[isch].c_str());
+        labels.push_back(label);
+      }
+    }
+  }
+  if ((args.size() != 1) || !valid || jet_defs.empty() || ptmins.empty() || (n_threads == 0) ||
+      (batch_size == 0)){
+    cerr << "usage: " << argv[0] << " [--algorithms kt,cam,antikt] [--R r1,r2,...] [--schemes E,pt,...]" << endl
+         << "       [--ptmin pt1,pt2,...] [--threads N] [--batch N] [--output FILE] [--check] input" << endl;
+    return 1;
+  }
+
+  fcc::JetDefinitionScan scan(jet_defs, ptmins);
+  cout << "Ran: " << scan.description() << endl;
+
+  ofstream out(output_file.c_str());
+  scan.write_legend(out);
+
+  // each batch is processed, checked if asked for, written out and
+  // dropped from the scan
+  fcc::ThreadPool pool(n_threads);
+  fcc::EventReader reader(args[0]);
+  fcc::Timer timer;
+  double time = 0.0, time_separate = 0.0;
+  unsigned long n_differences = 0;
+  vector<unsigned long> n_jets(scan.n_configurations(), 0);
+  vector<fcc::Event> batch(batch_size);
+  while (true){
+    unsigned int n = 0;
+    while ((n < batch_size) && reader.next_event(batch[n])) n++;
+    if (n == 0) break;
+    batch.resize(n);
+    unsigned long first_event = scan.n_events();
+    timer.start();
+    scan.process(batch, pool);
+    time += timer.elapsed();
+
+    for (unsigned int iconfig = 0; iconfig < scan.n_configurations(); iconfig++){
+      n_jets[iconfig] += scan.jets(iconfig).size();
+      if (check){
+        timer.start();
+        n_differences += check_configuration(scan, iconfig, batch, first_event);
+        time_separate += timer.elapsed();
+      }
+    }
+    scan.write_rows(out);
+    scan.clear();
+    if (n < batch_size) break;
+  }
+
+  unsigned long n_events = scan.n_events();
+  cout << "Clustered " << n_events << " events for " << scan.n_configurations() << " configurations on "
+       << pool.n_threads() << " threads in " << time << " s" << endl;
+  cout << "Jets written to " << output_file << endl << endl;
+
+  printf("%7s %-7s %5s %-7s %8s %12s\n", "config", "alg", "R", "scheme", "ptmin", "jets/event");
+  for (unsigned int idef = 0; idef < jet_defs.size(); idef++){
+    for (unsigned int iptmin = 0; iptmin < ptmins.size(); iptmin++){
+      unsigned int iconfig = scan.configuration(idef, iptmin);
+      printf("%7u %s %8.1f %12.3f\n", iconfig, labels[idef].c_str(), ptmins[iptmin],
+             n_events ? double(n_jets[iconfig])/n_events : 0.0);
+    }
+  }
+  if (check){
+    cout << endl << "Separate runs (one thread, per batch and configuration): " << time_separate << " s" << endl;
+    cout << "Differences with the separate runs: " << n_differences << endl;
+  }
+
+  return (n_differences == 0) ? 0 : 1;
+}
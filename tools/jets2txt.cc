@@ -0,0 +1,79 @@
+//----------------------------------------------------------------------
+/// \file
+/// jets2txt: print the jets of a binary jet file (fcc/BinaryJetFile.hh,
+/// written by the exercises' --jets option) as a text table
+///
+/// run it with    : ./jets2txt [--summary] jets.bin
+///
+/// "-" reads the standard input. With --summary, only the number of
+/// jets and events and the mean pt (and subtracted pt) are printed,
+/// computed block by block on the columns.
+//----------------------------------------------------------------------
+
+#include "fcc/BinaryJetFile.hh"
+#include "fastjet/Error.hh"
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char ** argv){
+  bool summary = false;
+  vector<string> files;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    if (arg == "--summary") summary = true;
+    else files.push_back(arg);
+  }
+  if (files.size() != 1){
+    cerr << "usage: " << argv[0] << " [--summary] jets.bin" << endl;
+    return 1;
+  }
+
+  try {
+    fcc::BinaryJetReader reader(files[0]);
+    fcc::JetColumns block;
+
+    if (summary){
+      unsigned long n_events = 0, last_event = 0;
+      double sum_pt = 0.0, sum_pt_sub = 0.0;
+      while (reader.next_block(block)){
+        for (unsigned int i = 0; i < block.size(); i++){
+          if ((n_events == 0) || (block.event[i] != last_event)) n_events++;
+          last_event = block.event[i];
+          sum_pt += block.pt[i];
+          sum_pt_sub += block.pt_sub[i];
+        }
+      }
+      unsigned long n_jets = reader.n_jets_read();
+      cout << files[0] << ": " << n_jets << " jets in " << n_events << " events"
+           << (reader.compressed() ? " (compressed)" : "") << endl;
+      if (n_jets){
+        cout << "  mean pt     = " << sum_pt/n_jets << endl;
+        if (reader.has_subtracted()) cout << "  mean pt_sub = " << sum_pt_sub/n_jets << endl;
+      }
+      return 0;
+    }
+
+    // the same columns as the exercises' tables, plus the ones of the file
+    printf("%8s %5s %15s %15s %15s %15s", "event", "jet #", "rapidity", "phi", "pt", "m");
+    if (reader.has_area())       printf(" %15s", "area");
+    if (reader.has_subtracted()) printf(" %15s", "pt_sub");
+    printf(" %8s\n", "n const");
+    while (reader.next_block(block)){
+      for (unsigned int i = 0; i < block.size(); i++){
+        printf("%8lu %5u %15.8f %15.8f %15.8f %15.8f", (unsigned long)block.event[i], block.jet[i],
+               block.rap[i], block.phi[i], block.pt[i], block.m[i]);
+        if (reader.has_area())       printf(" %15.8f", block.area[i]);
+        if (reader.has_subtracted()) printf(" %15.8f", block.pt_sub[i]);
+        printf(" %8u\n", block.n_constituents[i]);
+      }
+    }
+  } catch (const fastjet::Error & error){
+    // the message has already been printed by fastjet::Error
+    return 1;
+  }
+
+  return 0;
+}
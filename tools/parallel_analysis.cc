@@ -0,0 +1,219 @@
+//----------------------------------------------------------------------
+/// \file
+/// parallel_analysis: run one of the exercise analyses (basic01,
+/// jetArea06 or subtraction07) over all the events of a file, with
+/// the events spread over a work-stealing thread pool
+///
+/// run it with    : ./parallel_analysis [options] basic|area|subtraction input
+///
+/// area-cached and subtraction-cached run the same analyses with
+/// ghosts taken from a lattice built once and shared by the workers
+/// (fcc::GhostLattice), as is the small pool running the area
+/// repetitions. The ghosts of an event are seeded from its number, so
+/// the results do not depend on the number of threads or on which
+/// worker ran the event. subtraction-shared is fcc::SubtractionStage,
+/// with its clusterings run one after the other since the events
+/// already keep all the threads busy. subtraction-grid estimates rho
+/// on a rapidity-phi grid (fcc::GridRhoEstimator) instead of from kt
+/// jets.
+///
+/// options:
+///   --threads N   number of worker threads (default: all hardware threads)
+///   --soft-killer filter the particles of the area and subtraction
+///                 analyses with a SoftKiller (fcc::SoftKiller) before
+///                 clustering
+///   --scaling     instead of printing the results, time the whole
+///                 input with 1, 2, 4, ... N threads and report the
+///                 speed-up
+///
+/// Every worker owns its own copy of the analysis (and hence its own
+/// jet definitions, cluster sequences and background estimators), so
+/// that workers never share clustering state. The per-event results
+/// are written out in input order, whatever the order in which the
+/// events complete.
+///
+/// NB: FastJet must have been configured with --enable-thread-safety
+/// (available from FastJet 3.4) for the clustering to be run from
+/// several threads.
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/ExerciseAnalyses.hh"
+#include "fcc/SubtractionStage.hh"
+#include "fcc/ThreadPool.hh"
+#include "fcc/Timer.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+//----------------------------------------------------------------------
+// the analysis corresponding to a name on the command line
+fcc::EventAnalysis * make_analysis(const string & name){
+  if (name == "basic")       return new fcc::BasicAnalysis();
+  if (name == "area")        return new fcc::AreaAnalysis();
+  if (name == "subtraction") return new fcc::SubtractionAnalysis();
+  if (name == "area-cached")        return new fcc::AreaAnalysis(true);
+  if (name == "subtraction-cached") return new fcc::SubtractionAnalysis(true);
+  if (name == "subtraction-shared") return new fcc::SubtractionStage(1);
+  if (name == "subtraction-grid")   return new fcc::SubtractionAnalysis(false, true);
+  return 0;
+}
+
+//----------------------------------------------------------------------
+// add a SoftKiller pre-filter to the area and subtraction analyses
+// (false for the others)
+bool set_soft_killer(fcc::EventAnalysis * analysis){
+  fcc::SoftKiller soft_killer;
+  if (fcc::AreaAnalysis * area = dynamic_cast<fcc::AreaAnalysis*>(analysis)){
+    area->set_soft_killer(soft_killer);
+    return true;
+  }
+  if (fcc::SubtractionAnalysis * subtraction = dynamic_cast<fcc::SubtractionAnalysis*>(analysis)){
+    subtraction->set_soft_killer(soft_killer);
+    return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------
+// one (owned) analysis per worker
+class WorkerAnalyses {
+public:
+  WorkerAnalyses(const fcc::EventAnalysis & prototype, unsigned int n){
+    for (unsigned int i = 0; i < n; i++) _analyses.push_back(prototype.clone());
+  }
+  ~WorkerAnalyses(){
+    for (unsigned int i = 0; i < _analyses.size(); i++) delete _analyses[i];
+  }
+  fcc::EventAnalysis & operator[](unsigned int i){ return *_analyses[i];}
+private:
+  vector<fcc::EventAnalysis*> _analyses;
+};
+
+//----------------------------------------------------------------------
+// process one event with the worker's analysis and return its printout
+string run_event(fcc::EventAnalysis & analysis, const fcc::Event & event,
+                 unsigned long iev){
+  ostringstream oss;
+  analysis.process(event, iev);
+  oss << "Event " << iev << " (" << event.size() << " particles)" << endl;
+  analysis.print(oss);
+  oss << endl;
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+// stream the input through the pool, writing results in input order
+void run_streaming(const fcc::EventAnalysis & prototype, fcc::EventReader & reader,
+                   unsigned int n_threads){
+  fcc::ThreadPool pool(n_threads);
+  WorkerAnalyses analyses(prototype, pool.n_threads());
+  fcc::OrderedOutput output(cout);
+
+  // bound the number of events held in memory at any one time
+  unsigned long max_in_flight = 4*pool.n_threads();
+
+  fcc::Timer timer;
+  unsigned long iev = 0, n_particles = 0;
+  while (true){
+    output.wait_for_room(iev, max_in_flight);
+    shared_ptr<fcc::Event> event(new fcc::Event());
+    if (!reader.next_event(*event)) break;
+    n_particles += event->size();
+    pool.submit([&analyses, &output, event, iev](unsigned int iworker){
+        output.set(iev, run_event(analyses[iworker], *event, iev));
+      });
+    iev++;
+  }
+  pool.wait();
+  double time = timer.elapsed();
+
+  cerr << "Processed " << iev << " events (" << n_particles << " particles) on "
+       << pool.n_threads() << " threads in " << time << " s: "
+       << iev/time << " events/s, " << n_particles/time << " particles/s" << endl;
+}
+
+//----------------------------------------------------------------------
+// time the (pre-loaded) events with an increasing number of threads
+void run_scaling(const fcc::EventAnalysis & prototype, fcc::EventReader & reader,
+                 unsigned int max_threads){
+  vector<fcc::Event> events;
+  unsigned long n_particles = 0;
+  fcc::Event event;
+  while (reader.next_event(event)){
+    events.push_back(event);
+    n_particles += event.size();
+  }
+  if (events.empty()){
+    cerr << "Error: no events read" << endl;
+    exit(1);
+  }
+
+  vector<unsigned int> thread_counts;
+  for (unsigned int n = 1; n < max_threads; n *= 2) thread_counts.push_back(n);
+  thread_counts.push_back(max_threads);
+
+  cout << "Scaling of " << prototype.description() << endl;
+  cout << "over " << events.size() << " events (" << n_particles << " particles)" << endl;
+  printf("%8s %12s %12s %15s %10s %10s\n", "threads", "time [s]", "events/s",
+         "particles/s", "speed-up", "efficiency");
+
+  double reference_time = 0;
+  for (unsigned int i = 0; i < thread_counts.size(); i++){
+    unsigned int n_threads = thread_counts[i];
+    ostringstream discarded;
+    fcc::OrderedOutput output(discarded);
+
+    fcc::ThreadPool pool(n_threads);
+    WorkerAnalyses analyses(prototype, n_threads);
+    fcc::Timer timer;
+    for (unsigned long iev = 0; iev < events.size(); iev++){
+      const fcc::Event * event = &events[iev];
+      pool.submit([&analyses, &output, event, iev](unsigned int iworker){
+          output.set(iev, run_event(analyses[iworker], *event, iev));
+        });
+    }
+    pool.wait();
+    double time = timer.elapsed();
+    if (i == 0) reference_time = time;
+
+    printf("%8u %12.4f %12.2f %15.1f %10.2f %10.2f\n", n_threads, time,
+           events.size()/time, n_particles/time,
+           reference_time/time, reference_time/time/n_threads);
+  }
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  unsigned int n_threads = fcc::ThreadPool::hardware_threads();
+  bool scaling = false, soft_killer = false;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    if      ((arg == "--threads") && (iarg+1 < argc)) n_threads = atoi(argv[++iarg]);
+    else if (arg == "--scaling") scaling = true;
+    else if (arg == "--soft-killer") soft_killer = true;
+    else args.push_back(arg);
+  }
+
+  fcc::EventAnalysis * prototype = (args.size() == 2) ? make_analysis(args[0]) : 0;
+  if (prototype && soft_killer && !set_soft_killer(prototype)){
+    delete prototype;
+    prototype = 0;
+  }
+  if ((!prototype) || (n_threads == 0)){
+    cerr << "usage: " << argv[0] << " [--threads N] [--scaling] [--soft-killer]" << endl
+         << "       basic|area[-cached]|subtraction[-cached|-shared|-grid] input" << endl;
+    return 1;
+  }
+
+  fcc::EventReader reader(args[1]);
+  if (scaling) run_scaling(*prototype, reader, n_threads);
+  else         run_streaming(*prototype, reader, n_threads);
+
+  delete prototype;
+  return 0;
+}
@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------
+/// \file
+/// pileup_mixer: build high-pileup events by overlaying resampled
+/// minimum-bias sub-events on hard events
+///
+/// run it with    : ./pileup_mixer [options] --minbias pileup.dat hard.dat output
+///
+/// options:
+///   --mu MU          number of pileup sub-events per event (default 200)
+///   --poisson        draw the number of pileup sub-events from a
+///                    Poisson distribution of mean MU
+///   --minbias FILE   file whose sub-events 1, 2, ... are used as the
+///                    minimum-bias pool (can be given several times)
+///   --nev N          number of events to produce, cycling through the
+///                    hard events (default: one per hard event)
+///   --seed S         random seed (default 1)
+///   --binary         write the binary format instead of .dat text
+///
+/// The hard event is sub-event 0 of each event of the hard input (the
+/// whole event for files without "#SUBSTART" markers). The output has
+/// the same "#SUBSTART"/"#END" structure as the files in data/, with
+/// the hard sub-event first.
+///
+/// e.g. for FCC-hh conditions (all on one line):
+///   ./pileup_mixer --mu 1000 --poisson --binary
+///      --minbias data/Pythia-Zp2jets-lhc-pileup-1ev.dat
+///      --minbias data/Pythia-Z2jets-lhc-pileup-1ev.dat
+///      data/Pythia-PtMin1000-LHC-10ev.dat mu1000.bin
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/EventWriter.hh"
+#include "fcc/PileupMixer.hh"
+#include "fastjet/Error.hh"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+int main(int argc, char ** argv){
+  double mu = 200;
+  bool poisson = false, binary = false;
+  unsigned long nev = 0, seed = 1;
+  vector<string> minbias_files, args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--mu")      && has_value) mu   = atof(argv[++iarg]);
+    else if ((arg == "--nev")     && has_value) nev  = strtoul(argv[++iarg], 0, 10);
+    else if ((arg == "--seed")    && has_value) seed = strtoul(argv[++iarg], 0, 10);
+    else if ((arg == "--minbias") && has_value) minbias_files.push_back(argv[++iarg]);
+    else if (arg == "--poisson") poisson = true;
+    else if (arg == "--binary")  binary  = true;
+    else args.push_back(arg);
+  }
+  if ((args.size() != 2) || minbias_files.empty() || (mu < 0)){
+    cerr << "usage: " << argv[0] << " [--mu MU] [--poisson] [--nev N] [--seed S] [--binary]" << endl
+         << "       --minbias pileup.dat [--minbias ...] hard.dat output" << endl;
+    return 1;
+  }
+
+  try {
+    // fill the minimum-bias pool
+    fcc::PileupMixer mixer(seed);
+    fcc::Event event;
+    for (unsigned int ifile = 0; ifile < minbias_files.size(); ifile++){
+      fcc::EventReader reader(minbias_files[ifile]);
+      while (reader.next_event(event)) mixer.add_to_pool(event);
+    }
+    if (mixer.pool_size() == 0){
+      cerr << "Error: no minimum-bias sub-events found" << endl;
+      return 1;
+    }
+    cerr << "Minimum-bias pool: " << mixer.pool_size() << " sub-events" << endl;
+
+    // the hard events are kept in memory so that they can be cycled over
+    vector<fcc::Event> hard_events;
+    fcc::EventReader hard_reader(args[0]);
+    while (hard_reader.next_event(event)) hard_events.push_back(event);
+    if (hard_events.empty()){
+      cerr << "Error: no hard events found in " << args[0] << endl;
+      return 1;
+    }
+    if (nev == 0) nev = hard_events.size();
+
+    // the PDG-id column is only written if all the inputs have one
+    bool with_pdg_id = mixer.pool_has_pdg_id();
+    for (unsigned int i = 0; i < hard_events.size(); i++)
+      with_pdg_id = with_pdg_id && (hard_events[i].empty() || hard_events[i].has_pdg_id());
+
+    unique_ptr<fcc::EventWriter> writer(fcc::make_event_writer(args[1], binary, with_pdg_id));
+    fcc::Event mixed;
+    unsigned long n_particles = 0;
+    for (unsigned long iev = 0; iev < nev; iev++){
+      mixer.mix(hard_events[iev % hard_events.size()], 0, mixer.n_pileup(mu, poisson), mixed);
+      writer->write(mixed);
+      n_particles += mixed.size();
+    }
+    writer->close();
+
+    cerr << "Wrote " << nev << " events with mu=" << mu
+         << (poisson ? " (Poisson)" : "") << " to " << args[1]
+         << ", " << double(n_particles)/nev << " particles per event on average" << endl;
+  } catch (const fastjet::Error & error){
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------
+/// \file
+/// puppi_benchmark: time the tiled PUPPI weights against the direct
+/// O(N^2) computation, on the pileup files and on mixed high-pileup
+/// events
+///
+/// run it with    : ./puppi_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --R0 R              cone used for alpha (default 0.3)
+///   --minbias FILE      pileup file used to build events at the mu
+///                       values below (overlaid on the events of the
+///                       first file); may be repeated
+///   --mu L              comma-separated list of mu (default 200,1000)
+///   --naive-max N       skip the direct computation above N particles
+///                       (default 50000)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// For every input the table gives the time per event of both
+/// computations, the largest difference between their weights, and
+/// the fraction of the neutral pt of the hard event (LV) and of the
+/// pileup (PU) kept by the weights.
+//----------------------------------------------------------------------
+
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/Puppi.hh"
+#include "fcc/Timer.hh"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+//----------------------------------------------------------------------
+// time per event of the weights of "events"
+double time_weights(fcc::PuppiWeighter & puppi, const vector<fcc::Event> & events, double min_time){
+  unsigned long n_runs = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      puppi.process(events[iev]);
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  return timer.elapsed()/n_runs;
+}
+
+//----------------------------------------------------------------------
+// compare, time and summarise the weights of a set of events
+void benchmark(const string & label, const vector<fcc::Event> & events,
+               const fcc::PuppiWeighter::Parameters & parameters,
+               unsigned int naive_max, double min_time){
+  fcc::PuppiWeighter tiled(parameters), naive(parameters);
+  naive.set_naive(true);
+
+  unsigned long n_particles = 0;
+  double max_difference = 0.0;
+  double pt_lv = 0, pt_lv_kept = 0, pt_pu = 0, pt_pu_kept = 0;
+  bool run_naive = true;
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    const fcc::Event & event = events[iev];
+    n_particles += event.size();
+    if (event.size() > naive_max) run_naive = false;
+    tiled.process(event);
+    if (run_naive){
+      naive.process(event);
+      for (unsigned int i = 0; i < event.size(); i++)
+        max_difference = max(max_difference, std::abs(tiled.weights()[i] - naive.weights()[i]));
+    }
+    for (unsigned int i = 0; i < event.size(); i++){
+      if (tiled.categories()[i] != fcc::PuppiWeighter::neutral) continue;
+      double pt = sqrt(event.px()[i]*event.px()[i] + event.py()[i]*event.py()[i]);
+      if (event.subevent(i) == 0){ pt_lv += pt; pt_lv_kept += tiled.weights()[i]*pt; }
+      else                       { pt_pu += pt; pt_pu_kept += tiled.weights()[i]*pt; }
+    }
+  }
+
+  double t_tiled = time_weights(tiled, events, min_time);
+  printf("%-45s %8lu %12.4f", label.c_str(), n_particles/events.size(), 1000*t_tiled);
+  if (run_naive){
+    double t_naive = time_weights(naive, events, min_time);
+    printf(" %12.4f %8.1f %10.2g", 1000*t_naive, t_naive/t_tiled, max_difference);
+  } else {
+    printf(" %12s %8s %10s", "-", "-", "-");
+  }
+  printf(" %8.3f %8.3f\n", pt_lv > 0 ? pt_lv_kept/pt_lv : 0.0, pt_pu > 0 ? pt_pu_kept/pt_pu : 0.0);
+  fflush(stdout);
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  fcc::PuppiWeighter::Parameters parameters;
+  fcc::BenchmarkInputs inputs;
+  unsigned int naive_max = 50000;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    if (inputs.parse_option(argc, argv, iarg)) continue;
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--R0")        && has_value) parameters.R0 = atof(argv[++iarg]);
+    else if ((arg == "--naive-max") && has_value) naive_max = atoi(argv[++iarg]);
+    else args.push_back(arg);
+  }
+  if (args.empty()){
+    cerr << "usage: " << argv[0] << " [--R0 R] [--naive-max N] " << fcc::BenchmarkInputs::usage() << endl
+         << "       file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+
+  cout << fcc::PuppiWeighter(parameters).description() << endl << endl;
+  printf("%-45s %8s %12s %12s %8s %10s %8s %8s\n", "input", "n", "tiled [ms]", "direct [ms]",
+         "gain", "max |dw|", "LV kept", "PU kept");
+
+  inputs.run(args, [&](const string & label, const vector<fcc::Event> & events){
+    benchmark(label, events, parameters, naive_max, inputs.min_time());
+    return true;
+  });
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------
+/// \file
+/// rho_benchmark: compare fcc::GridRhoEstimator with the jet-median
+/// and grid-median estimators of FastJet, in time and in the bias of
+/// rho with respect to the true pileup density, as the pileup grows
+///
+/// run it with    : ./rho_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --minbias FILE      pileup file used to build events at the mu
+///                       values below (overlaid on the events of the
+///                       first file); may be repeated
+///   --mu L              comma-separated list of mu (default 200,1000)
+///   --band W            also measure the rho(y) profile over rapidity
+///                       bands of width W (default: no profile)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// The jet median is that of subtraction07 (kt R=0.4 jets with
+/// explicit ghosts up to |y|=6, the jets with |y|<4.5 except the two
+/// hardest); both grids are 0.55 x 0.55 up to |y|=5. The particles
+/// are kept up to |y|=5, and the true pileup density is the scalar pt
+/// of the particles not from the hard sub-event, over the area of
+/// that region. For every estimator the mean and the rms of
+/// rho - rho_true are given, in GeV per unit area. The program exits
+/// with status 1 if the two grid estimates of rho differ.
+//----------------------------------------------------------------------
+
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/GridRho.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/Selector.hh"
+#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
+#include "fastjet/tools/JetMedianBackgroundEstimator.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace fastjet;
+
+const double particle_maxrap = 5.0;
+
+//----------------------------------------------------------------------
+// time per event of the estimation of rho (and sigma), which are put
+// in "rhos"
+double time_rho(BackgroundEstimatorBase & estimator, const vector<vector<PseudoJet> > & events,
+                vector<double> & rhos, double min_time){
+  unsigned long n_runs = 0;
+  rhos.resize(events.size());
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      estimator.set_particles(events[iev]);
+      rhos[iev] = estimator.rho();
+      estimator.sigma();
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  return timer.elapsed()/n_runs;
+}
+
+//----------------------------------------------------------------------
+// mean and rms of rho - rho_true
+void bias(const vector<double> & rhos, const vector<double> & rhos_true, double & mean, double & rms){
+  double sum = 0.0, sum2 = 0.0;
+  for (unsigned int iev = 0; iev < rhos.size(); iev++){
+    double d = rhos[iev] - rhos_true[iev];
+    sum  += d;
+    sum2 += d*d;
+  }
+  mean = sum/rhos.size();
+  rms  = sqrt(max(0.0, sum2/rhos.size() - mean*mean));
+}
+
+//----------------------------------------------------------------------
+bool benchmark(const string & label, const vector<fcc::Event> & input_events,
+               double band, double min_time){
+  vector<vector<PseudoJet> > events(input_events.size());
+  vector<double> rhos_true(input_events.size(), 0.0);
+  unsigned long n_particles = 0;
+  for (unsigned int iev = 0; iev < input_events.size(); iev++){
+    const fcc::Event & event = input_events[iev];
+    for (unsigned int i = 0; i < event.size(); i++){
+      PseudoJet particle = event.pseudojet(i);
+      if (abs(particle.rap()) > particle_maxrap) continue;
+      events[iev].push_back(particle);
+      if (event.subevent(i) != 0) rhos_true[iev] += particle.perp();
+    }
+    rhos_true[iev] /= 2*particle_maxrap*2*M_PI;
+    n_particles += events[iev].size();
+  }
+
+  JetMedianBackgroundEstimator jet_median(SelectorAbsRapMax(4.5) * (!SelectorNHardest(2)),
+                                          JetDefinition(kt_algorithm, 0.4),
+                                          AreaDefinition(active_area_explicit_ghosts, GhostedAreaSpec(6.0)));
+  GridMedianBackgroundEstimator grid_median(particle_maxrap, 0.55);
+  fcc::GridRhoEstimator grid_rho(particle_maxrap, 0.55);
+  grid_rho.set_rapidity_band(band);
+
+  vector<double> rhos_jet, rhos_grid, rhos_fcc;
+  double t_jet  = time_rho(jet_median,  events, rhos_jet,  min_time);
+  double t_grid = time_rho(grid_median, events, rhos_grid, min_time);
+  double t_fcc  = time_rho(grid_rho,    events, rhos_fcc,  min_time);
+
+  // the two grids must agree on the global rho
+  double max_diff = 0.0;
+  for (unsigned int iev = 0; iev < events.size(); iev++)
+    max_diff = max(max_diff, std::abs(rhos_fcc[iev] - rhos_grid[iev]));
+
+  double mean_jet, rms_jet, mean_grid, rms_grid;
+  bias(rhos_jet,  rhos_true, mean_jet,  rms_jet);
+  bias(rhos_grid, rhos_true, mean_grid, rms_grid);
+
+  // with a profile, the bias of rho(y) in every row against the true
+  // density over the same rows as the estimator
+  double mean_row = 0.0, rms_row = 0.0;
+  if (band > 0){
+    int n_rap = grid_rho.n_rap();
+    double drap = 2*particle_maxrap/n_rap;
+    int half_rows = int(0.5*band/drap + 0.5);
+    vector<double> rhos_row, rhos_row_true, pt_row(n_rap);
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      const fcc::Event & event = input_events[iev];
+      fill(pt_row.begin(), pt_row.end(), 0.0);
+      for (unsigned int i = 0; i < event.size(); i++){
+        if (event.subevent(i) == 0) continue;
+        PseudoJet particle = event.pseudojet(i);
+        int r = int((particle.rap() + particle_maxrap)/drap);
+        if ((r >= 0) && (r < n_rap)) pt_row[r] += particle.perp();
+      }
+      grid_rho.set_particles(events[iev]);
+      for (int r = 0; r < n_rap; r++){
+        int first = max(0, r - half_rows), last = min(n_rap-1, r + half_rows);
+        double pt = 0.0;
+        for (int rr = first; rr <= last; rr++) pt += pt_row[rr];
+        rhos_row.push_back(grid_rho.rho_row(r));
+        rhos_row_true.push_back(pt/((last-first+1)*drap*2*M_PI));
+      }
+    }
+    bias(rhos_row, rhos_row_true, mean_row, rms_row);
+  }
+
+  double mean_true = 0.0;
+  for (unsigned int iev = 0; iev < rhos_true.size(); iev++) mean_true += rhos_true[iev]/rhos_true.size();
+  printf("%-40s %8lu %10.3f %10.4f %10.4f %10.4f %8.1f %8.1f %8.3f %8.3f %8.3f %8.3f %10.2e",
+         label.c_str(), n_particles/events.size(), mean_true,
+         1000*t_jet, 1000*t_grid, 1000*t_fcc, t_jet/t_fcc, t_grid/t_fcc,
+         mean_jet, rms_jet, mean_grid, rms_grid, max_diff);
+  if (band > 0) printf(" %8.3f %8.3f", mean_row, rms_row);
+  printf("\n");
+  fflush(stdout);
+  return max_diff == 0.0;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  fcc::BenchmarkInputs inputs;
+  double band = 0.0;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    if (inputs.parse_option(argc, argv, iarg)) continue;
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if ((arg == "--band") && has_value) band = atof(argv[++iarg]);
+    else args.push_back(arg);
+  }
+  if (args.empty() || (band < 0)){
+    cerr << "usage: " << argv[0] << " [--band W] " << fcc::BenchmarkInputs::usage() << endl
+         << "       file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+
+  fcc::GridRhoEstimator description(particle_maxrap, 0.55);
+  description.set_rapidity_band(band);
+  cout << "fcc: " << description.description() << endl << endl;
+  printf("%-40s %8s %10s %10s %10s %10s %8s %8s %8s %8s %8s %8s %10s",
+         "input", "n", "<rho_true>", "jet [ms]", "grid [ms]", "fcc [ms]", "jet/fcc", "grid/fcc",
+         "jet bias", "jet rms", "grid bias", "grid rms", "max |drho|");
+  if (band > 0) printf(" %8s %8s", "y bias", "y rms");
+  printf("\n");
+
+  bool all_same = inputs.run(args, [&](const string & label, const vector<fcc::Event> & events){
+    return benchmark(label, events, band, inputs.min_time());
+  });
+
+  return all_same ? 0 : 1;
+}
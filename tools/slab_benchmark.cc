@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------
+/// \file
+/// slab_benchmark: check that fcc::RapiditySlabPlugin gives the jets
+/// of the serial ClusterSequence, and time both as the pileup and the
+/// number of slabs grow
+///
+/// run it with    : ./slab_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --algorithm A       kt, cam or antikt (default antikt)
+///   --R R               jet radius (default 0.4)
+///   --slabs L           comma-separated list of slab counts
+///                       (default 2,4,8)
+///   --threads N         threads of the plugin (default: one per slab)
+///   --minbias FILE      pileup file used to build events at the mu
+///                       values below (overlaid on the events of the
+///                       first file); may be repeated
+///   --mu L              comma-separated list of mu (default 200,1000)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// For every input and slab count, the table gives the time per event
+/// of the serial clustering and of the plugin, the speed-up, the
+/// fraction of the particles that ended in the boundary groups, and
+/// the number of events clustered serially by the plugin (small
+/// events, or events that failed its check). The clustering of every
+/// event is compared with the serial one (fcc::same_clustering: d_ij
+/// history, momenta bit for bit, constituents, and exclusive jets for
+/// kt and C/A); the program exits with status 1 if any differ.
+//----------------------------------------------------------------------
+
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/JetComparison.hh"
+#include "fcc/RapiditySlabPlugin.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/ClusterSequence.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// time per clustering of the events with jet_def
+double time_clustering(const vector<vector<PseudoJet> > & events,
+                       const JetDefinition & jet_def, double min_time){
+  unsigned long n_clusterings = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      ClusterSequence clust_seq(events[iev], jet_def);
+      n_clusterings++;
+    }
+  } while (timer.elapsed() < min_time);
+  return timer.elapsed()/n_clusterings;
+}
+
+//----------------------------------------------------------------------
+bool benchmark(const string & label, const vector<fcc::Event> & input_events,
+               JetAlgorithm algorithm, double R, const vector<unsigned int> & slabs,
+               unsigned int n_threads, double min_time){
+  vector<vector<PseudoJet> > events;
+  unsigned long n_particles = 0;
+  for (unsigned int iev = 0; iev < input_events.size(); iev++){
+    events.push_back(input_events[iev].pseudojets());
+    n_particles += events.back().size();
+  }
+  JetDefinition serial_def(algorithm, R);
+  vector<unique_ptr<ClusterSequence> > serial(events.size());
+  for (unsigned int iev = 0; iev < events.size(); iev++)
+    serial[iev].reset(new ClusterSequence(events[iev], serial_def));
+  double t_serial = time_clustering(events, serial_def, min_time);
+
+  bool all_same = true;
+  for (unsigned int islab = 0; islab < slabs.size(); islab++){
+    fcc::RapiditySlabPlugin plugin(algorithm, R, slabs[islab], n_threads);
+    JetDefinition slab_def(&plugin);
+    unsigned long n_boundary = 0, n_differ = 0;
+    unsigned int n_serial = 0;
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      ClusterSequence clust_seq(events[iev], slab_def);
+      n_boundary += plugin.last_stats().n_boundary;
+      if (plugin.last_stats().serial) n_serial++;
+      if (!fcc::same_clustering(*serial[iev], clust_seq, plugin.exclusive_sequence_meaningful())) n_differ++;
+    }
+    double t_slabs = time_clustering(events, slab_def, min_time);
+    printf("%-40s %8lu %6u %12.4f %12.4f %7.2f %9.3f %7u %10s\n", label.c_str(),
+           n_particles/events.size(), slabs[islab], 1000*t_serial, 1000*t_slabs, t_serial/t_slabs,
+           double(n_boundary)/n_particles, n_serial, n_differ == 0 ? "identical" : "DIFFERENT");
+    fflush(stdout);
+    all_same &= (n_differ == 0);
+  }
+  return all_same;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  fcc::BenchmarkInputs inputs;
+  double R = 0.4;
+  unsigned int n_threads = 0;
+  string algorithm_name = "antikt";
+  vector<unsigned int> slabs;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    if (inputs.parse_option(argc, argv, iarg)) continue;
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--R")         && has_value) R         = atof(argv[++iarg]);
+    else if ((arg == "--threads")   && has_value) n_threads = atoi(argv[++iarg]);
+    else if ((arg == "--algorithm") && has_value) algorithm_name = argv[++iarg];
+    else if ((arg == "--slabs") && has_value){
+      istringstream iss(argv[++iarg]);
+      string item;
+      while (getline(iss, item, ',')) slabs.push_back(atoi(item.c_str()));
+    }
+    else args.push_back(arg);
+  }
+  JetAlgorithm algorithm = antikt_algorithm;
+  if      (algorithm_name == "kt")  algorithm = kt_algorithm;
+  else if (algorithm_name == "cam") algorithm = cambridge_algorithm;
+  else if (algorithm_name != "antikt") args.clear();
+  if (args.empty()){
+    cerr << "usage: " << argv[0] << " [--algorithm kt|cam|antikt] [--R R] [--slabs s1,s2,...] [--threads N]" << endl
+         << "       " << fcc::BenchmarkInputs::usage() << " file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+  if (slabs.empty()){
+    slabs.push_back(2);
+    slabs.push_back(4);
+    slabs.push_back(8);
+  }
+
+  cout << fcc::RapiditySlabPlugin(algorithm, R, slabs.back(), n_threads).description() << endl << endl;
+  printf("%-40s %8s %6s %12s %12s %7s %9s %7s %10s\n", "input", "n", "slabs", "serial [ms]",
+         "slabs [ms]", "gain", "boundary", "serial", "jets");
+
+  bool all_same = inputs.run(args, [&](const string & label, const vector<fcc::Event> & events){
+    return benchmark(label, events, algorithm, R, slabs, n_threads, inputs.min_time());
+  });
+
+  return all_same ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------
+/// \file
+/// soa_benchmark: check that fcc::SoATiledPlugin gives the same jets
+/// as ClusterSequence, and time both at pileup multiplicities
+///
+/// run it with    : ./soa_benchmark [options] [--minbias pileup.dat] file1.dat [file2.dat ...]
+///
+/// options:
+///   --R R               jet radius (default 0.4)
+///   --kernel K          automatic, scalar, avx2 or avx512 (default
+///                       automatic)
+///   --minbias FILE      pileup file used to build the timed events;
+///                       without it only the comparison is done
+///   --mu L              comma-separated list of pileup multiplicities
+///                       (default 0,50,200,500,1000)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///
+/// Every event of every file is clustered with kt, C/A and anti-kt
+/// both natively and through the plugin, and the inclusive jets are
+/// compared bit for bit, constituents included (fcc::same_jets). The timed events are the events of the first file with
+/// mu phi-rotated minimum-bias sub-events overlaid (fcc::PileupMixer).
+/// The program exits with status 1 if any jet differs.
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/JetComparison.hh"
+#include "fcc/PileupMixer.hh"
+#include "fcc/SoATiledPlugin.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/ClusterSequence.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// time per clustering of the events with jet_def
+double time_clustering(const vector<vector<PseudoJet> > & events,
+                       const JetDefinition & jet_def, double min_time){
+  unsigned long n_clusterings = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      ClusterSequence clust_seq(events[iev], jet_def);
+      n_clusterings++;
+    }
+  } while (timer.elapsed() < min_time);
+  return timer.elapsed()/n_clusterings;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  double R = 0.4, min_time = 0.2;
+  fcc::SoATiledPlugin::Kernel kernel = fcc::SoATiledPlugin::automatic;
+  bool bad_option = false;
+  vector<double> mus;
+  vector<string> minbias_files, args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--R")        && has_value) R        = atof(argv[++iarg]);
+    else if ((arg == "--min-time") && has_value) min_time = atof(argv[++iarg]);
+    else if ((arg == "--minbias")  && has_value) minbias_files.push_back(argv[++iarg]);
+    else if ((arg == "--kernel")   && has_value){
+      string name = argv[++iarg];
+      if      (name == "scalar") kernel = fcc::SoATiledPlugin::scalar;
+      else if (name == "avx2")   kernel = fcc::SoATiledPlugin::avx2;
+      else if (name == "avx512") kernel = fcc::SoATiledPlugin::avx512;
+      else if (name != "automatic") bad_option = true;
+    }
+    else if ((arg == "--mu") && has_value){
+      istringstream iss(argv[++iarg]);
+      string item;
+      while (getline(iss, item, ',')) mus.push_back(atof(item.c_str()));
+    }
+    else args.push_back(arg);
+  }
+  if (args.empty() || bad_option){
+    cerr << "usage: " << argv[0] << " [--R R] [--kernel automatic|scalar|avx2|avx512] [--minbias pileup.dat] [--mu m1,m2,...]" << endl
+         << "       [--min-time T] file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+  if (mus.empty()){
+    const double defaults[] = {0, 50, 200, 500, 1000};
+    mus.assign(defaults, defaults + sizeof(defaults)/sizeof(defaults[0]));
+  }
+
+  ClusterSequence::print_banner();
+
+  const JetAlgorithm algorithms[] = {kt_algorithm, cambridge_algorithm, antikt_algorithm};
+  const char * algorithm_names[] = {"kt", "C/A", "anti-kt"};
+
+  // comparison on every event of every file
+  //----------------------------------------------------------
+  bool all_same = true;
+  fcc::Event event;
+  for (unsigned int ifile = 0; ifile < args.size(); ifile++){
+    fcc::EventReader reader(args[ifile]);
+    unsigned int n_events = 0, n_differ = 0;
+    while (reader.next_event(event)){
+      vector<PseudoJet> particles = event.pseudojets();
+      for (unsigned int ialg = 0; ialg < 3; ialg++){
+        fcc::SoATiledPlugin plugin(algorithms[ialg], R, kernel);
+        ClusterSequence native(particles, JetDefinition(algorithms[ialg], R));
+        ClusterSequence soa(particles, JetDefinition(&plugin));
+        if (!fcc::same_jets(sorted_by_pt(native.inclusive_jets()), sorted_by_pt(soa.inclusive_jets()))){
+          cout << args[ifile] << ": event " << n_events << ": " << algorithm_names[ialg]
+               << " jets differ" << endl;
+          n_differ++;
+        }
+      }
+      n_events++;
+    }
+    printf("%-50s %4u events, %s\n", args[ifile].c_str(), n_events,
+           n_differ == 0 ? "identical jets" : "DIFFERENT jets");
+    if (n_differ > 0) all_same = false;
+  }
+
+  // timings at pileup multiplicities
+  //----------------------------------------------------------
+  if (!minbias_files.empty()){
+    fcc::PileupMixer mixer;
+    for (unsigned int ifile = 0; ifile < minbias_files.size(); ifile++){
+      fcc::EventReader reader(minbias_files[ifile]);
+      while (reader.next_event(event)) mixer.add_to_pool(event);
+    }
+    vector<fcc::Event> hard_events;
+    fcc::EventReader hard_reader(args[0]);
+    while (hard_reader.next_event(event)) hard_events.push_back(event);
+
+    fcc::SoATiledPlugin info_plugin(antikt_algorithm, R, kernel);
+    cout << endl << "Timings [ms per event], plugin with "
+         << fcc::SoATiledPlugin::kernel_name(info_plugin.kernel()) << " kernels" << endl;
+    printf("%6s %8s", "mu", "n");
+    for (unsigned int ialg = 0; ialg < 3; ialg++)
+      printf(" %10s %10s %7s", algorithm_names[ialg], "SoA", "gain");
+    printf("\n");
+
+    fcc::Event mixed;
+    for (unsigned int imu = 0; imu < mus.size(); imu++){
+      vector<vector<PseudoJet> > events;
+      unsigned long n_particles = 0;
+      for (unsigned int iev = 0; iev < hard_events.size(); iev++){
+        mixer.mix(hard_events[iev], 0, (unsigned int) mus[imu], mixed);
+        events.push_back(mixed.pseudojets());
+        n_particles += mixed.size();
+      }
+      printf("%6.0f %8lu", mus[imu], n_particles/events.size());
+      for (unsigned int ialg = 0; ialg < 3; ialg++){
+        fcc::SoATiledPlugin plugin(algorithms[ialg], R, kernel);
+        double t_native = time_clustering(events, JetDefinition(algorithms[ialg], R), min_time);
+        double t_soa    = time_clustering(events, JetDefinition(&plugin), min_time);
+        printf(" %10.4f %10.4f %7.2f", 1000*t_native, 1000*t_soa, t_native/t_soa);
+      }
+      printf("\n");
+      fflush(stdout);
+    }
+  }
+
+  return all_same ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+//----------------------------------------------------------------------
+/// \file
+/// softkiller_benchmark: what a SoftKiller pre-filter (fcc::SoftKiller)
+/// saves in the subtraction07 analysis, and how it changes the jets,
+/// as the pileup grows
+///
+/// run it with    : ./softkiller_benchmark [options] file1.dat [file2.dat ...]
+///
+/// options:
+///   --minbias FILE      pileup file used to build events at the mu
+///                       values below (overlaid on the events of the
+///                       first file); may be repeated
+///   --mu L              comma-separated list of mu (default 200,1000)
+///   --jet-ptmin PT      hard-event jets compared (default 20 GeV)
+///   --min-time T        time spent on each measurement (default 1 s)
+///
+/// For every input, fcc::SubtractionAnalysis (anti-kt R=0.5 with
+/// active areas, jet-median rho) is run without and with the
+/// pre-filter. The table gives the particles before and after the
+/// filter, the mean threshold, the time of the filter itself and of
+/// the whole analysis in both cases. For the jets, every hard-event
+/// jet above jet-ptmin is matched to the closest subtracted jet of
+/// the full event (within DeltaR = 0.3), and the matched fraction and
+/// the mean and rms of pt_sub - pt_hard are given in both cases.
+//----------------------------------------------------------------------
+
+#include "fcc/BenchmarkInputs.hh"
+#include "fcc/ExerciseAnalyses.hh"
+#include "fcc/SoftKiller.hh"
+#include "fcc/Timer.hh"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// the comparison of the subtracted jets with the hard ones
+struct JetResponse {
+  JetResponse() : n_hard(0), n_matched(0), sum(0), sum2(0) {}
+  unsigned long n_hard, n_matched;
+  double sum, sum2;
+
+  void add(const fcc::SubtractionAnalysis & analysis, double jet_ptmin){
+    const vector<PseudoJet> & hard = analysis.hard_jets();
+    const vector<PseudoJet> & subtracted = analysis.subtracted_jets();
+    for (unsigned int i = 0; i < hard.size(); i++){
+      if (hard[i].perp() < jet_ptmin) continue;
+      n_hard++;
+      int best = -1;
+      double best_dr2 = 0.3*0.3;
+      for (unsigned int j = 0; j < subtracted.size(); j++){
+        double dr2 = hard[i].squared_distance(subtracted[j]);
+        if (dr2 < best_dr2){
+          best_dr2 = dr2;
+          best = j;
+        }
+      }
+      if (best < 0) continue;
+      double d = subtracted[best].perp() - hard[i].perp();
+      n_matched++;
+      sum  += d;
+      sum2 += d*d;
+    }
+  }
+  double fraction() const { return n_hard ? double(n_matched)/n_hard : 0.0; }
+  double mean() const { return n_matched ? sum/n_matched : 0.0; }
+  double rms()  const { return n_matched ? sqrt(max(0.0, sum2/n_matched - mean()*mean())) : 0.0; }
+};
+
+//----------------------------------------------------------------------
+// time per event of the analysis, and the jet response of one pass
+double time_analysis(fcc::SubtractionAnalysis & analysis, const vector<fcc::Event> & events,
+                     double jet_ptmin, double min_time, JetResponse & response){
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    analysis.process(events[iev], iev);
+    response.add(analysis, jet_ptmin);
+  }
+  unsigned long n_runs = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      analysis.process(events[iev], iev);
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  return timer.elapsed()/n_runs;
+}
+
+//----------------------------------------------------------------------
+void benchmark(const string & label, const vector<fcc::Event> & events,
+               double jet_ptmin, double min_time){
+  // the filter alone, on the particles the analysis keeps
+  fcc::SubtractionAnalysis reference;
+  fcc::SoftKiller soft_killer;
+  vector<vector<PseudoJet> > full_events(events.size());
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    reference.process(events[iev], iev);
+    full_events[iev] = reference.full_event();
+  }
+  unsigned long n_in = 0, n_out = 0;
+  double threshold = 0.0;
+  vector<PseudoJet> reduced;
+  for (unsigned int iev = 0; iev < events.size(); iev++){
+    soft_killer.apply(full_events[iev], reduced);
+    n_in  += soft_killer.n_in();
+    n_out += soft_killer.n_out();
+    threshold += soft_killer.pt_threshold()/events.size();
+  }
+  unsigned long n_runs = 0;
+  fcc::Timer timer;
+  do {
+    for (unsigned int iev = 0; iev < events.size(); iev++){
+      soft_killer.apply(full_events[iev], reduced);
+      n_runs++;
+    }
+  } while (timer.elapsed() < min_time);
+  double t_filter = timer.elapsed()/n_runs;
+
+  fcc::SubtractionAnalysis filtered;
+  filtered.set_soft_killer(soft_killer);
+  JetResponse response, response_filtered;
+  double t_plain    = time_analysis(reference, events, jet_ptmin, min_time, response);
+  double t_filtered = time_analysis(filtered,  events, jet_ptmin, min_time, response_filtered);
+
+  printf("%-40s %8lu %8lu %8.3f %10.4f %10.2f %10.2f %7.2f %7.3f %8.2f %7.2f %7.3f %8.2f %7.2f\n",
+         label.c_str(), n_in/events.size(), n_out/events.size(), threshold,
+         1000*t_filter, 1000*t_plain, 1000*t_filtered, t_plain/t_filtered,
+         response.fraction(), response.mean(), response.rms(),
+         response_filtered.fraction(), response_filtered.mean(), response_filtered.rms());
+  fflush(stdout);
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  fcc::BenchmarkInputs inputs(1.0);
+  double jet_ptmin = 20.0;
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    if (inputs.parse_option(argc, argv, iarg)) continue;
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if ((arg == "--jet-ptmin") && has_value) jet_ptmin = atof(argv[++iarg]);
+    else args.push_back(arg);
+  }
+  if (args.empty()){
+    cerr << "usage: " << argv[0] << " [--jet-ptmin PT] " << fcc::BenchmarkInputs::usage() << endl
+         << "       file1.dat [file2.dat ...]" << endl;
+    return 1;
+  }
+
+  fcc::SubtractionAnalysis description;
+  description.set_soft_killer(fcc::SoftKiller());
+  cout << description.description() << endl;
+  cout << "Jets compared: hard-event jets above " << jet_ptmin << " GeV" << endl << endl;
+  printf("%-40s %8s %8s %8s %10s %10s %10s %7s %7s %8s %7s %7s %8s %7s\n",
+         "input", "n", "n_SK", "pt_cut", "SK [ms]", "plain [ms]", "SK+ [ms]", "gain",
+         "match", "dpt", "rms", "matchSK", "dpt SK", "rms SK");
+
+  inputs.run(args, [&](const string & label, const vector<fcc::Event> & events){
+    benchmark(label, events, jet_ptmin, inputs.min_time());
+    return true;
+  });
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------
+/// \file
+/// strategy_benchmark: time every clustering strategy against the
+/// event multiplicity for the kt, Cambridge/Aachen and anti-kt
+/// algorithms, and write the resulting strategy calibration
+///
+/// run it with    : ./strategy_benchmark [options] --minbias pileup.dat hard.dat
+///
+/// options:
+///   --R R               jet radius (default 0.6, as in jetDef02)
+///   --multiplicities L  comma-separated list of multiplicities
+///                       (default 100,200,500,1000,2000,5000,10000,20000,50000)
+///   --min-time T        time spent on each measurement (default 0.2 s)
+///   --max-time T        a strategy slower than this per event is not
+///                       tried at higher multiplicities (default 2 s)
+///   --output FILE       where to write the calibration (default
+///                       strategy-calibration.txt)
+///
+/// The events of a given multiplicity are built from real events: a
+/// hard event overlaid with phi-rotated minimum-bias sub-events
+/// (fcc::PileupMixer), truncated to the requested number of particles.
+/// The calibration can then be used by jetDef02 (and by any code using
+/// fcc::StrategyCalibration) to pick the strategy event by event.
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/PileupMixer.hh"
+#include "fcc/StrategyCalibration.hh"
+#include "fcc/Timer.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/Error.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// a few events of exactly n particles, resampled from the inputs
+vector<vector<PseudoJet> > resampled_events(fcc::PileupMixer & mixer,
+                                            const vector<fcc::Event> & hard_events,
+                                            unsigned int n, unsigned int n_events){
+  vector<vector<PseudoJet> > events(n_events);
+  fcc::Event mixed;
+  for (unsigned int iev = 0; iev < n_events; iev++){
+    const fcc::Event & hard = hard_events[iev % hard_events.size()];
+    unsigned int n_pileup = 0;
+    do {
+      mixer.mix(hard, 0, n_pileup, mixed);
+      n_pileup = (n_pileup == 0) ? 1 : 2*n_pileup;
+    } while (mixed.size() < n);
+    events[iev] = mixed.pseudojets();
+    events[iev].resize(n);
+  }
+  return events;
+}
+
+//----------------------------------------------------------------------
+// time per clustering of the events with jet_def (negative if the
+// strategy is not available in this FastJet build)
+double time_clustering(const vector<vector<PseudoJet> > & events,
+                       const JetDefinition & jet_def, double min_time){
+  unsigned long n_clusterings = 0;
+  fcc::Timer timer;
+  try {
+    do {
+      for (unsigned int iev = 0; iev < events.size(); iev++){
+        ClusterSequence clust_seq(events[iev], jet_def);
+        n_clusterings++;
+      }
+    } while (timer.elapsed() < min_time);
+  } catch (const Error &) {
+    return -1.0;
+  }
+  return timer.elapsed()/n_clusterings;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  double R = 0.6, min_time = 0.2, max_time = 2.0;
+  string output = "strategy-calibration.txt";
+  vector<unsigned int> multiplicities;
+  vector<string> minbias_files, args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--R")        && has_value) R        = atof(argv[++iarg]);
+    else if ((arg == "--min-time") && has_value) min_time = atof(argv[++iarg]);
+    else if ((arg == "--max-time") && has_value) max_time = atof(argv[++iarg]);
+    else if ((arg == "--output")   && has_value) output   = argv[++iarg];
+    else if ((arg == "--minbias")  && has_value) minbias_files.push_back(argv[++iarg]);
+    else if ((arg == "--multiplicities") && has_value){
+      istringstream iss(argv[++iarg]);
+      string item;
+      while (getline(iss, item, ',')) multiplicities.push_back(atoi(item.c_str()));
+    }
+    else args.push_back(arg);
+  }
+  if ((args.size() != 1) || minbias_files.empty()){
+    cerr << "usage: " << argv[0] << " [--R R] [--multiplicities n1,n2,...] [--min-time T] [--max-time T]" << endl
+         << "       [--output FILE] --minbias pileup.dat [--minbias ...] hard.dat" << endl;
+    return 1;
+  }
+  if (multiplicities.empty()){
+    const unsigned int defaults[] = {100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+    multiplicities.assign(defaults, defaults + sizeof(defaults)/sizeof(defaults[0]));
+  }
+
+  // inputs for the resampling
+  fcc::PileupMixer mixer;
+  fcc::Event event;
+  for (unsigned int ifile = 0; ifile < minbias_files.size(); ifile++){
+    fcc::EventReader reader(minbias_files[ifile]);
+    while (reader.next_event(event)) mixer.add_to_pool(event);
+  }
+  vector<fcc::Event> hard_events;
+  fcc::EventReader hard_reader(args[0]);
+  while (hard_reader.next_event(event)) hard_events.push_back(event);
+  if ((mixer.pool_size() == 0) || hard_events.empty()){
+    cerr << "Error: need both minimum-bias sub-events and hard events" << endl;
+    return 1;
+  }
+
+  // print the banner now rather than in the middle of the tables
+  ClusterSequence::print_banner();
+
+  const JetAlgorithm algorithms[] = {kt_algorithm, cambridge_algorithm, antikt_algorithm};
+  fcc::StrategyCalibration calibration;
+  const unsigned int n_events_per_point = 3;
+
+  for (unsigned int ialg = 0; ialg < 3; ialg++){
+    JetAlgorithm algorithm = algorithms[ialg];
+    vector<Strategy> strategies = fcc::candidate_strategies(algorithm);
+    vector<bool> still_tried(strategies.size(), true);
+    vector<vector<double> > timings;
+
+    cout << endl << "Timings [ms per event] for "
+         << JetDefinition(algorithm, R).description() << endl;
+    printf("%8s", "n");
+    for (unsigned int j = 0; j < strategies.size(); j++)
+      printf(" %14s", fcc::strategy_name(strategies[j]).c_str());
+    printf(" %14s %14s %8s\n", "Best", "fastest", "gain");
+
+    for (unsigned int i = 0; i < multiplicities.size(); i++){
+      unsigned int n = multiplicities[i];
+      vector<vector<PseudoJet> > events = resampled_events(mixer, hard_events, n, n_events_per_point);
+
+      timings.push_back(vector<double>(strategies.size(), -1.0));
+      int best = -1;
+      printf("%8u", n);
+      for (unsigned int j = 0; j < strategies.size(); j++){
+        if (still_tried[j]){
+          JetDefinition jet_def(algorithm, R, E_scheme, strategies[j]);
+          timings[i][j] = time_clustering(events, jet_def, min_time);
+          if ((timings[i][j] < 0) || (timings[i][j] > max_time)) still_tried[j] = false;
+        }
+        if (timings[i][j] < 0){
+          printf(" %14s", "-");
+        } else {
+          printf(" %14.4f", 1000*timings[i][j]);
+          if ((best < 0) || (timings[i][j] < timings[i][best])) best = j;
+        }
+      }
+
+      // compare to FastJet's own choice
+      double best_time = time_clustering(events, JetDefinition(algorithm, R), min_time);
+      printf(" %14.4f %14s %8.2f\n", 1000*best_time,
+             (best < 0) ? "-" : fcc::strategy_name(strategies[best]).c_str(),
+             (best < 0) ? 0.0 : best_time/timings[i][best]);
+      fflush(stdout);
+    }
+
+    calibration.set_from_timings(algorithm, multiplicities, strategies, timings);
+  }
+
+  cout << endl << "Calibration:" << endl;
+  calibration.write(cout);
+  ofstream ostr(output.c_str());
+  calibration.write(ostr);
+  cout << "written to " << output << endl;
+
+  return 0;
+}
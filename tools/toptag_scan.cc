@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------
+/// \file
+/// toptag_scan: run the JH top tagger over a grid of parameters on
+/// every large-R jet of every event, with the events spread over a
+/// thread pool
+///
+/// run it with    : ./toptag_scan [options] input
+///
+/// options:
+///   --R R               C/A radius (default 0.8)
+///   --ptmin PT          jets above PT are tagged (default 500)
+///   --delta-p L         comma-separated delta_p values (default 0.05,0.1,0.15)
+///   --delta-r L         comma-separated delta_r values (default 0.1,0.15,0.19,0.25)
+///   --top-mass L        comma-separated min:max top mass windows (default 150:200)
+///   --W-mass L          comma-separated min:max W mass windows (default 65:95)
+///   --threads N         number of worker threads (default: all hardware threads)
+///   --candidates FILE   write one line per jet and (delta_p, delta_r)
+///                       with a top candidate
+///   --check             also run fastjet::JHTopTagger for every jet and
+///                       parameter set, and count the differences
+///
+/// Each jet is declustered once (fcc::TopTagScan) and the whole grid
+/// is evaluated on that. The summary gives, for every point of the
+/// grid, the fraction of the jets that are tagged. The program exits
+/// with status 1 if --check finds a difference.
+///
+/// NB: FastJet must have been configured with --enable-thread-safety
+/// (available from FastJet 3.4) for more than one thread.
+//----------------------------------------------------------------------
+
+#include "fcc/EventReader.hh"
+#include "fcc/ThreadPool.hh"
+#include "fcc/Timer.hh"
+#include "fcc/TopTagScan.hh"
+#include "fastjet/Selector.hh"
+#include "fastjet/tools/JHTopTagger.hh"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+using namespace fastjet;
+
+//----------------------------------------------------------------------
+// what one worker accumulates
+struct WorkerResult {
+  WorkerResult() : n_jets(0), n_differences(0) {}
+  unsigned long n_jets, n_differences;
+  vector<unsigned long> n_tagged;  ///< per point and pair of windows
+};
+
+//----------------------------------------------------------------------
+// the number of (point, window) decisions, or mass differences, that
+// disagree with fastjet::JHTopTagger for this jet
+unsigned long check_jet(const fcc::TopTagScan & scan, unsigned int ijet, const PseudoJet & jet){
+  const fcc::TopTagScan::Grid & grid = scan.grid();
+  unsigned long n_differences = 0;
+  for (unsigned int idp = 0; idp < grid.delta_p.size(); idp++){
+    for (unsigned int idr = 0; idr < grid.delta_r.size(); idr++){
+      unsigned int ipoint = scan.point(idp, idr);
+      for (unsigned int itop = 0; itop < grid.top_mass.size(); itop++){
+        for (unsigned int iW = 0; iW < grid.W_mass.size(); iW++){
+          JHTopTagger tagger(grid.delta_p[idp], grid.delta_r[idr], grid.cos_theta_W_max, grid.mW);
+          tagger.set_top_selector(SelectorMassRange(grid.top_mass[itop].first, grid.top_mass[itop].second));
+          tagger.set_W_selector  (SelectorMassRange(grid.W_mass[iW].first, grid.W_mass[iW].second));
+          PseudoJet tagged = tagger(jet);
+          bool is_tagged = (tagged != 0);
+          if (is_tagged != scan.tagged(ijet, ipoint, itop, iW)) n_differences++;
+          else if (is_tagged && (tagged.m() != scan.candidate(ijet, ipoint).top_m)) n_differences++;
+        }
+      }
+    }
+  }
+  return n_differences;
+}
+
+//----------------------------------------------------------------------
+// cluster one event, tag its jets and return the candidate lines
+string run_event(fcc::TopTagScan & scan, WorkerResult & result, const fcc::Event & event,
+                 unsigned long iev, const JetDefinition & jet_def, double ptmin, bool check){
+  vector<PseudoJet> particles = event.pseudojets();
+  ClusterSequence cs(particles, jet_def);
+  vector<PseudoJet> jets = sorted_by_pt(cs.inclusive_jets(ptmin));
+  scan.process(jets);
+
+  const fcc::TopTagScan::Grid & grid = scan.grid();
+  unsigned int n_windows = grid.top_mass.size()*grid.W_mass.size();
+  result.n_tagged.resize(scan.n_points()*n_windows, 0);
+  result.n_jets += jets.size();
+
+  ostringstream oss;
+  for (unsigned int ijet = 0; ijet < jets.size(); ijet++){
+    for (unsigned int ipoint = 0; ipoint < scan.n_points(); ipoint++){
+      for (unsigned int itop = 0; itop < grid.top_mass.size(); itop++){
+        for (unsigned int iW = 0; iW < grid.W_mass.size(); iW++){
+          if (scan.tagged(ijet, ipoint, itop, iW))
+            result.n_tagged[ipoint*n_windows + itop*grid.W_mass.size() + iW]++;
+        }
+      }
+      const fcc::TopTagScan::Candidate & candidate = scan.candidate(ijet, ipoint);
+      if (!candidate.found) continue;
+      char line[256];
+      snprintf(line, sizeof(line), "%8lu %4u %8.3f %8.3f %10.3f %10.3f %10.3f %10.3f %8.4f\n",
+               iev, ijet, grid.delta_p[ipoint/grid.delta_r.size()], grid.delta_r[ipoint%grid.delta_r.size()],
+               jets[ijet].perp(), candidate.top_pt, candidate.top_m, candidate.W_m, candidate.cos_theta_W);
+      oss << line;
+    }
+    if (check) result.n_differences += check_jet(scan, ijet, jets[ijet]);
+  }
+  return oss.str();
+}
+
+//----------------------------------------------------------------------
+// comma-separated values, and min:max windows
+vector<double> parse_values(const string & list){
+  vector<double> values;
+  istringstream iss(list);
+  string item;
+  while (getline(iss, item, ',')) values.push_back(atof(item.c_str()));
+  return values;
+}
+
+vector<pair<double,double> > parse_windows(const string & list){
+  vector<pair<double,double> > windows;
+  istringstream iss(list);
+  string item;
+  while (getline(iss, item, ',')){
+    size_t colon = item.find(':');
+    if (colon == string::npos) continue;
+    windows.push_back(make_pair(atof(item.substr(0, colon).c_str()), atof(item.substr(colon+1).c_str())));
+  }
+  return windows;
+}
+
+//----------------------------------------------------------------------
+int main(int argc, char ** argv){
+  double R = 0.8, ptmin = 500.0;
+  unsigned int n_threads = fcc::ThreadPool::hardware_threads();
+  bool check = false;
+  string candidates_file;
+  fcc::TopTagScan::Grid grid;
+  grid.delta_p = parse_values("0.05,0.1,0.15");
+  grid.delta_r = parse_values("0.1,0.15,0.19,0.25");
+  grid.top_mass = parse_windows("150:200");
+  grid.W_mass   = parse_windows("65:95");
+
+  vector<string> args;
+  for (int iarg = 1; iarg < argc; iarg++){
+    string arg = argv[iarg];
+    bool has_value = (iarg+1 < argc);
+    if      ((arg == "--R")          && has_value) R = atof(argv[++iarg]);
+    else if ((arg == "--ptmin")      && has_value) ptmin = atof(argv[++iarg]);
+    else if ((arg == "--delta-p")    && has_value) grid.delta_p  = parse_values(argv[++iarg]);
+    else if ((arg == "--delta-r")    && has_value) grid.delta_r  = parse_values(argv[++iarg]);
+    else if ((arg == "--top-mass")   && has_value) grid.top_mass = parse_windows(argv[++iarg]);
+    else if ((arg == "--W-mass")     && has_value) grid.W_mass   = parse_windows(argv[++iarg]);
+    else if ((arg == "--threads")    && has_value) n_threads = atoi(argv[++iarg]);
+    else if ((arg == "--candidates") && has_value) candidates_file = argv[++iarg];
+    else if (arg == "--check") check = true;
+    else args.push_back(arg);
+  }
+  if ((args.size() != 1) || (n_threads == 0) || grid.delta_p.empty() || grid.delta_r.empty() ||
+      grid.top_mass.empty() || grid.W_mass.empty()){
+    cerr << "usage: " << argv[0] << " [--R R] [--ptmin PT] [--delta-p L] [--delta-r L]" << endl
+         << "       [--top-mass min:max,...] [--W-mass min:max,...] [--threads N]" << endl
+         << "       [--candidates FILE] [--check] input" << endl;
+    return 1;
+  }
+
+  JetDefinition jet_def(cambridge_algorithm, R);
+  fcc::TopTagScan prototype(grid);
+  cout << "Jets: " << jet_def.description() << ", pt > " << ptmin << " GeV" << endl;
+  cout << "Ran: " << prototype.description() << endl;
+
+  ofstream candidates_out;
+  if (!candidates_file.empty()){
+    candidates_out.open(candidates_file.c_str());
+    candidates_out << "#   event  jet  delta_p  delta_r     jet_pt     top_pt      top_m        W_m  cos_thW" << endl;
+  }
+  ostringstream discarded;
+  fcc::OrderedOutput output(candidates_file.empty() ? static_cast<ostream&>(discarded) : candidates_out);
+
+  // one scan (and hence one cached tree) and one set of counts per worker
+  fcc::ThreadPool pool(n_threads);
+  vector<fcc::TopTagScan> scans(pool.n_threads(), prototype);
+  vector<WorkerResult> results(pool.n_threads());
+  unsigned long max_in_flight = 4*pool.n_threads();
+
+  fcc::EventReader reader(args[0]);
+  fcc::Timer timer;
+  unsigned long iev = 0;
+  while (true){
+    output.wait_for_room(iev, max_in_flight);
+    shared_ptr<fcc::Event> event(new fcc::Event());
+    if (!reader.next_event(*event)) break;
+    pool.submit([&scans, &results, &output, &jet_def, event, iev, ptmin, check](unsigned int iworker){
+        output.set(iev, run_event(scans[iworker], results[iworker], *event, iev, jet_def, ptmin, check));
+      });
+    iev++;
+  }
+  pool.wait();
+  double time = timer.elapsed();
+
+  // the tagged fractions over all the workers
+  unsigned int n_windows = grid.top_mass.size()*grid.W_mass.size();
+  WorkerResult total;
+  total.n_tagged.assign(prototype.n_points()*n_windows, 0);
+  for (unsigned int i = 0; i < results.size(); i++){
+    total.n_jets += results[i].n_jets;
+    total.n_differences += results[i].n_differences;
+    for (unsigned int j = 0; j < results[i].n_tagged.size(); j++) total.n_tagged[j] += results[i].n_tagged[j];
+  }
+
+  cout << "Tagged " << total.n_jets << " jets from " << iev << " events on " << pool.n_threads()
+       << " threads in " << time << " s (" << total.n_jets/time << " jets/s)" << endl << endl;
+  printf("%8s %8s %15s %15s %10s\n", "delta_p", "delta_r", "top window", "W window", "tagged");
+  for (unsigned int idp = 0; idp < grid.delta_p.size(); idp++){
+    for (unsigned int idr = 0; idr < grid.delta_r.size(); idr++){
+      for (unsigned int itop = 0; itop < grid.top_mass.size(); itop++){
+        for (unsigned int iW = 0; iW < grid.W_mass.size(); iW++){
+          unsigned long n = total.n_tagged[prototype.point(idp, idr)*n_windows + itop*grid.W_mass.size() + iW];
+          printf("%8.3f %8.3f %7.1f-%-7.1f %7.1f-%-7.1f %10.4f\n", grid.delta_p[idp], grid.delta_r[idr],
+                 grid.top_mass[itop].first, grid.top_mass[itop].second,
+                 grid.W_mass[iW].first, grid.W_mass[iW].second,
+                 total.n_jets ? double(n)/total.n_jets : 0.0);
+        }
+      }
+    }
+  }
+  if (check) cout << endl << "Differences with fastjet::JHTopTagger: " << total.n_differences << endl;
+
+  return (total.n_differences == 0) ? 0 : 1;
+}